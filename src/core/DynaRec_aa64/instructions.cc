@@ -680,7 +680,8 @@ template <int size, bool signExtend>
 void DynaRecCPU::recompileLoad(uint32_t code) {
     if (m_gprs[_Rs_].isConst()) {  // Store the address in first argument register
         const uint32_t addr = m_gprs[_Rs_].val + _Imm_;
-        const auto pointer = PCSX::g_emulator->m_mem->pointerRead(addr);
+        const auto memory = PCSX::g_emulator->m_mem.get();
+        const auto pointer = memory->isWatched(addr, false) ? nullptr : memory->pointerRead(addr);
 
         if (pointer != nullptr && (_Rt_) != 0) {
             allocateRegWithoutLoad(_Rt_);
@@ -1017,6 +1018,7 @@ void DynaRecCPU::recSB(uint32_t code) {
                 store<8>(m_gprs[_Rt_].allocatedReg, pointer);
             }
 
+            markDirty(pointer);
             return;
         }
 
@@ -1057,6 +1059,7 @@ void DynaRecCPU::recSH(uint32_t code) {
                 store<16>(m_gprs[_Rt_].allocatedReg, pointer);
             }
 
+            markDirty(pointer);
             return;
         }
 
@@ -1127,6 +1130,7 @@ void DynaRecCPU::recSW(uint32_t code) {
                 store<32>(m_gprs[_Rt_].allocatedReg, pointer);
             }
 
+            markDirty(pointer);
             return;
         }
 
@@ -289,6 +289,7 @@ DynarecCallback DynaRecCPU::recompile(DynarecCallback* callback, uint32_t pc, bo
         }
 
         uint32_t code = m_regs.code = *p;  // Actually read the instruction
+        markCodePage(m_pc);                // Writes to this page need to invalidate the block from now on
         m_pc += 4;                         // Increment recompiler PC
         count++;                           // Increment instruction count
 
@@ -293,6 +293,12 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         }
     }
 
+    // Stores to a constant address bypass the Memory handlers, so they have to flag the RAM page themselves.
+    void markDirty(const void* pointer) {
+        const auto flag = PCSX::g_emulator->m_mem->dirtyFlag(pointer);
+        if (flag) store<8>(1, flag);
+    }
+
     // Prepare for a call to a C++ function and then actually emit it
     template <typename T>
     void call(T& func) {
@@ -18,6 +18,8 @@
  ***************************************************************************/
 
 #pragma once
+#include <vector>
+
 #include "core/r3000a.h"
 
 #ifdef DYNAREC_X86_64
@@ -34,6 +36,15 @@ using namespace Xbyak::util;
 constexpr size_t codeCacheSize = 32 * 1024 * 1024;
 constexpr size_t allocSize = codeCacheSize + 0x1000;
 
+// The code cache is split into equally sized regions, so that running out of space only evicts part of it
+constexpr int codeRegionCount = 8;
+constexpr size_t codeRegionSize = codeCacheSize / codeRegionCount;
+// Space that has to be left in a region before compiling a block into it. Generously above the biggest block we emit
+constexpr size_t maxBlockCodeSize = 64 * 1024;
+// Blocks stop taking in instructions once they've emitted this much, leaving the rest for their last instruction,
+// its delay slot and the exit code
+constexpr size_t blockCodeBudget = maxBlockCodeSize / 2;
+
 // Allocate a bit more memory to be safe.
 // This has to be static so JIT code will be close enough to the executable to address stuff with rip-relative accesses
 alignas(4096) static uint8_t s_codeCache[allocSize];
@@ -51,6 +62,18 @@ struct Emitter final : public CodeGenerator {
         hasLZCNT = cpu.has(Xbyak::util::Cpu::tLZCNT);
     }
 
+    // Offsets of the 64-bit host pointers embedded in the emitted code by movPointer, in emission order.
+    // The translation cache needs them to relocate blocks it saved in a previous run.
+    std::vector<size_t> pointerFixups;
+
+    // Always emits a 10-byte movabs, so that the pointer can be patched later on regardless of its value
+    void movPointer(Xbyak::Reg64 dest, const void* pointer) {
+        db(0x48 | (dest.getIdx() >> 3));  // REX.W, plus REX.B for r8-r15
+        db(0xB8 | (dest.getIdx() & 7));   // mov r64, imm64
+        pointerFixups.push_back(getSize());
+        dq((uint64_t)pointer);
+    }
+
     template <typename T>
     void callFunc(T& func) {
         call(reinterpret_cast<void*>(&func));
@@ -188,7 +211,7 @@ struct Emitter final : public CodeGenerator {
         if (Xbyak::inner::IsInInt32(distance)) {
             jmp(func);
         } else {
-            mov(rax, (uint64_t)func);
+            movPointer(rax, func);
             jmp(rax);
         }
     }
@@ -199,7 +222,7 @@ struct Emitter final : public CodeGenerator {
         if (Xbyak::inner::IsInInt32(distance)) {
             call(func);
         } else {
-            mov(rax, (uint64_t)func);
+            movPointer(rax, func);
             call(rax);
         }
     }
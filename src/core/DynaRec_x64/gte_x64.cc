@@ -449,6 +449,422 @@ void DynaRecCPU::recAVSZ(uint32_t code) {
 void DynaRecCPU::recAVSZ3(uint32_t code) { recAVSZ<false>(code); }
 void DynaRecCPU::recAVSZ4(uint32_t code) { recAVSZ<true>(code); }
 
+// Scratch registers for the native GTE kernels. Neither of them can hold guest registers, so together with rax, rcx and
+// rdx the kernels never need to flush the register allocator
+static constexpr Reg64 gteTemp1 = isWindows() ? r8 : rdi;
+static constexpr Reg64 gteTemp2 = isWindows() ? r9 : rsi;
+
+// FLAG bits set by MAC1-MAC3 overflows, as {positive, negative}
+static constexpr uint32_t c_macFlags[3][2] = {{(1u << 31) | (1 << 30), (1u << 31) | (1 << 27)},
+                                              {(1u << 31) | (1 << 29), (1u << 31) | (1 << 26)},
+                                              {(1u << 31) | (1 << 28), (1u << 31) | (1 << 25)}};
+static constexpr uint32_t c_irFlags[3] = {(1u << 31) | (1 << 24), (1u << 31) | (1 << 23), 1 << 22};
+static constexpr uint32_t c_colourFlags[3] = {1 << 21, 1 << 20, 1 << 19};
+
+#define GTE_FLAG dword[contextPointer + COP2_CONTROL_OFFSET(31)]
+
+// Offset of element (row, col) of matrix mx (0 = rotation, 1 = light, 2 = light colour)
+uintptr_t DynaRecCPU::gteMatrixOffset(int mx, int row, int col) {
+    const int element = row * 3 + col;
+    return COP2_CONTROL_OFFSET((mx << 3) + (element >> 1)) + (element & 1) * 2;
+}
+
+// Offset of element i of vector v (0-2 = V0-V2, 3 = IR1-IR3)
+uintptr_t DynaRecCPU::gteVectorOffset(int v, int i) {
+    if (v == 3) return COP2_DATA_OFFSET(9 + i);
+    return COP2_DATA_OFFSET((v << 1) + (i >> 1)) + (i & 1) * 2;
+}
+
+// Check if the value in rax fits in 44 bits and set the MAC overflow flags if not.
+// If "wrap" is true, rax is also truncated to 44 bits, like the GTE's accumulator does between additions
+void DynaRecCPU::gteCheckMACOverflow(int index, bool wrap) {
+    Xbyak::Label inRange, negative, done;
+
+    gen.mov(rdx, rax);
+    gen.shl(rdx, 20);
+    gen.sar(rdx, 20);
+    gen.cmp(rdx, rax);
+    gen.je(inRange);
+    gen.test(rax, rax);
+    gen.js(negative);
+    gen.or_(GTE_FLAG, c_macFlags[index][0]);
+    gen.jmp(done);
+    gen.L(negative);
+    gen.or_(GTE_FLAG, c_macFlags[index][1]);
+    gen.L(done);
+    if (wrap) {
+        gen.mov(rax, rdx);
+    }
+    gen.L(inRange);
+}
+
+// Check if the value in rax fits in 32 bits and set the MAC0 overflow flags if not
+void DynaRecCPU::gteCheckMAC0Overflow() {
+    Xbyak::Label inRange, negative;
+
+    gen.movsxd(rdx, eax);
+    gen.cmp(rdx, rax);
+    gen.je(inRange);
+    gen.test(rax, rax);
+    gen.js(negative);
+    gen.or_(GTE_FLAG, (1u << 31) | (1 << 16));
+    gen.jmp(inRange);
+    gen.L(negative);
+    gen.or_(GTE_FLAG, (1u << 31) | (1 << 15));
+    gen.L(inRange);
+}
+
+// Clamp the signed value in "value" to [min, max], setting "flag" in FLAG if it had to be clamped
+void DynaRecCPU::gteSaturate(Reg32 value, int32_t min, int32_t max, uint32_t flag) {
+    Xbyak::Label checkMin, done;
+
+    gen.cmp(value, static_cast<uint32_t>(max));
+    gen.jle(checkMin);
+    gen.mov(value, static_cast<uint32_t>(max));
+    if (flag != 0) gen.or_(GTE_FLAG, flag);
+    gen.jmp(done);
+
+    gen.L(checkMin);
+    gen.cmp(value, static_cast<uint32_t>(min));
+    gen.jge(done);
+    gen.mov(value, static_cast<uint32_t>(min));
+    if (flag != 0) gen.or_(GTE_FLAG, flag);
+    gen.L(done);
+}
+
+// MAC1-MAC3 = (CV << 12) + MX * V, where cv == 3 means no translation vector. Every partial sum goes through the
+// 44-bit overflow checks, and the unshifted 44-bit MAC3 is left in gteTemp1 for RTPS/RTPT
+void DynaRecCPU::gteMultiplyMatrixVector(int mx, int v, int cv, bool sf) {
+    for (int row = 0; row < 3; row++) {
+        if (cv == 3) {
+            gen.xor_(eax, eax);
+        } else {
+            gen.movsxd(rax, dword[contextPointer + COP2_CONTROL_OFFSET((cv << 3) + 5 + row)]);
+            gen.shl(rax, 12);
+        }
+
+        for (int col = 0; col < 3; col++) {
+            gen.movsx(rcx, word[contextPointer + gteMatrixOffset(mx, row, col)]);
+            gen.movsx(rdx, word[contextPointer + gteVectorOffset(v, col)]);
+            gen.imul(rcx, rdx);
+            gen.add(rax, rcx);
+            gteCheckMACOverflow(row, true);
+        }
+
+        if (row == 2) {
+            gen.mov(gteTemp1, rax);
+        }
+        if (sf) {
+            gen.sar(rax, 12);
+        }
+        gen.mov(dword[contextPointer + COP2_DATA_OFFSET(25 + row)], eax);
+    }
+}
+
+// IR(index + 1) = MAC(index + 1), saturated to [lm ? 0 : -0x8000, 0x7fff]
+void DynaRecCPU::gteStoreIR(int index, bool lm) {
+    gen.mov(eax, dword[contextPointer + COP2_DATA_OFFSET(25 + index)]);
+    gteSaturate(eax, lm ? 0 : -0x8000, 0x7fff, c_irFlags[index]);
+    gen.mov(word[contextPointer + COP2_DATA_OFFSET(9 + index)], ax);
+}
+
+// Depth cueing of one colour component towards the far colour:
+// MAC = C + IR0 * saturate(FC - C), where C is (colour << 4) * IR if "fromIR" is true, or (colour << 16) otherwise
+void DynaRecCPU::gteDepthCue(int index, bool sf, bool fromIR) {
+    gen.movzx(ecx, byte[contextPointer + COP2_DATA_OFFSET(6) + index]);
+    if (fromIR) {
+        gen.shl(ecx, 4);
+        gen.movsx(edx, word[contextPointer + COP2_DATA_OFFSET(9 + index)]);
+        gen.imul(ecx, edx);
+    } else {
+        gen.shl(ecx, 16);
+    }
+
+    gen.movsxd(rax, dword[contextPointer + COP2_CONTROL_OFFSET(21 + index)]);
+    gen.shl(rax, 12);
+    gen.movsxd(rdx, ecx);
+    gen.sub(rax, rdx);
+    gteCheckMACOverflow(index, false);
+    if (sf) {
+        gen.sar(rax, 12);
+    }
+    gteSaturate(eax, -0x8000, 0x7fff, c_irFlags[index]);
+
+    gen.movsx(edx, word[contextPointer + COP2_DATA_OFFSET(8)]);
+    gen.imul(eax, edx);
+    gen.add(eax, ecx);
+    if (sf) {
+        gen.sar(eax, 12);
+    }
+    gen.mov(dword[contextPointer + COP2_DATA_OFFSET(25 + index)], eax);
+}
+
+// Push MAC1-MAC3 >> 4 to the colour FIFO, along with the CODE byte of RGBC
+void DynaRecCPU::gtePushColour() {
+    gen.mov(eax, dword[contextPointer + COP2_DATA_OFFSET(21)]);
+    gen.mov(dword[contextPointer + COP2_DATA_OFFSET(20)], eax);
+    gen.mov(eax, dword[contextPointer + COP2_DATA_OFFSET(22)]);
+    gen.mov(dword[contextPointer + COP2_DATA_OFFSET(21)], eax);
+    gen.movzx(eax, byte[contextPointer + COP2_DATA_OFFSET(6) + 3]);
+    gen.mov(byte[contextPointer + COP2_DATA_OFFSET(22) + 3], al);
+
+    for (int i = 0; i < 3; i++) {
+        gen.mov(eax, dword[contextPointer + COP2_DATA_OFFSET(25 + i)]);
+        gen.sar(eax, 4);
+        gteSaturate(eax, 0, 0xff, c_colourFlags[i]);
+        gen.mov(byte[contextPointer + COP2_DATA_OFFSET(22) + i], al);
+    }
+}
+
+// Unsigned Newton-Raphson division of H by SZ3, rounded exactly like the hardware does. Leaves the result in gteTemp2
+void DynaRecCPU::gteDivide() {
+    Xbyak::Label noOverflow, end;
+    const Reg32 denominator = gteTemp1.cvt32();
+
+    gen.movzx(eax, word[contextPointer + COP2_CONTROL_OFFSET(26)]);        // eax = H
+    gen.movzx(denominator, word[contextPointer + COP2_DATA_OFFSET(19)]);  // denominator = SZ3
+    gen.lea(edx, ptr[gteTemp1 + gteTemp1]);
+    gen.cmp(eax, edx);
+    gen.jb(noOverflow);
+    gen.or_(GTE_FLAG, (1u << 31) | (1 << 17));
+    gen.mov(gteTemp2.cvt32(), 0x1ffff);
+    gen.jmp(end, CodeGenerator::T_NEAR);
+
+    gen.L(noOverflow);  // The denominator can't be 0 here, so bsr is safe to use
+    gen.bsr(ecx, denominator);
+    gen.xor_(ecx, 15);  // ecx = countLeadingZeros16(SZ3)
+    gen.shl(denominator, cl);
+    gen.shl(eax, cl);
+    gen.and_(denominator, 0x7fff);  // r1
+    gen.lea(ecx, ptr[gteTemp1 + 0x40]);
+    gen.shr(ecx, 7);
+    loadAddress(rdx, PCSX::GTE::c_unrTable);
+    gen.movzx(ecx, byte[rdx + rcx]);
+    gen.add(ecx, 0x101);  // r2
+    gen.add(denominator, 0x8000);
+    gen.imul(denominator, ecx);
+    gen.mov(edx, 0x80);
+    gen.sub(edx, denominator);
+    gen.sar(edx, 8);
+    gen.and_(edx, 0x1ffff);  // r3
+    gen.imul(edx, ecx);
+    gen.add(edx, 0x80);
+    gen.shr(edx, 8);  // reciprocal
+    gen.imul(rax, rdx);
+    gen.add(rax, 0x8000);
+    gen.shr(rax, 16);
+    // Some divisions like 0xF015/0x780B result in 0x20000, but are saturated to 0x1ffff without setting FLAG
+    gen.mov(edx, 0x1ffff);
+    gen.cmp(rax, rdx);
+    gen.cmova(rax, rdx);
+    gen.mov(gteTemp2.cvt32(), eax);
+    gen.L(end);
+}
+
+template <bool isRTPT>
+void DynaRecCPU::recRTP(uint32_t code) {
+    Xbyak::Label fallback, end;
+    const bool sf = (code >> 19) & 1;
+    const bool lm = (code >> 10) & 1;
+
+    // The widescreen hack and PGXP live in the interpreter's implementation. Both can be toggled at runtime
+    loadAddress(rax, &PCSX::g_emulator->config().Widescreen);
+    gen.cmp(byte[rax], 0);
+    gen.jne(fallback, CodeGenerator::T_NEAR);
+    loadAddress(rax, &PCSX::g_emulator->config().PGXP_GTE);
+    gen.cmp(byte[rax], 0);
+    gen.jne(fallback, CodeGenerator::T_NEAR);
+
+    gen.mov(GTE_FLAG, 0);
+    for (int v = 0; v < (isRTPT ? 3 : 1); v++) {
+        gteMultiplyMatrixVector(0, v, 0, sf);
+        gteStoreIR(0, lm);
+        gteStoreIR(1, lm);
+
+        // IR3 is saturated from MAC3, but its flag is always set based on MAC3 >> 12
+        Xbyak::Label ir3InRange;
+        gen.mov(rax, gteTemp1);
+        gen.sar(rax, 12);
+        gen.movsx(edx, ax);
+        gen.cmp(edx, eax);
+        gen.je(ir3InRange);
+        gen.or_(GTE_FLAG, 1 << 22);
+        gen.L(ir3InRange);
+        gen.mov(ecx, dword[contextPointer + COP2_DATA_OFFSET(27)]);
+        gteSaturate(ecx, lm ? 0 : -0x8000, 0x7fff, 0);
+        gen.mov(word[contextPointer + COP2_DATA_OFFSET(11)], cx);
+
+        // Push MAC3 >> 12 to the Z FIFO
+        gteSaturate(eax, 0, 0xffff, (1u << 31) | (1 << 18));
+        for (int i = 0; i < 3; i++) {
+            gen.movzx(ecx, word[contextPointer + COP2_DATA_OFFSET(17 + i)]);
+            gen.mov(word[contextPointer + COP2_DATA_OFFSET(16 + i)], cx);
+        }
+        gen.mov(word[contextPointer + COP2_DATA_OFFSET(19)], ax);
+
+        gteDivide();
+        gen.mov(eax, dword[contextPointer + COP2_DATA_OFFSET(13)]);
+        gen.mov(dword[contextPointer + COP2_DATA_OFFSET(12)], eax);
+        gen.mov(eax, dword[contextPointer + COP2_DATA_OFFSET(14)]);
+        gen.mov(dword[contextPointer + COP2_DATA_OFFSET(13)], eax);
+
+        // SX2 = OFX + IR1 * h, SY2 = OFY + IR2 * h
+        for (int i = 0; i < 2; i++) {
+            gen.movsx(rax, word[contextPointer + COP2_DATA_OFFSET(9 + i)]);
+            gen.imul(rax, gteTemp2);
+            gen.movsxd(rdx, dword[contextPointer + COP2_CONTROL_OFFSET(24 + i)]);
+            gen.add(rax, rdx);
+            gteCheckMAC0Overflow();
+            gen.sar(rax, 16);
+            gteSaturate(eax, -0x400, 0x3ff, (1u << 31) | (1 << (14 - i)));
+            gen.mov(word[contextPointer + COP2_DATA_OFFSET(14) + i * 2], ax);
+        }
+    }
+
+    // MAC0 = DQB + DQA * h, IR0 = MAC0 >> 12
+    gen.movsx(rax, word[contextPointer + COP2_CONTROL_OFFSET(27)]);
+    gen.imul(rax, gteTemp2);
+    gen.movsxd(rdx, dword[contextPointer + COP2_CONTROL_OFFSET(28)]);
+    gen.add(rax, rdx);
+    gteCheckMAC0Overflow();
+    gen.mov(dword[contextPointer + COP2_DATA_OFFSET(24)], eax);
+    gen.sar(rax, 12);
+    gteSaturate(eax, 0, 0x1000, 1 << 12);
+    gen.mov(word[contextPointer + COP2_DATA_OFFSET(8)], ax);
+    gen.jmp(end, CodeGenerator::T_NEAR);
+
+    gen.L(fallback);
+    backupVolatileRegisters();
+    gen.mov(arg2, code);
+    if constexpr (isRTPT) {
+        emitMemberFunctionCall(&PCSX::GTE::RTPT, PCSX::g_emulator->m_gte.get());
+    } else {
+        emitMemberFunctionCall(&PCSX::GTE::RTPS, PCSX::g_emulator->m_gte.get());
+    }
+    restoreVolatileRegisters();
+    gen.L(end);
+}
+
+void DynaRecCPU::recRTPS(uint32_t code) { recRTP<false>(code); }
+void DynaRecCPU::recRTPT(uint32_t code) { recRTP<true>(code); }
+
+void DynaRecCPU::recNCLIP(uint32_t code) {
+    Xbyak::Label fallback, end;
+
+    // PGXP replaces the result with its own, higher precision one
+    loadAddress(rax, &PCSX::g_emulator->config().PGXP_GTE);
+    gen.cmp(byte[rax], 0);
+    gen.jne(fallback, CodeGenerator::T_NEAR);
+
+    // MAC0 = SX0 * SY1 + SX1 * SY2 + SX2 * SY0 - SX0 * SY2 - SX1 * SY0 - SX2 * SY1
+    gen.mov(GTE_FLAG, 0);
+    gen.xor_(eax, eax);
+    for (int i = 0; i < 3; i++) {
+        const auto sx = COP2_DATA_OFFSET(12 + i);
+        gen.movsx(rcx, word[contextPointer + sx]);
+        gen.movsx(rdx, word[contextPointer + COP2_DATA_OFFSET(12 + (i + 1) % 3) + 2]);
+        gen.imul(rcx, rdx);
+        gen.add(rax, rcx);
+        gen.movsx(rcx, word[contextPointer + sx]);
+        gen.movsx(rdx, word[contextPointer + COP2_DATA_OFFSET(12 + (i + 2) % 3) + 2]);
+        gen.imul(rcx, rdx);
+        gen.sub(rax, rcx);
+    }
+    gteCheckMAC0Overflow();
+    gen.mov(dword[contextPointer + COP2_DATA_OFFSET(24)], eax);
+    gen.jmp(end, CodeGenerator::T_NEAR);
+
+    gen.L(fallback);
+    backupVolatileRegisters();
+    gen.mov(arg2, code);
+    emitMemberFunctionCall(&PCSX::GTE::NCLIP, PCSX::g_emulator->m_gte.get());
+    restoreVolatileRegisters();
+    gen.L(end);
+}
+
+void DynaRecCPU::recMVMVA(uint32_t code) {
+    const bool sf = (code >> 19) & 1;
+    const bool lm = (code >> 10) & 1;
+    const int mx = (code >> 17) & 3;
+    const int v = (code >> 15) & 3;
+    const int cv = (code >> 13) & 3;
+
+    // The garbage matrix and the buggy far colour translation are rare enough to leave to the interpreter
+    if (mx == 3 || cv == 2) {
+        gen.mov(arg2, code);
+        callGTEFunc(&PCSX::GTE::MVMVA);
+        return;
+    }
+
+    gen.mov(GTE_FLAG, 0);
+    gteMultiplyMatrixVector(mx, v, cv, sf);
+    for (int i = 0; i < 3; i++) {
+        gteStoreIR(i, lm);
+    }
+}
+
+// Normal colour depth cue (NCDS/NCDT), or normal colour colour (NCCS/NCCT) if isNCC is true
+template <bool isNCC, bool isTriple>
+void DynaRecCPU::recNC(uint32_t code) {
+    const bool sf = (code >> 19) & 1;
+    const bool lm = (code >> 10) & 1;
+
+    gen.mov(GTE_FLAG, 0);
+    for (int v = 0; v < (isTriple ? 3 : 1); v++) {
+        // IR = light matrix * V
+        gteMultiplyMatrixVector(1, v, 3, sf);
+        for (int i = 0; i < 3; i++) {
+            gteStoreIR(i, lm);
+        }
+        // IR = BK + light colour matrix * IR
+        gteMultiplyMatrixVector(2, 3, 1, sf);
+        for (int i = 0; i < 3; i++) {
+            gteStoreIR(i, lm);
+        }
+
+        for (int i = 0; i < 3; i++) {
+            if constexpr (isNCC) {  // MAC = (colour << 4) * IR
+                gen.movzx(ecx, byte[contextPointer + COP2_DATA_OFFSET(6) + i]);
+                gen.shl(ecx, 4);
+                gen.movsx(edx, word[contextPointer + COP2_DATA_OFFSET(9 + i)]);
+                gen.imul(ecx, edx);
+                if (sf) {
+                    gen.sar(ecx, 12);
+                }
+                gen.mov(dword[contextPointer + COP2_DATA_OFFSET(25 + i)], ecx);
+            } else {
+                gteDepthCue(i, sf, true);
+            }
+        }
+
+        for (int i = 0; i < 3; i++) {
+            gteStoreIR(i, lm);
+        }
+        gtePushColour();
+    }
+}
+
+void DynaRecCPU::recNCCS(uint32_t code) { recNC<true, false>(code); }
+void DynaRecCPU::recNCCT(uint32_t code) { recNC<true, true>(code); }
+void DynaRecCPU::recNCDS(uint32_t code) { recNC<false, false>(code); }
+void DynaRecCPU::recNCDT(uint32_t code) { recNC<false, true>(code); }
+
+void DynaRecCPU::recDPCS(uint32_t code) {
+    const bool sf = (code >> 19) & 1;
+    const bool lm = (code >> 10) & 1;
+
+    gen.mov(GTE_FLAG, 0);
+    for (int i = 0; i < 3; i++) {
+        gteDepthCue(i, sf, false);
+    }
+    for (int i = 0; i < 3; i++) {
+        gteStoreIR(i, lm);
+    }
+    gtePushColour();
+}
+
+#undef GTE_FLAG
+
 #define GTE_FALLBACK(name)                      \
     void DynaRecCPU::rec##name(uint32_t code) { \
         gen.mov(arg2, code);                    \
@@ -458,22 +874,13 @@ void DynaRecCPU::recAVSZ4(uint32_t code) { recAVSZ<true>(code); }
 GTE_FALLBACK(CC);
 GTE_FALLBACK(CDP);
 GTE_FALLBACK(DCPL);
-GTE_FALLBACK(DPCS);
 GTE_FALLBACK(DPCT);
 GTE_FALLBACK(GPF);
 GTE_FALLBACK(GPL);
 GTE_FALLBACK(INTPL);
-GTE_FALLBACK(MVMVA);
-GTE_FALLBACK(NCCS);
-GTE_FALLBACK(NCCT);
-GTE_FALLBACK(NCDS);
-GTE_FALLBACK(NCDT);
-GTE_FALLBACK(NCLIP);
 GTE_FALLBACK(NCS);
 GTE_FALLBACK(NCT);
 GTE_FALLBACK(OP);
-GTE_FALLBACK(RTPS);
-GTE_FALLBACK(RTPT);
 GTE_FALLBACK(SQR);
 
 #undef GTE_FALLBACK
@@ -683,26 +683,173 @@ void DynaRecCPU::recMULTU(uint32_t code) {
     gen.mov(dword[contextPointer + HI_OFFSET], edx);
 }
 
-template <int size, bool signExtend>
-void DynaRecCPU::recompileLoadWithDelay(uint32_t code, LoadDelayDependencyType type) {
-    if (m_gprs[_Rs_].isConst()) {
-        gen.mov(arg2, m_gprs[_Rs_].val + _Imm_);
-    } else {
-        allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);
+// Backs up the allocated volatile registers around a call emitted on a cold path. Unlike prepareForCall, this leaves
+// the register allocator state alone, so the hot path next to the call can keep using the same allocation.
+void DynaRecCPU::backupVolatileRegisters() {
+    for (auto i = ALLOCATEABLE_NON_VOLATILE_COUNT; i < m_allocatedRegisters; i++) {
+        if (m_hostRegs[i].mappedReg) {
+            const auto offset = HOST_REG_CACHE_OFFSET(ALLOCATEABLE_REG_COUNT + i);
+            gen.mov(dword[contextPointer + offset], allocateableRegisters[i]);
+        }
+    }
+}
+
+void DynaRecCPU::restoreVolatileRegisters() {
+    for (auto i = ALLOCATEABLE_NON_VOLATILE_COUNT; i < m_allocatedRegisters; i++) {
+        if (m_hostRegs[i].mappedReg) {
+            const auto offset = HOST_REG_CACHE_OFFSET(ALLOCATEABLE_REG_COUNT + i);
+            gen.mov(allocateableRegisters[i], dword[contextPointer + offset]);
+        }
     }
+}
+
+// Loads from the address in arg2 through the memory read LUT, leaving the zero-extended value in eax.
+// Anything but a direct page with a host pointer takes the slow path through the Memory handlers. This includes
+// MSAN memory, which is mapped in the LUTs but needs its accesses validated, and pages with watchpoints.
+// Thrashes rax, rcx and the argument registers.
+template <int size>
+void DynaRecCPU::emitFastmemLoad() {
+    const auto memory = PCSX::g_emulator->m_mem.get();
+    Label slowPath, end;
+
+    gen.mov(ecx, arg2);
+    gen.shr(ecx, 16);  // ecx = page
+    loadAddress(rax, memory->m_readPages);
+    gen.cmp(Xbyak::util::byte[rax + rcx], uint8_t(PCSX::Memory::PageKind::Direct));
+    gen.jne(slowPath, CodeGenerator::T_NEAR);
+    loadAddress(rax, memory->m_readLUT);  // The LUT itself lives as long as the Memory object does
+    gen.mov(rax, qword[rax + rcx * 8]);   // rax = host pointer to the page
+    gen.test(rax, rax);
+    gen.jz(slowPath, CodeGenerator::T_NEAR);
+
+    gen.mov(ecx, arg2);
+    gen.and_(ecx, 0xffff);  // ecx = offset in page
+    switch (size) {
+        case 8:
+            gen.movzx(eax, Xbyak::util::byte[rax + rcx]);
+            break;
+        case 16:
+            gen.movzx(eax, word[rax + rcx]);
+            break;
+        case 32:
+            gen.mov(eax, dword[rax + rcx]);
+            break;
+    }
+    gen.inc(qword[contextPointer + CYCLE_OFFSET]);  // Account for the access like the Memory handlers do
+    gen.jmp(end, CodeGenerator::T_NEAR);
 
+    gen.L(slowPath);
+    backupVolatileRegisters();
     switch (size) {
         case 8:
-            callMemoryFunc(&PCSX::Memory::read8);
+            emitMemberFunctionCall(&PCSX::Memory::read8, memory);
             break;
         case 16:
-            callMemoryFunc(&PCSX::Memory::read16);
+            emitMemberFunctionCall(&PCSX::Memory::read16, memory);
             break;
         case 32:
-            callMemoryFunc(&PCSX::Memory::read32);
+            gen.mov(arg3, (uint32_t)PCSX::Memory::ReadType::Data);
+            emitMemberFunctionCall(&PCSX::Memory::read32, memory);
             break;
     }
+    restoreVolatileRegisters();
+    gen.L(end);
+}
+
+// Stores the value in arg3 to the address in arg2 through the memory write LUT, and flags the RAM page it lands in.
+// Writes to a word that starts a compiled block go through the Memory handlers so the block gets invalidated, as do
+// writes to anything but a direct page backed by host memory.
+// Thrashes rax, rcx and the argument registers.
+template <int size>
+void DynaRecCPU::emitFastmemStore() {
+    const auto memory = PCSX::g_emulator->m_mem.get();
+    const auto recompilerLUTOffset = (uintptr_t)&m_recompilerLUT - (uintptr_t)this;
+    const auto uncompiledBlockOffset = (uintptr_t)&m_uncompiledBlock - (uintptr_t)this;
+    Label slowPath, end;
+
+    gen.mov(ecx, arg2);
+    gen.shr(ecx, 16);  // ecx = page
+    loadAddress(rax, memory->m_writePages);
+    gen.cmp(Xbyak::util::byte[rax + rcx], uint8_t(PCSX::Memory::PageKind::Direct));
+    gen.jne(slowPath, CodeGenerator::T_NEAR);
+    gen.mov(rax, qword[contextPointer + recompilerLUTOffset]);
+    gen.mov(rax, qword[rax + rcx * 8]);  // rax = block pointers for this page
+    gen.mov(ecx, arg2);
+    gen.and_(ecx, 0xfffc);               // Same as getBlockPointer: ((address & 0xffff) >> 2) * sizeof(pointer)
+    gen.mov(rax, qword[rax + rcx * 2]);  // rax = block starting at the target word
+    gen.cmp(rax, qword[contextPointer + uncompiledBlockOffset]);
+    gen.jne(slowPath, CodeGenerator::T_NEAR);
+
+    gen.mov(ecx, arg2);
+    gen.shr(ecx, 16);
+    loadAddress(rax, memory->m_writeLUT);
+    gen.mov(rax, qword[rax + rcx * 8]);  // rax = host pointer to the page, null when the cache is isolated
+    gen.test(rax, rax);
+    gen.jz(slowPath, CodeGenerator::T_NEAR);
+
+    gen.mov(ecx, arg2);
+    gen.and_(ecx, 0xffff);
+    switch (size) {
+        case 8:
+            gen.mov(Xbyak::util::byte[rax + rcx], arg3.cvt8());
+            break;
+        case 16:
+            gen.mov(word[rax + rcx], arg3.cvt16());
+            break;
+        case 32:
+            gen.mov(dword[rax + rcx], arg3);
+            break;
+    }
+    gen.add(rax, rcx);
+    loadAddress(rcx, memory->m_wram);
+    gen.sub(rax, rcx);
+    gen.shr(rax, PCSX::Memory::c_dirtyPageShift);  // rax = index of the RAM page written to
+    loadAddress(rcx, memory->getDirtyPages());
+    gen.mov(Xbyak::util::byte[rcx + rax], 1);
+    gen.inc(qword[contextPointer + CYCLE_OFFSET]);
+    gen.jmp(end, CodeGenerator::T_NEAR);
+
+    gen.L(slowPath);
+    backupVolatileRegisters();
+    switch (size) {
+        case 8:
+            emitMemberFunctionCall(&PCSX::Memory::write8, memory);
+            break;
+        case 16:
+            emitMemberFunctionCall(&PCSX::Memory::write16, memory);
+            break;
+        case 32:
+            emitMemberFunctionCall(&PCSX::Memory::write32, memory);
+            break;
+    }
+    restoreVolatileRegisters();
+    gen.L(end);
+}
+
+template <int size, bool signExtend>
+void DynaRecCPU::recompileLoadWithDelay(uint32_t code, LoadDelayDependencyType type) {
+    if (m_gprs[_Rs_].isConst()) {
+        gen.mov(arg2, m_gprs[_Rs_].val + _Imm_);
+    } else {
+        allocateReg(_Rs_);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);
+    }
+
+    if (ENABLE_FASTMEM && !m_gprs[_Rs_].isConst()) {
+        emitFastmemLoad<size>();
+    } else {
+        switch (size) {
+            case 8:
+                callMemoryFunc(&PCSX::Memory::read8);
+                break;
+            case 16:
+                callMemoryFunc(&PCSX::Memory::read16);
+                break;
+            case 32:
+                callMemoryFunc(&PCSX::Memory::read32);
+                break;
+        }
+    }
 
     if (_Rt_) {
         m_delayedLoadInfo[m_currentDelayedLoad].active = true;
@@ -747,7 +894,8 @@ void DynaRecCPU::recompileLoad(uint32_t code) {
 
     if (m_gprs[_Rs_].isConst()) {  // Store the address in arg2
         const uint32_t addr = m_gprs[_Rs_].val + _Imm_;
-        const auto pointer = PCSX::g_emulator->m_mem->pointerRead(addr);
+        const auto memory = PCSX::g_emulator->m_mem.get();
+        const auto pointer = memory->isWatched(addr, false) ? nullptr : memory->pointerRead(addr);
 
         if (pointer != nullptr && (_Rt_) != 0) {
             allocateRegWithoutLoad(_Rt_);
@@ -762,16 +910,20 @@ void DynaRecCPU::recompileLoad(uint32_t code) {
         gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);
     }
 
-    switch (size) {
-        case 8:
-            callMemoryFunc(&PCSX::Memory::read8);
-            break;
-        case 16:
-            callMemoryFunc(&PCSX::Memory::read16);
-            break;
-        case 32:
-            callMemoryFunc(&PCSX::Memory::read32);
-            break;
+    if (ENABLE_FASTMEM && !m_gprs[_Rs_].isConst()) {
+        emitFastmemLoad<size>();
+    } else {
+        switch (size) {
+            case 8:
+                callMemoryFunc(&PCSX::Memory::read8);
+                break;
+            case 16:
+                callMemoryFunc(&PCSX::Memory::read16);
+                break;
+            case 32:
+                callMemoryFunc(&PCSX::Memory::read32);
+                break;
+        }
     }
 
     if (_Rt_) {
@@ -997,6 +1149,7 @@ void DynaRecCPU::recSB(uint32_t code) {
                 store<8>(m_gprs[_Rt_].allocatedReg.cvt8(), pointer);
             }
 
+            markDirty(pointer);
             return;
         }
 
@@ -1020,8 +1173,12 @@ void DynaRecCPU::recSB(uint32_t code) {
         }
 
         allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2   TODO: Optimize
-        callMemoryFunc(&PCSX::Memory::write8);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2
+        if constexpr (ENABLE_FASTMEM) {
+            emitFastmemStore<8>();
+        } else {
+            callMemoryFunc(&PCSX::Memory::write8);
+        }
     }
 }
 
@@ -1037,11 +1194,12 @@ void DynaRecCPU::recSH(uint32_t code) {
                 store<16>(m_gprs[_Rt_].allocatedReg.cvt16(), pointer);
             }
 
+            markDirty(pointer);
             return;
         }
 
         else if (addr == 0x1f801070) {  // I_STAT
-            gen.mov(rax, (uint64_t)&PCSX::g_emulator->m_mem->m_hard[0x1070]);
+            loadAddress(rax, &PCSX::g_emulator->m_mem->m_hard[0x1070]);
             if (m_gprs[_Rt_].isConst()) {
                 // Doing an AND directly seems to make Xbyak throw an exception due to the immediate being too big.
                 // Seems to be an xbyak bug? Affects Fromage, and potentially other titles.
@@ -1088,8 +1246,12 @@ void DynaRecCPU::recSH(uint32_t code) {
         }
 
         allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2   TODO: Optimize
-        callMemoryFunc(&PCSX::Memory::write16);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2
+        if constexpr (ENABLE_FASTMEM) {
+            emitFastmemStore<16>();
+        } else {
+            callMemoryFunc(&PCSX::Memory::write16);
+        }
     }
 }
 
@@ -1105,6 +1267,7 @@ void DynaRecCPU::recSW(uint32_t code) {
                 store<32>(m_gprs[_Rt_].allocatedReg, pointer);
             }
 
+            markDirty(pointer);
             return;
         }
 
@@ -1128,8 +1291,12 @@ void DynaRecCPU::recSW(uint32_t code) {
         }
 
         allocateReg(_Rs_);
-        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2   TODO: Optimize
-        callMemoryFunc(&PCSX::Memory::write32);
+        gen.moveAndAdd(arg2, m_gprs[_Rs_].allocatedReg, _Imm_);  // Address to write to in arg2
+        if constexpr (ENABLE_FASTMEM) {
+            emitFastmemStore<32>();
+        } else {
+            callMemoryFunc(&PCSX::Memory::write32);
+        }
     }
 }
 
@@ -1477,6 +1644,8 @@ void DynaRecCPU::recBNE(uint32_t code) {
     gen.mov(eax, m_pc + 4);  // eax = addr if jump not taken
     gen.cmovne(eax, ecx);    // if not equal, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    m_linkedPC = target;
+    m_linkedFallthroughPC = m_pc + 4;
 }
 
 void DynaRecCPU::recJ(uint32_t code) {
@@ -1511,7 +1680,7 @@ void DynaRecCPU::recJR(uint32_t code) {
 
     if (m_gprs[_Rs_].isConst()) {
         gen.mov(dword[contextPointer + PC_OFFSET], m_gprs[_Rs_].val & ~3);  // force align jump address
-        m_linkedPC = m_gprs[_Rs_].val;
+        m_linkedPC = m_gprs[_Rs_].val & ~3;
     } else {
         allocateReg(_Rs_);
         // PC will get force aligned in the dispatcher since it discards the 2 lower bits
@@ -1575,6 +1744,8 @@ void DynaRecCPU::recREGIMM(uint32_t code) {
     }
 
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    m_linkedPC = target;
+    m_linkedFallthroughPC = m_pc + 4;
 }
 
 void DynaRecCPU::recBEQ(uint32_t code) {
@@ -1612,6 +1783,8 @@ void DynaRecCPU::recBEQ(uint32_t code) {
     gen.mov(eax, m_pc + 4);  // eax = addr if jump not taken
     gen.cmove(eax, ecx);     // if equal, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    m_linkedPC = target;
+    m_linkedFallthroughPC = m_pc + 4;
 }
 
 void DynaRecCPU::recBGTZ(uint32_t code) {
@@ -1645,6 +1818,8 @@ void DynaRecCPU::recBGTZ(uint32_t code) {
     gen.mov(ecx, target);    // ecx = addr if jump is taken
     gen.cmovg(eax, ecx);     // if taken, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    m_linkedPC = target;
+    m_linkedFallthroughPC = m_pc + 4;
 }
 
 void DynaRecCPU::recBLEZ(uint32_t code) {
@@ -1678,6 +1853,8 @@ void DynaRecCPU::recBLEZ(uint32_t code) {
     gen.mov(ecx, target);    // ecx = addr if jump is taken
     gen.cmovle(eax, ecx);    // if taken, move the jump addr into eax
     gen.mov(dword[contextPointer + PC_OFFSET], eax);
+    m_linkedPC = target;
+    m_linkedFallthroughPC = m_pc + 4;
 }
 
 void DynaRecCPU::recDIV(uint32_t code) {
@@ -0,0 +1,244 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "recompiler.h"
+
+#if defined(DYNAREC_X86_64)
+#include <cstring>
+
+#if defined(__linux__)
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// Linux perf doesn't know about JIT code by itself. It can pick up symbols for it in two ways:
+// - /tmp/perf-<pid>.map, one line per block. It's simple, but perf can't tell apart code compiled at the same address
+//   at different times, which happens as soon as a region of the code cache gets evicted.
+// - /tmp/jit-<pid>.dump, in the jitdump format, which "perf inject --jit" turns into ELF objects after recording with
+//   "perf record -k mono". Records are timestamped, so reused addresses are fine, and they carry the code bytes along
+//   with the guest PC of every instruction as line information, the file name being "psx" and the line number the
+//   physical address of the instruction.
+// Both files are kept open for the whole life of the process, so that they keep describing blocks from before a reset.
+
+namespace {
+
+enum : uint32_t {
+    JIT_CODE_LOAD = 0,
+    JIT_CODE_DEBUG_INFO = 2,
+    JIT_CODE_CLOSE = 3,
+};
+
+struct JitDumpHeader {
+    uint32_t magic = 0x4a695444;  // "JiTD"
+    uint32_t version = 1;
+    uint32_t totalSize = sizeof(JitDumpHeader);
+    uint32_t elfMachine;
+    uint32_t pad = 0;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags = 0;
+};
+
+struct JitDumpRecord {
+    uint32_t id;
+    uint32_t totalSize;
+    uint64_t timestamp;
+};
+
+struct JitDumpCodeLoad {
+    JitDumpRecord record;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t codeAddress;
+    uint64_t codeSize;
+    uint64_t codeIndex;
+    // Followed by the null-terminated name of the code, then the code itself
+};
+
+struct JitDumpDebugInfo {
+    JitDumpRecord record;
+    uint64_t codeAddress;
+    uint64_t entryCount;
+    // Followed by the entries
+};
+
+struct JitDumpDebugEntry {
+    uint64_t address;
+    int32_t line;
+    int32_t discriminator;
+    // Followed by the null-terminated file name
+};
+
+constexpr char c_debugFileName[] = "psx";
+
+#if defined(__linux__)
+// Has to be the same clock "perf record -k mono" uses
+uint64_t jitDumpTimestamp() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return uint64_t(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+#endif
+
+template <typename T>
+void append(std::string& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}  // namespace
+
+void DynaRecCPU::perfOpen() {
+#if defined(__linux__)
+    if (m_perfMap || m_jitDump >= 0) return;
+    const auto pid = getpid();
+
+    m_perfMap = fopen(fmt::format("/tmp/perf-{}.map", pid).c_str(), "w");
+    m_jitDump = open(fmt::format("/tmp/jit-{}.dump", pid).c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+    if (m_jitDump >= 0) {
+        // perf finds the dump by looking for an executable mapping of it in the recording
+        m_jitDumpMarker = mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE, m_jitDump, 0);
+        if (m_jitDumpMarker == MAP_FAILED) {
+            m_jitDumpMarker = nullptr;
+            close(m_jitDump);
+            m_jitDump = -1;
+        }
+    }
+    if (m_jitDump >= 0) {
+        JitDumpHeader header;
+        header.elfMachine = EM_X86_64;
+        header.pid = pid;
+        header.timestamp = jitDumpTimestamp();
+        jitDumpWrite(&header, sizeof(header));
+    }
+
+    if (!m_perfMap || m_jitDump < 0) {
+        PCSX::g_system->printf("[Dynarec] Unable to create the perf map or jitdump files in /tmp\n");
+    }
+#else
+    PCSX::g_system->printf("[Dynarec] perf map and jitdump output are only available on Linux\n");
+#endif
+}
+
+void DynaRecCPU::perfClose() {
+#if defined(__linux__)
+    if (m_jitDump >= 0) {
+        JitDumpRecord record;
+        record.id = JIT_CODE_CLOSE;
+        record.totalSize = sizeof(record);
+        record.timestamp = jitDumpTimestamp();
+        if (jitDumpWrite(&record, sizeof(record))) jitDumpClose();
+    }
+    if (m_perfMap) {
+        fclose(m_perfMap);
+        m_perfMap = nullptr;
+    }
+#endif
+}
+
+#if defined(__linux__)
+void DynaRecCPU::jitDumpClose() {
+    munmap(m_jitDumpMarker, sysconf(_SC_PAGESIZE));
+    ::close(m_jitDump);
+    m_jitDumpMarker = nullptr;
+    m_jitDump = -1;
+}
+
+// Anything missing from the dump would make perf misread every record after it, so the first write that doesn't go
+// through entirely closes the file, and the rest of the run goes without it.
+bool DynaRecCPU::jitDumpWrite(const void* data, size_t size) {
+    if (::write(m_jitDump, data, size) == ssize_t(size)) return true;
+    PCSX::g_system->printf("[Dynarec] Unable to write to the jitdump file, disabling it\n");
+    jitDumpClose();
+    return false;
+}
+#endif
+
+std::string DynaRecCPU::perfSymbolName(uint32_t pc) {
+    auto name = fmt::format("{}_{:08X}", m_compilingTrace ? "trace" : "recompile", pc);
+    const auto symbol = findContainingSymbol(pc);
+    if (symbol) {
+        name += fmt::format(" [{}+0x{:x}]", symbol->second, pc - symbol->first);
+    }
+    return name;
+}
+
+// Describes the code at [code, code + size) to perf. m_perfLines holds the guest instructions it was compiled from,
+// if they're known, and gets consumed.
+void DynaRecCPU::perfRecordCode(const uint8_t* code, size_t size, const std::string& name) {
+#if defined(__linux__)
+    if (m_perfMap) {
+        fmt::print(m_perfMap, "{:x} {:x} {}\n", (uintptr_t)code, size, name);
+        fflush(m_perfMap);
+    }
+    if (m_jitDump < 0) {
+        m_perfLines.clear();
+        return;
+    }
+
+    const auto timestamp = jitDumpTimestamp();
+    const auto base = gen.getCode<const uint8_t*>();
+    std::string buffer;
+
+    // Line information has to come before the code it describes
+    if (!m_perfLines.empty()) {
+        JitDumpDebugInfo info;
+        info.record.id = JIT_CODE_DEBUG_INFO;
+        info.record.totalSize =
+            sizeof(info) + m_perfLines.size() * (sizeof(JitDumpDebugEntry) + sizeof(c_debugFileName));
+        info.record.timestamp = timestamp;
+        info.codeAddress = (uintptr_t)code;
+        info.entryCount = m_perfLines.size();
+        append(buffer, info);
+
+        for (const auto& line : m_perfLines) {
+            JitDumpDebugEntry entry;
+            entry.address = (uintptr_t)(base + line.offset);
+            entry.line = line.pc & 0x1fffffff;
+            entry.discriminator = 0;
+            append(buffer, entry);
+            buffer.append(c_debugFileName, sizeof(c_debugFileName));
+        }
+        m_perfLines.clear();
+    }
+
+    JitDumpCodeLoad load;
+    load.record.id = JIT_CODE_LOAD;
+    load.record.totalSize = sizeof(load) + name.size() + 1 + size;
+    load.record.timestamp = timestamp;
+    load.pid = getpid();
+    load.tid = syscall(SYS_gettid);
+    load.vma = (uintptr_t)code;
+    load.codeAddress = (uintptr_t)code;
+    load.codeSize = size;
+    load.codeIndex = m_jitDumpIndex++;
+    append(buffer, load);
+    buffer.append(name.c_str(), name.size() + 1);
+    buffer.append(reinterpret_cast<const char*>(code), size);
+
+    jitDumpWrite(buffer.data(), buffer.size());
+#else
+    m_perfLines.clear();
+#endif
+}
+#endif  // DYNAREC_X86_64
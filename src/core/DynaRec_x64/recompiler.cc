@@ -20,8 +20,11 @@
 #include "recompiler.h"
 
 #if defined(DYNAREC_X86_64)
+#include <algorithm>
 #include <cassert>
 
+#include "core/debug.h"
+
 bool DynaRecCPU::Init() {
     // Initialize recompiler memory
     // Check for 8MB RAM expansion
@@ -41,6 +44,21 @@ bool DynaRecCPU::Init() {
     m_biosBlocks = new DynarecCallback[biosSize / 4];
     m_dummyBlocks = new DynarecCallback[0x10000 / 4];  // Allocate one page worth of dummy blocks
 
+    m_links.clear();
+    m_exitSources.clear();
+    m_linksFrom.clear();
+    m_blockLinking = ENABLE_BLOCK_LINKING && PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecLinking>();
+    m_translationCacheEnabled =
+        !ENABLE_PROFILER && !ENABLE_SYMBOLS && PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecCache>();
+    m_translations.clear();
+    m_pendingTranslations.clear();
+    m_superblocks = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecSuperblocks>();
+    m_perfEnabled = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecPerf>();
+    if (m_perfEnabled) {
+        perfOpen();
+    }
+    std::fill(std::begin(m_blockHeat), std::end(m_blockHeat), c_heatThreshold);
+    m_stats = {};
     gen.reset();
 
     for (int page = 0; page < 0x10000; page++) {  // Default all pages to dummy blocks
@@ -67,8 +85,13 @@ bool DynaRecCPU::Init() {
         PCSX::g_system->message("[Dynarec] Failed to allocate executable memory.\nTry disabling the Dynarec CPU.");
         return false;
     }
-    emitDispatcher();  // Emit our assembly dispatcher
-    uncompileAll();    // Mark all blocks as uncompiled
+    emitDispatcher();    // Emit our assembly dispatcher
+    resetCodeRegions();  // Blocks go right after the dispatcher
+    uncompileAll();      // Mark all blocks as uncompiled
+    m_evictedRamBlocks.assign(m_ramSize / 4, false);
+    if (m_translationCacheEnabled) {
+        restoreTranslationCache();  // Blocks saved by a previous run go back where they were
+    }
 
     for (int i = 0; i < 0x10000 / 4; i++) {  // Mark all dummy blocks as invalid
         m_dummyBlocks[i] = m_invalidBlock;
@@ -89,6 +112,13 @@ bool DynaRecCPU::Init() {
 }
 
 void DynaRecCPU::Shutdown() {
+    if (m_translationCacheEnabled && PCSX::g_system->quitting()) {
+        saveTranslationCache();
+    }
+    if (PCSX::g_system->quitting()) {
+        perfClose();
+    }
+
     delete[] m_recompilerLUT;
     delete[] m_ramBlocks;
     delete[] m_biosBlocks;
@@ -138,6 +168,8 @@ void DynaRecCPU::error() {
 
 void DynaRecCPU::uncompileAll() {
     constexpr int biosSize = 0x80000;
+    unlinkAll();
+    m_traceDependents.clear();
     for (auto i = 0; i < m_ramSize / 4; i++) {  // Mark all RAM blocks as uncompiled
         m_ramBlocks[i] = m_uncompiledBlock;
     }
@@ -147,9 +179,113 @@ void DynaRecCPU::uncompileAll() {
 }
 
 void DynaRecCPU::flushCache() {
-    gen.reset();       // Reset the emitter's code pointer and code size variables
-    emitDispatcher();  // Re-emit dispatcher
-    uncompileAll();    // Mark all blocks as uncompiled
+    for (const auto& blocks : m_regionBlocks) {
+        for (auto block : blocks) {
+            if (*block != m_uncompiledBlock && *block != m_traceSegmentBlock) markEvicted(block);
+        }
+    }
+
+    m_links.clear();     // All linked exits are about to be discarded along with the rest of the code
+    m_exitSources.clear();
+    m_linksFrom.clear();
+    dropTranslations(gen.getCode<const uint8_t*>(), gen.getCode<const uint8_t*>() + allocSize);
+    gen.reset();         // Reset the emitter's code pointer and code size variables
+    emitDispatcher();    // Re-emit dispatcher
+    resetCodeRegions();  // Every region is empty again
+    uncompileAll();      // Mark all blocks as uncompiled
+
+    m_evictedStart = gen.getCode<const uint8_t*>();
+    m_evictedEnd = m_evictedStart + allocSize;
+    m_codeGeneration++;
+    m_stats.cacheFlushes++;
+}
+
+// Called after emitting the dispatcher, which stays at the start of region 0
+void DynaRecCPU::resetCodeRegions() {
+    for (int i = 0; i < codeRegionCount; i++) {
+        m_regionCursors[i] = i * codeRegionSize;
+        m_regionBlocks[i].clear();
+    }
+    m_regionCursors[0] = gen.getSize();
+    m_activeRegion = 0;
+    m_rotatingRegion = 1;
+}
+
+void DynaRecCPU::switchCodeRegion(int region) {
+    if (region == m_activeRegion) return;
+    m_regionCursors[m_activeRegion] = gen.getSize();
+    gen.setSize(m_regionCursors[region]);
+    m_activeRegion = region;
+}
+
+// Points the emitter to the region the block at "pc" belongs to, making room in it if needed
+void DynaRecCPU::selectCodeRegion(uint32_t pc) {
+    // BIOS and kernel code is small, hot and used by every game, so it stays resident
+    const uint32_t physical = pc & 0x1fffffff;
+    const bool resident = physical >= 0x1fc00000 || physical < 0x10000;
+    const int region = resident ? 0 : m_rotatingRegion;
+
+    switchCodeRegion(region);
+    if (gen.getSize() + maxBlockCodeSize <= (region + 1) * codeRegionSize) return;
+
+    if (resident) {  // Running out of resident space should be very rare, so just start over
+        flushCache();
+        return;
+    }
+
+    // Otherwise move on to the next region, evicting the blocks that were compiled there the longest time ago
+    m_rotatingRegion = (m_rotatingRegion == codeRegionCount - 1) ? 1 : m_rotatingRegion + 1;
+    evictCodeRegion(m_rotatingRegion);
+    switchCodeRegion(m_rotatingRegion);
+}
+
+void DynaRecCPU::evictCodeRegion(int region) {
+    const uint8_t* start = gen.getCode<const uint8_t*>() + region * codeRegionSize;
+    const uint8_t* end = start + codeRegionSize;
+    const auto inRegion = [start, end](const void* code) { return code >= start && code < end; };
+
+    for (auto block : m_regionBlocks[region]) {
+        if (!inRegion((const void*)*block)) continue;  // The block was invalidated or compiled again elsewhere since
+
+        unlinkBlock(block);
+        *block = uncompiledBlockFor(block);
+        markEvicted(block);
+        m_stats.blocksEvicted++;
+    }
+    m_regionBlocks[region].clear();
+
+    // Exits that lived in the evicted code must not get patched anymore
+    for (auto it = m_links.begin(); it != m_links.end();) {
+        std::erase_if(it->second, inRegion);
+        it = it->second.empty() ? m_links.erase(it) : std::next(it);
+    }
+    std::erase_if(m_exitSources, [&inRegion](const auto& exit) { return inRegion(exit.first); });
+    for (auto it = m_linksFrom.begin(); it != m_linksFrom.end();) {
+        std::erase_if(it->second, [&inRegion](const auto& link) { return inRegion(link.second); });
+        it = it->second.empty() ? m_linksFrom.erase(it) : std::next(it);
+    }
+
+    dropTranslations(start, end);
+    m_regionCursors[region] = region * codeRegionSize;
+    m_evictedStart = start;
+    m_evictedEnd = end;
+    m_codeGeneration++;
+    m_stats.regionEvictions++;
+}
+
+// Remembers which RAM blocks got evicted, to count how many of them have to be compiled again
+void DynaRecCPU::markEvicted(DynarecCallback* block) {
+    if (block >= m_ramBlocks && block < m_ramBlocks + m_ramSize / 4) {
+        m_evictedRamBlocks[block - m_ramBlocks] = true;
+    }
+}
+
+size_t DynaRecCPU::usedCodeSize() const {
+    size_t size = gen.getSize();
+    for (int i = 0; i < codeRegionCount; i++) {
+        if (i != m_activeRegion) size = std::max(size, m_regionCursors[i]);
+    }
+    return size;
 }
 
 void DynaRecCPU::emitBlockLookup() {
@@ -176,8 +312,8 @@ void DynaRecCPU::emitDispatcher() {
 
     gen.align(16);
     m_dispatcher = gen.getCurr<DynarecCallback>();
-    gen.push(contextPointer);                  // Save context pointer register in stack (also align stack pointer)
-    gen.mov(contextPointer, (uintptr_t)this);  // Load context pointer
+    gen.push(contextPointer);          // Save context pointer register in stack (also align stack pointer)
+    loadAddress(contextPointer, this);  // Load context pointer
 
     // Back up all our allocateable volatile regs
     static_assert((ALLOCATEABLE_NON_VOLATILE_COUNT & 1) == 0);  // Make sure we've got an even number of regs
@@ -200,14 +336,15 @@ void DynaRecCPU::emitDispatcher() {
     m_returnFromBlock = gen.getCurr<DynarecCallback>();
 
     // Poll events
+    gen.inc(qword[contextPointer + ((uintptr_t)&m_stats.dispatcherEntries - (uintptr_t)this)]);
     emitMemberFunctionCall(&PCSX::R3000Acpu::branchTest, this);
-    gen.mov(runningPointer, (uintptr_t)PCSX::g_system->runningPtr());   // Load pointer to "running" variable
-    gen.test(Xbyak::util::byte[runningPointer], 1);                     // Check if PCSX::g_system->running is true
-    gen.jz(done);                                                       // If it's not, return
-    gen.mov(runningPointer, (uintptr_t)PCSX::g_system->quittingPtr());  // Load pointer to "quitting" variable
-    gen.test(Xbyak::util::byte[runningPointer], 1);                     // Check if PCSX::g_system->running is true
-    gen.jnz(done);                                                      // If it is, return
-    emitBlockLookup();                                                  // Otherwise, look up next block
+    loadAddress(runningPointer, PCSX::g_system->runningPtr());   // Load pointer to "running" variable
+    gen.test(Xbyak::util::byte[runningPointer], 1);              // Check if PCSX::g_system->running is true
+    gen.jz(done);                                                // If it's not, return
+    loadAddress(runningPointer, PCSX::g_system->quittingPtr());  // Load pointer to "quitting" variable
+    gen.test(Xbyak::util::byte[runningPointer], 1);              // Check if PCSX::g_system->running is true
+    gen.jnz(done);                                               // If it is, return
+    emitBlockLookup();                                           // Otherwise, look up next block
 
     gen.align(16);
     // Code for exiting JIT context
@@ -237,6 +374,12 @@ void DynaRecCPU::emitDispatcher() {
     gen.callFunc(recRecompileWrapper);  // Call recompilation function. Returns pointer to emitted code
     gen.jmp(rax);
 
+    // Uncompiled blocks that are part of a trace. Only there so that stores to them don't compare equal to
+    // m_uncompiledBlock in the fastmem path, and go through Clear instead
+    gen.align(16);
+    m_traceSegmentBlock = gen.getCurr<DynarecCallback>();
+    gen.jmp((void*)m_uncompiledBlock);
+
     // Code for when the block we've jumped to is invalid. Throws an error and exits
     gen.align(16);
     m_invalidBlock = gen.getCurr<DynarecCallback>();
@@ -245,12 +388,22 @@ void DynaRecCPU::emitDispatcher() {
     gen.callFunc(recErrorWrapper);
     gen.jmp(done);  // Exit
 
+    // Code for when a linkable block exit is taken for the first time. Exits call this with the PC written back,
+    // So the return address points right past the call instruction we need to patch
+    gen.align(16);
+    m_linkBlock = gen.getCurr<DynarecCallback>();
+
+    gen.pop(arg2.cvt64());  // arg2 = return address. Popping it also realigns the stack for the upcoming call
+    loadThisPointer(arg1.cvt64());
+    gen.callFunc(recLinkBlockWrapper);  // Call linking function. Returns pointer to the block to jump to
+    gen.jmp(rax);
+
     // Code that will invalidate all RAM blocks when FlushCache is called
     gen.align(16);
     m_invalidateBlocks = gen.getCurr<DynarecCallback>();
 
     const uint32_t blockCount = m_ramSize / 4;  // Each 4 bytes correspond to 1 block
-    gen.mov(rax, (uintptr_t)m_ramBlocks);       // rax = pointer to the blocks we'll be invalidating
+    loadAddress(rax, m_ramBlocks);              // rax = pointer to the blocks we'll be invalidating
     gen.xor_(edx, edx);                         // edx = iteration counter
     Label literalPool;
 
@@ -312,6 +465,18 @@ void DynaRecCPU::emitDispatcher() {
     gen.mov(arg2, 1);                   // Fully emulate load delays
     gen.callFunc(recRecompileWrapper);  // Call recompilation function. Returns pointer to emitted code
     gen.jmp(rax);
+
+    // Code to compile the current block again as a trace once it's hot enough
+    gen.align(16);
+    m_promoteBlock = gen.getCurr<DynarecCallback>();
+    loadThisPointer(arg1.cvt64());
+    gen.callFunc(recPromoteBlockWrapper);  // Returns pointer to the trace
+    gen.jmp(rax);
+
+    if (m_perfEnabled) {
+        const auto start = (const uint8_t*)m_dispatcher;
+        perfRecordCode(start, gen.getCurr<const uint8_t*>() - start, "dispatcher");
+    }
 }
 
 // Compile a block, write address of compiled code to *callback
@@ -322,6 +487,11 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
     m_nextIsDelaySlot = false;
     m_pcWrittenBack = false;
     m_linkedPC = std::nullopt;
+    m_linkedFallthroughPC = std::nullopt;
+    m_crossBlockLoadDelay = false;
+    m_traceExits.clear();
+    m_traceSegments.clear();
+    m_perfLines.clear();
     m_delayedLoadInfo[0].active = false;
     m_delayedLoadInfo[1].active = false;
     m_pc = pc & ~3;
@@ -332,25 +502,46 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
     // If we somehow ended up compiling a block at an invalid PC, throw an error.
     if (!isPcValid(m_pc)) return m_invalidBlock;
 
+    if (!m_compilingTrace) {
+        if (!m_pendingTranslations.empty()) {
+            const auto cached = useCachedTranslation(m_pc, fullLoadDelayEmulation);
+            if (cached) return cached;
+        }
+        if (m_translationCacheEnabled) {
+            m_stats.translationCacheMisses++;
+        }
+    }
+
     const auto startingPC = m_pc;
     unsigned count = 0;                                 // How many instructions have we compiled?
     DynarecCallback* callback = getBlockPointer(m_pc);  // Pointer to where we'll store the addr of the emitted code
 
+    selectCodeRegion(m_pc);  // Evicts old code if we've gone above the acceptable size
     if (align) {
         gen.align(16);  // Align next block
     }
 
-    if (gen.getSize() > codeCacheSize) {  // Flush JIT cache if we've gone above the acceptable size
-        flushCache();
-    }
-
     if constexpr (ENABLE_SYMBOLS) {
-        m_symbols += fmt::format("{} recompile_{:08X}\n", gen.getCurr<void*>(), m_pc);
+        const auto prefix = m_compilingTrace ? "trace" : "recompile";
+        m_symbols += fmt::format("{} {}_{:08X}\n", gen.getCurr<void*>(), prefix, m_pc);
         // This is unnecessary, but it acts as a hint to the decompiler about the context pointer's value
         gen.mov(contextPointer, (uintptr_t)this);
     }
 
+    if (*callback != m_uncompiledBlock) {  // We're replacing an existing block, so stop other blocks from linking to it
+        unlinkBlock(callback);
+    }
     *callback = gen.getCurr<DynarecCallback>();  // Pointer to emitted code
+    gen.pointerFixups.clear();                   // Only keep track of the pointers embedded in this block
+    m_regionBlocks[m_activeRegion].push_back(callback);
+    m_stats.blocksCompiled++;
+    if (callback >= m_ramBlocks && callback < m_ramBlocks + m_ramSize / 4) {
+        const auto index = callback - m_ramBlocks;
+        if (m_evictedRamBlocks[index]) {
+            m_evictedRamBlocks[index] = false;
+            m_stats.blocksRecompiled++;
+        }
+    }
     if constexpr (ENABLE_PROFILER) {
         if (startProfiling(m_pc)) {  // Uncompile all blocks if the profiler data overflower
             uncompileAll();
@@ -364,18 +555,29 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
         // Recompile the block with full load delay support
         gen.cmp(Xbyak::util::byte[contextPointer + isActiveOffset], 0);
         gen.jne((void*)m_needFullLoadDelays);
+
+        if (m_superblocks && !m_compilingTrace && !isTraceBoundary(m_pc)) {
+            emitHeatCounter(m_pc);
+        }
+    }
+    if (PCSX::g_emulator->m_debug->hasExecBreakpoint(m_pc)) {
+        emitBreakpointTrap(true);
     }
     handleKernelCall();  // Check if this is a kernel call vector, emit some extra code in that case.
 
-    const auto shouldContinue = [this, &count]() {
+    const unsigned maxSize = m_compilingTrace ? MAX_TRACE_SIZE : MAX_BLOCK_SIZE;
+    const auto shouldContinue = [this, &count, maxSize, startingPC, callback]() {
         if (m_nextIsDelaySlot) {
             return true;
         }
         if (m_stopCompiling) {
-            return false;
+            return m_compilingTrace && continueTrace(startingPC, count, (const uint8_t*)*callback);
         }
-        if (count >= MAX_BLOCK_SIZE && !m_delayedLoadInfo[0].active && !m_delayedLoadInfo[1].active) {
-            return false;
+        if (!m_delayedLoadInfo[0].active && !m_delayedLoadInfo[1].active) {
+            if (count >= maxSize) return false;
+            if (gen.getCurr<const uint8_t*>() - (const uint8_t*)*callback >= blockCodeBudget) return false;
+            // Execution breakpoints start a new block, so that they can stop the CPU before their instruction
+            if (PCSX::g_emulator->m_debug->hasExecBreakpoint(m_pc)) return false;
         }
         return true;
     };
@@ -403,8 +605,15 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
         uint32_t* ptr = memory->getPointer<uint32_t>(m_pc);
         if (!ptr) return false;
         uint32_t code = m_regs.code = *ptr;
-        m_pc += 4;  // Increment recompiler PC
-        count++;    // Increment instruction count
+        markCodePage(m_pc);  // Writes to this page need to invalidate the block from now on
+        if (!m_firstInstruction && PCSX::g_emulator->m_debug->hasExecBreakpoint(m_pc)) {
+            emitBreakpointTrap(false);  // One the block couldn't be split at
+        }
+        if (m_perfEnabled) {
+            m_perfLines.push_back({(uint32_t)gen.getSize(), m_pc});
+        }
+        m_pc += 4;           // Increment recompiler PC
+        count++;             // Increment instruction count
 
         const auto func = m_recBSC[code >> 26];  // Look up the opcode in our decoding LUT
         (*this.*func)(code);                     // Jump into the handler to recompile it
@@ -454,17 +663,88 @@ DynarecCallback DynaRecCPU::recompile(uint32_t pc, bool fullLoadDelayEmulation,
     }
 
     gen.add(qword[contextPointer + CYCLE_OFFSET], count * PCSX::Emulator::BIAS);  // Add block cycles;
-    if (m_linkedPC && ENABLE_BLOCK_LINKING && m_linkedPC.value() != startingPC) {
-        handleLinking();
+    // A block branching back to its own start might be an idle loop. Let the taken side know about it, so it can
+    // fast forward to the next event. Whether the loop is actually idle depends on register values, and gets
+    // checked at runtime.
+    const uint32_t branchPC = m_pc - 8;
+    if (m_linkedPC == startingPC && !m_compilingTrace && analyseIdleLoop(branchPC, startingPC) != IdleLoop::NotIdle) {
+        Label notTaken;
+        gen.cmp(dword[contextPointer + PC_OFFSET], startingPC);
+        gen.jne(notTaken);
+        gen.mov(arg2, branchPC);
+        emitMemberFunctionCall(&PCSX::R3000Acpu::idleLoopBackEdge, this);
+        gen.L(notTaken);
+    }
+    if (m_linkedPC && m_blockLinking) {
+        handleLinking(callback);
     } else {
         gen.jmp((void*)m_returnFromBlock);
     }
 
-    // Block linking might have invalidated this block, so don't cache the pointer to the invalidated block.
-    // Instead, read the callback address again
+    if (m_compilingTrace) {
+        emitTraceExits();
+        registerTrace(callback);
+        m_stats.tracesCompiled++;
+    } else if (m_translationCacheEnabled) {
+        recordTranslation(startingPC, (const uint8_t*)*callback);
+    }
+    if (m_perfEnabled) {
+        const auto code = (const uint8_t*)*callback;
+        perfRecordCode(code, gen.getCurr<const uint8_t*>() - code, perfSymbolName(startingPC));
+    }
+    // selectCodeRegion only made sure maxBlockCodeSize bytes were free. Going past them overwrites the next region
+    assert(gen.getCurr<const uint8_t*>() - (const uint8_t*)*callback <= maxBlockCodeSize);
+    assert(gen.getSize() <= (m_activeRegion + 1) * codeRegionSize);
     return *callback;
 }
 
+// Emits a call to the execution breakpoints at m_pc. At the start of a block, the block bails out before running
+// anything if one of them paused the emulator. Breakpoints which aren't at the start of a block are the ones in a
+// branch delay slot or in a load delay slot, where the block can't be split. These still get their callbacks run,
+// with the registers written back, but a pause only takes effect once the block is over.
+void DynaRecCPU::emitBreakpointTrap(bool blockStart) {
+    if (!blockStart) {
+        flushRegs();
+        if (!m_inDelaySlot) gen.mov(dword[contextPointer + PC_OFFSET], m_pc);
+    }
+    gen.mov(arg2, m_pc);
+    emitMemberFunctionCall(&DynaRecCPU::breakpointTrap, this);
+    if (blockStart) {
+        gen.test(al, al);
+        gen.jnz((void*)m_returnFromBlock);
+    }
+}
+
+bool DynaRecCPU::breakpointTrap(uint32_t pc) {
+    // Resuming from this very breakpoint, which must let the instruction run this time around
+    const auto here = std::make_pair(pc, m_regs.cycle);
+    if (m_breakpointResume == here) {
+        m_breakpointResume.reset();
+        return false;
+    }
+
+    auto& debug = PCSX::g_emulator->m_debug;
+    if (!debug->hasExecBreakpoint(pc)) {
+        invalidateBreakpoint(pc);  // The breakpoint is gone, so compile the code again without the trap
+        return false;
+    }
+    debug->checkExecBreakpoint(pc);
+    if (PCSX::g_system->running()) return false;
+    m_breakpointResume = here;
+    return true;
+}
+
+// Blocks are only indexed by their first instruction, so drop all of those which could have reached this far.
+// Traces are dropped along with the blocks they went through.
+void DynaRecCPU::invalidateBreakpoint(uint32_t pc) {
+    pc &= 0x1ffffffc;
+    if (!isPcValid(pc)) return;
+    const uint32_t regionStart = pc >= 0x1fc00000 ? 0x1fc00000 : 0;
+    const uint32_t reach = (MAX_TRACE_SIZE + 2) * 4;
+    const uint32_t start = pc - regionStart > reach ? pc - reach : regionStart;
+    Clear(start, (pc - start) / 4 + 1);
+}
+
 void DynaRecCPU::recSpecial(uint32_t code) {
     const auto func = m_recSPC[code & 0x3f];  // Look up the opcode in our decoding LUT
     (*this.*func)(code);                      // Jump into the handler to recompile it
@@ -490,45 +770,120 @@ void DynaRecCPU::handleKernelCall() {
     }
 }
 
-// Emits a jump to the dispatcher if there's no block to link to.
-// Otherwise, handle linking blocks
-void DynaRecCPU::handleLinking() {
-    // Don't link unless the next PC is valid, and there's over 1MB of free space in the code cache
-    if (isPcValid(m_linkedPC.value()) && gen.getRemainingSize() > 0x100000) {
-        const auto nextPC = m_linkedPC.value();
-        const auto nextBlockPointer = getBlockPointer(nextPC);
-        const auto nextBlockOffset = (size_t)nextBlockPointer - (size_t)this;
-
-        if (*nextBlockPointer == m_uncompiledBlock) {  // If the next block hasn't been compiled yet
-            // Check that the block hasn't been invalidated/moved
-            // The value will be patched later. Since all code is within the same 32MB segment,
-            // We can get away with only checking the low 32 bits of the block pointer
-            if (Xbyak::inner::IsInInt32(nextBlockOffset)) {
-                gen.cmp(dword[contextPointer + nextBlockOffset], 0xcccccccc);
-            } else {
-                loadAddress(rax, nextBlockPointer);
-                gen.cmp(dword[rax], 0xcccccccc);
-            }
-
-            const auto pointer = gen.getCurr<uint8_t*>();
-            gen.jne((void*)m_returnFromBlock);  // Return if the block addr changed
-            recompile(nextPC, false);           // Fallthrough to next block
-
-            *(uint32_t*)(pointer - 4) = (uint32_t)(uintptr_t)*nextBlockPointer;  // Patch comparison value
-        } else {  // If it has already been compiled, link by jumping to the compiled code
-            if (Xbyak::inner::IsInInt32(nextBlockOffset)) {
-                gen.cmp(dword[contextPointer + nextBlockOffset], (uint32_t)(uintptr_t)*nextBlockPointer);
-            } else {
-                loadAddress(rax, nextBlockPointer);
-                gen.cmp(dword[rax], (uint32_t)(uintptr_t)*nextBlockPointer);
-            }
-
-            gen.jne((void*)m_returnFromBlock);  // Return if the block addr changed
-            gen.jmp((void*)*nextBlockPointer);  // Jump to linked block otherwise
-        }
-    } else {  // Can't link, so return to dispatcher
+// Emits the exits of a block whose successors are known at compile time.
+// Conditional branches get one exit per side of the branch
+void DynaRecCPU::handleLinking(DynarecCallback* block) {
+    const uint32_t target = m_linkedPC.value();
+
+    if (m_linkedFallthroughPC) {
+        Label notTaken;
+        gen.cmp(dword[contextPointer + PC_OFFSET], target);
+        gen.jne(notTaken);
+        emitLinkableExit(block, target, false);
+        gen.L(notTaken);
+        emitLinkableExit(block, m_linkedFallthroughPC.value(), true);
+    } else {
+        emitLinkableExit(block, target, true);
+    }
+}
+
+// Emits an exit that can later be patched into a direct jump to the block at "target".
+// Until then, it calls into m_linkBlock, which looks up (or compiles) the target and does the patching.
+// Linked exits skip the dispatcher, so they need to bail out to it by themselves whenever branchTest has work to do.
+void DynaRecCPU::emitLinkableExit(DynarecCallback* block, uint32_t target, bool checkPC) {
+    if (!isPcValid(target)) {
         gen.jmp((void*)m_returnFromBlock);
+        return;
+    }
+
+    const auto nextEventOffset = (uintptr_t)&m_regs.nextEventCycle - (uintptr_t)this;
+
+    // An exception in the delay slot might have sent us somewhere else
+    if (checkPC) {
+        gen.cmp(dword[contextPointer + PC_OFFSET], target);
+        gen.jne((void*)m_returnFromBlock);
+    }
+
+    gen.mov(rax, qword[contextPointer + CYCLE_OFFSET]);
+    gen.cmp(rax, qword[contextPointer + nextEventOffset]);  // Check if a root counter or an interrupt is due
+    gen.jae((void*)m_returnFromBlock);
+
+    // A loop linked back into itself would otherwise only notice the emulator pausing or stopping at the next event
+    if (target < m_pc) {
+        loadAddress(rax, PCSX::g_system->runningPtr());
+        gen.test(Xbyak::util::byte[rax], 1);
+        gen.jz((void*)m_returnFromBlock);
+    }
+
+    m_exitSources[gen.getCurr<const uint8_t*>()] = block;
+    gen.call((void*)m_linkBlock);  // This gets patched into a jmp to the target block
+}
+
+// Called the first time a linkable exit is taken, with the PC set to the exit's target.
+// Returns the block to jump to, after patching the exit to jump there directly next time.
+DynarecCallback DynaRecCPU::linkBlock(uint8_t* returnAddress) {
+    uint8_t* exit = returnAddress - 5;  // Size of a call rel32
+    const auto block = getBlockPointer(m_regs.pc);
+
+    if (*block == m_uncompiledBlock || *block == m_traceSegmentBlock) {
+        const auto generation = m_codeGeneration;
+        recompile(m_regs.pc, false);
+        // If compiling the target evicted the code we were called from, the exit is gone
+        if (m_codeGeneration != generation && exit >= m_evictedStart && exit < m_evictedEnd) {
+            return *block;
+        }
+    }
+
+    const auto code = (uint8_t*)*block;
+    if (code == (uint8_t*)m_invalidBlock || code == (uint8_t*)m_uncompiledBlock ||
+        code == (uint8_t*)m_traceSegmentBlock) {
+        return *block;
+    }
+
+    exit[0] = 0xE9;  // jmp rel32
+    const int32_t displacement = (int32_t)(code - returnAddress);
+    std::memcpy(&exit[1], &displacement, sizeof(displacement));
+    m_links[block].push_back(exit);
+    // Blocks loaded from the translation cache don't know where their exits are, so theirs wait for eviction
+    if (const auto source = m_exitSources.find(exit); source != m_exitSources.end()) {
+        m_linksFrom[source->second].emplace_back(block, exit);
+    }
+    m_stats.linksPatched++;
+
+    return *block;
+}
+
+// Restores all the exits that jump straight into "block" so that they go through m_linkBlock again.
+// The code "block" points to is being dropped, so the exits it had patched are forgotten as well.
+void DynaRecCPU::unlinkBlock(DynarecCallback* block) {
+    if (m_links.empty() && m_linksFrom.empty()) return;
+    const auto links = m_links.find(block);
+    if (links != m_links.end()) {
+        for (uint8_t* exit : links->second) {
+            exit[0] = 0xE8;  // call rel32
+            const int32_t displacement = (int32_t)((uint8_t*)m_linkBlock - (exit + 5));
+            std::memcpy(&exit[1], &displacement, sizeof(displacement));
+            m_stats.linksUndone++;
+        }
+        m_links.erase(links);
+    }
+
+    const auto outgoing = m_linksFrom.find(block);
+    if (outgoing == m_linksFrom.end()) return;
+    for (const auto& [target, exit] : outgoing->second) {
+        const auto incoming = m_links.find(target);
+        if (incoming == m_links.end()) continue;
+        std::erase(incoming->second, exit);
+        if (incoming->second.empty()) m_links.erase(incoming);
     }
+    m_linksFrom.erase(outgoing);
+}
+
+void DynaRecCPU::unlinkAll() {
+    while (!m_links.empty()) {
+        unlinkBlock(m_links.begin()->first);
+    }
+    m_linksFrom.clear();
 }
 
 void DynaRecCPU::handleShellReached() {
@@ -549,7 +904,10 @@ void DynaRecCPU::handleShellReached() {
 // If it does, we need to emulate the load delay
 DynaRecCPU::LoadDelayDependencyType DynaRecCPU::getLoadDelayDependencyType(int index) {
     // Always emulate load delays when there's a load in a branch delay slot
-    if (m_stopCompiling && index != 0) return LoadDelayDependencyType::DependencyAcrossBlocks;
+    if (m_stopCompiling && index != 0) {
+        m_crossBlockLoadDelay = true;
+        return LoadDelayDependencyType::DependencyAcrossBlocks;
+    }
 
     if (index == 0) {  // Loads to $zero go to the void, so don't bother emulating it as a delayed load
         return LoadDelayDependencyType::NoDependency;
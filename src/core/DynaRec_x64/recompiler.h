@@ -23,10 +23,15 @@
 #if defined(DYNAREC_X86_64)
 #include <array>
 #include <cassert>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
 #include <fstream>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "core/gpu.h"
 #include "emitter.h"
@@ -108,9 +113,12 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     DynarecCallback m_dispatcher;       // Pointer to our assembly dispatcher
     DynarecCallback m_returnFromBlock;  // Pointer to the code that will be executed when returning from a block
     DynarecCallback m_uncompiledBlock;  // Pointer to the code that will be executed when jumping to an uncompiled block
+    DynarecCallback m_traceSegmentBlock;  // Same as m_uncompiledBlock, for uncompiled blocks a trace went through
     DynarecCallback m_invalidBlock;     // Pointer to the code that will be executed the PC is invalid
     DynarecCallback m_invalidateBlocks;  // Pointer to the code that will invalidate all RAM code blocks
+    DynarecCallback m_linkBlock;         // Pointer to the code that will patch a block exit to its target block
     DynarecCallback m_loadDelayHandler;  // Pointer to the code that will handle load delays at the start of a block
+    DynarecCallback m_promoteBlock;      // Pointer to the code that will compile a hot block again as a trace
     // Pointer to the code that will be executed when a block needs to be recompiled with full load delay support
     DynarecCallback m_needFullLoadDelays;
 
@@ -176,6 +184,104 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     Register m_gprs[32];
     std::array<HostRegister, ALLOCATEABLE_REG_COUNT> m_hostRegs;
     std::optional<uint32_t> m_linkedPC = std::nullopt;
+    // For conditional branches, m_linkedPC is the address if taken, and this is the address if not taken
+    std::optional<uint32_t> m_linkedFallthroughPC = std::nullopt;
+
+    // Second compilation tier. Blocks count down how many times they get entered, and the ones that get hot are
+    // compiled again as traces, which carry on through unconditional jumps and the likely side of conditional branches
+    // instead of stopping there. Register allocation and constant propagation run across the whole trace, and every
+    // branch followed gets a side exit which writes the registers back before leaving.
+    static constexpr int c_heatSlots = 8192;  // Blocks share counters based on their PC, collisions only promote sooner
+    static constexpr uint16_t c_heatThreshold = 1000;
+    static constexpr unsigned MAX_TRACE_SIZE = 160;
+    static constexpr unsigned MAX_TRACE_SEGMENTS = 16;
+    uint16_t m_blockHeat[c_heatSlots];
+    bool m_superblocks;
+    bool m_compilingTrace = false;
+    bool m_crossBlockLoadDelay;  // A load had its delay emulated at runtime, which a trace can't carry past
+
+    struct TraceExit {
+        Label label;
+        std::optional<uint32_t> target;  // The other side of the branch, if it's known at compile time
+        unsigned count;                  // How many instructions were executed before leaving
+        std::array<Register, 32> gprs;   // Register state at the exit
+    };
+    std::deque<TraceExit> m_traceExits;
+    std::vector<uint32_t> m_traceSegments;  // Start of every piece of code the trace being compiled went through
+    // Traces indexed by the LUT entry of each of the pieces of code they went through after their first one, since
+    // writes to those only invalidate the block that starts there
+    std::unordered_map<DynarecCallback*, std::vector<DynarecCallback*>> m_traceDependents;
+
+    // Block exits that have been patched to jump straight into another block, indexed by the LUT entry of the
+    // block they jump to. When that entry gets invalidated, the exits are patched back to go through m_linkBlock.
+    std::unordered_map<DynarecCallback*, std::vector<uint8_t*>> m_links;
+    // The LUT entry of the block each linkable exit was emitted in, and the exits patched so far in each of these
+    // blocks along with their target, so that they can be taken out of m_links as soon as the block is dropped.
+    std::unordered_map<const uint8_t*, DynarecCallback*> m_exitSources;
+    std::unordered_map<DynarecCallback*, std::vector<std::pair<DynarecCallback*, uint8_t*>>> m_linksFrom;
+    bool m_blockLinking;
+
+    // Region 0 of the code cache holds the dispatcher and the BIOS/kernel blocks, and is only dropped by a full flush.
+    // The other regions are filled one after the other, and the oldest of them gets evicted when we wrap around.
+    size_t m_regionCursors[codeRegionCount];  // Where the next block goes in each region, as an offset in the cache
+    std::vector<DynarecCallback*> m_regionBlocks[codeRegionCount];  // LUT entries of the blocks in each region
+    int m_activeRegion;             // The region the emitter is currently pointed at
+    int m_rotatingRegion;           // The non-resident region new blocks currently go to
+    uint64_t m_codeGeneration = 0;  // Incremented every time code gets evicted
+    const uint8_t* m_evictedStart;  // Bounds of the code evicted last
+    const uint8_t* m_evictedEnd;
+    std::vector<bool> m_evictedRamBlocks;  // RAM blocks that were evicted and not compiled again since
+
+    // Persistent translation cache. Blocks are saved along with a checksum of the guest code they were compiled from
+    // and the location of every host pointer they embed, so that a later run can relocate them and load them back
+    // at the same place in the code cache, where their relative calls into the emulator are still valid.
+    struct CachedRelocation {
+        uint32_t offset;  // Offset of the 64-bit pointer in the block
+        uint32_t anchor;  // Index of the memory area it points into, see translationCacheAnchors
+        uint64_t delta;   // Offset of the pointer from the start of that area
+    };
+    struct CachedBlock {
+        uint32_t key;  // Start PC, with bit 0 set if the block was compiled with full load delay emulation
+        uint32_t guestSize;
+        uint32_t guestHash;
+        uint32_t codeOffset;
+        uint32_t codeSize;
+        std::vector<CachedRelocation> relocations;
+        std::vector<uint8_t> code;  // Only filled for blocks read from disk
+    };
+    bool m_translationCacheEnabled = false;
+    bool m_translationCacheRead = false;                           // The file is only read once per run
+    std::vector<CachedBlock> m_loadedTranslations;                  // What was read from the file
+    std::unordered_map<uint32_t, CachedBlock> m_pendingTranslations;  // Loaded blocks that haven't been used yet
+    std::unordered_map<const uint8_t*, CachedBlock> m_translations;   // Saveable blocks in the code cache
+
+    // Symbols for Linux perf, see perf.cc
+    struct PerfLine {
+        uint32_t offset;  // Offset of the host code in the code cache
+        uint32_t pc;      // Guest instruction it was compiled from
+    };
+    bool m_perfEnabled = false;
+    FILE* m_perfMap = nullptr;
+    int m_jitDump = -1;
+    void* m_jitDumpMarker = nullptr;
+    uint64_t m_jitDumpIndex = 0;
+    std::vector<PerfLine> m_perfLines;  // Guest instructions of the block being compiled
+
+    struct {
+        uint64_t dispatcherEntries;  // How many times did we go through the dispatcher after running a block?
+        uint64_t blocksCompiled;
+        uint64_t blocksRecompiled;  // Blocks compiled again after being evicted
+        uint64_t blocksEvicted;
+        uint64_t regionEvictions;
+        uint64_t cacheFlushes;
+        uint64_t linksPatched;
+        uint64_t linksUndone;
+        uint64_t translationCacheHits;    // Blocks loaded from the translation cache and used
+        uint64_t translationCacheMisses;  // Blocks compiled from scratch while the translation cache is enabled
+        uint64_t translationCacheStale;   // Loaded blocks whose guest code changed since they were saved
+        uint64_t tracesCompiled;
+        uint64_t traceBranchesFollowed;  // Jumps and branches compiled into traces instead of ending a block
+    } m_stats;
 
     template <LoadingMode mode = LoadingMode::Load>
     void reserveReg(int index);
@@ -198,6 +304,46 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     void handleKernelCall();
     void emitDispatcher();
     void uncompileAll();
+    void resetCodeRegions();
+    void switchCodeRegion(int region);
+    void selectCodeRegion(uint32_t pc);
+    void evictCodeRegion(int region);
+    void markEvicted(DynarecCallback* block);
+    size_t usedCodeSize() const;
+
+    std::filesystem::path translationCachePath();
+    uint64_t translationCacheFingerprint();
+    std::array<std::pair<uintptr_t, size_t>, 15> translationCacheAnchors();
+    uint32_t hashGuestCode(uint32_t pc, uint32_t size);
+    void readTranslationCache();
+    void restoreTranslationCache();
+    void saveTranslationCache();
+    void recordTranslation(uint32_t startPC, const uint8_t* code);
+    DynarecCallback useCachedTranslation(uint32_t pc, bool fullLoadDelayEmulation);
+    void dropTranslations(const uint8_t* start, const uint8_t* end);
+
+    int heatSlot(uint32_t pc) { return (pc >> 2) & (c_heatSlots - 1); }
+    bool isTraceBoundary(uint32_t pc);
+    void emitBreakpointTrap(bool blockStart);
+    bool breakpointTrap(uint32_t pc);
+    std::optional<std::pair<uint32_t, uint64_t>> m_breakpointResume;  // PC and cycle the last trap paused at
+    void emitHeatCounter(uint32_t pc);
+    bool continueTrace(uint32_t startPC, unsigned count, const uint8_t* code);
+    void emitTraceExits();
+    void registerTrace(DynarecCallback* block);
+    void dropDependentTraces(DynarecCallback* block);
+    // What to reset a block to when it's not being cleared. Traces that still went through it keep it marked.
+    DynarecCallback uncompiledBlockFor(DynarecCallback* block) {
+        return m_traceDependents.contains(block) ? m_traceSegmentBlock : m_uncompiledBlock;
+    }
+    DynarecCallback promoteBlock(uint32_t pc);
+
+    void perfOpen();
+    void perfClose();
+    void jitDumpClose();
+    bool jitDumpWrite(const void* data, size_t size);
+    std::string perfSymbolName(uint32_t pc);
+    void perfRecordCode(const uint8_t* code, size_t size, const std::string& name);
 
   public:
     DynaRecCPU() : R3000Acpu("Dynarec (x86-64)") {}
@@ -213,7 +359,7 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     }
     // For the GUI dynarec disassembly widget
     virtual const uint8_t* getBufferPtr() final { return gen.getCode<const uint8_t*>(); }
-    virtual const size_t getBufferSize() final { return gen.getSize(); }
+    virtual const size_t getBufferSize() final { return usedCodeSize(); }
 
     // TODO: Make it less slow and bad
     // Possibly clear blocks more aggressively
@@ -221,16 +367,54 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     virtual void Clear(uint32_t addr, uint32_t size) final {
         auto pointer = getBlockPointer(addr);
         for (auto i = 0; i < size; i++) {
-            *pointer++ = m_uncompiledBlock;
+            if (*pointer != m_uncompiledBlock) {
+                unlinkBlock(pointer);
+                *pointer = m_uncompiledBlock;
+            }
+            if (!m_traceDependents.empty()) {
+                dropDependentTraces(pointer);
+            }
+            pointer++;
         }
     }
 
+    virtual void invalidateBreakpoint(uint32_t pc) override final;
+
     virtual void invalidateCache() override final {
         memset(m_regs.iCacheAddr, 0xff, sizeof(m_regs.iCacheAddr));
         memset(m_regs.iCacheCode, 0xff, sizeof(m_regs.iCacheCode));
+        unlinkAll();
+        m_traceDependents.clear();
         m_invalidateBlocks();
     }
 
+    virtual std::vector<std::pair<std::string_view, uint64_t>> getStatistics() override final {
+        return {
+            {"dispatcherEntries", m_stats.dispatcherEntries},
+            {"blocksCompiled", m_stats.blocksCompiled},
+            {"blocksRecompiled", m_stats.blocksRecompiled},
+            {"blocksEvicted", m_stats.blocksEvicted},
+            {"regionEvictions", m_stats.regionEvictions},
+            {"cacheFlushes", m_stats.cacheFlushes},
+            {"clearsSkipped", m_clearsSkipped},
+            {"idleLoopsSkipped", m_idleLoopsSkipped},
+            {"idleCyclesSkipped", m_idleCyclesSkipped},
+            {"linksPatched", m_stats.linksPatched},
+            {"linksUndone", m_stats.linksUndone},
+            {"translationCacheHits", m_stats.translationCacheHits},
+            {"translationCacheMisses", m_stats.translationCacheMisses},
+            {"translationCacheStale", m_stats.translationCacheStale},
+            {"tracesCompiled", m_stats.tracesCompiled},
+            {"traceBranchesFollowed", m_stats.traceBranchesFollowed},
+        };
+    }
+    virtual void resetStatistics() override final {
+        m_stats = {};
+        m_clearsSkipped = 0;
+        m_idleLoopsSkipped = 0;
+        m_idleCyclesSkipped = 0;
+    }
+
     virtual void SetPGXPMode(uint32_t pgxpMode) final {
         if (pgxpMode != 0) {
             throw std::runtime_error("PGXP not supported in x64 JIT");
@@ -239,12 +423,20 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
 
     void dumpBuffer() const {
         std::ofstream file("DynarecOutput.dump", std::ios::binary);  // Make a file for our dump
-        file.write(gen.getCode<const char*>(), gen.getSize());       // Write the code buffer to the dump
+        file.write(gen.getCode<const char*>(), usedCodeSize());      // Write the code buffer to the dump
     }
 
   private:
     // Sets dest to "pointer"
-    void loadAddress(Xbyak::Reg64 dest, void* pointer) { gen.mov(dest, (uintptr_t)pointer); }
+    void loadAddress(Xbyak::Reg64 dest, const void* pointer) { gen.movPointer(dest, pointer); }
+
+    // Whether "pointer" can be accessed relative to the context pointer. Anything outside of this object moves
+    // around it from one run to the next, so it has to be loaded with loadAddress when blocks may get saved.
+    bool isContextRelative(const void* pointer) {
+        const auto distance = (intptr_t)pointer - (intptr_t)this;
+        if (distance >= 0 && distance < (intptr_t)sizeof(DynaRecCPU)) return true;
+        return !m_translationCacheEnabled && Xbyak::inner::IsInInt32(distance);
+    }
 
     // Loads a value into dest from the given pointer.
     // Tries to use base pointer relative addressing, otherwise uses movabs
@@ -252,7 +444,7 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     void load(Xbyak::Reg32 dest, const void* pointer) {
         const auto distance = (intptr_t)pointer - (intptr_t)this;
 
-        if (Xbyak::inner::IsInInt32(distance)) {
+        if (isContextRelative(pointer)) {
             switch (size) {
                 case 8:
                     signExtend ? gen.movsx(dest, Xbyak::util::byte[contextPointer + distance])
@@ -267,7 +459,7 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
                     break;
             }
         } else {
-            gen.mov(rax, (uintptr_t)pointer);
+            loadAddress(rax, pointer);
             switch (size) {
                 case 8:
                     signExtend ? gen.movsx(dest, Xbyak::util::byte[rax]) : gen.movzx(dest, Xbyak::util::byte[rax]);
@@ -288,7 +480,7 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     void store(T source, const void* pointer) {
         const auto distance = (intptr_t)pointer - (intptr_t)this;
 
-        if (Xbyak::inner::IsInInt32(distance)) {
+        if (isContextRelative(pointer)) {
             switch (size) {
                 case 8:
                     gen.mov(Xbyak::util::byte[contextPointer + distance], source);
@@ -301,7 +493,7 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
                     break;
             }
         } else {
-            gen.mov(rax, (uintptr_t)pointer);
+            loadAddress(rax, pointer);
             switch (size) {
                 case 8:
                     gen.mov(Xbyak::util::byte[rax], source);
@@ -316,6 +508,12 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
         }
     }
 
+    // Stores to a constant address bypass the Memory handlers, so they have to flag the RAM page themselves.
+    void markDirty(const void* pointer) {
+        const auto flag = PCSX::g_emulator->m_mem->dirtyFlag(pointer);
+        if (flag) store<8>(1, flag);
+    }
+
     // Emit a call to a class member function, passing "thisObject" (+ an adjustment if necessary)
     // As the function's "this" pointer. Only works with classes with single, non-virtual inheritance
     // Hence the static asserts. Those are all we need though, thankfully.
@@ -368,6 +566,10 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     static DynarecCallback recRecompileWrapper(DynaRecCPU* that, bool fullLoadDelayEmulation) {
         return that->recompile(that->m_regs.pc, fullLoadDelayEmulation);
     }
+    static DynarecCallback recPromoteBlockWrapper(DynaRecCPU* that) { return that->promoteBlock(that->m_regs.pc); }
+    static DynarecCallback recLinkBlockWrapper(DynaRecCPU* that, uint8_t* returnAddress) {
+        return that->linkBlock(returnAddress);
+    }
 
     // Check if we're executing from valid memory
     inline bool isPcValid(uint32_t addr) { return m_recompilerLUT[addr >> 16] != m_dummyBlocks; }
@@ -376,7 +578,11 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     DynarecCallback recompile(uint32_t pc, bool fullLoadDelayEmulation, bool align = true);
     void error();
     void flushCache();
-    void handleLinking();
+    void handleLinking(DynarecCallback* block);
+    void emitLinkableExit(DynarecCallback* block, uint32_t target, bool checkPC);
+    DynarecCallback linkBlock(uint8_t* returnAddress);
+    void unlinkBlock(DynarecCallback* block);
+    void unlinkAll();
     void handleShellReached();
     void emitBlockLookup();
 
@@ -508,6 +714,22 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     void recAVSZ(uint32_t code);
     void loadGTEDataRegister(Reg32 dest, int index);
 
+    // Native implementations of the most common GTE operations, bit-exact with the interpreter's
+    template <bool isRTPT>
+    void recRTP(uint32_t code);
+    template <bool isNCC, bool isTriple>
+    void recNC(uint32_t code);
+    uintptr_t gteMatrixOffset(int mx, int row, int col);
+    uintptr_t gteVectorOffset(int v, int i);
+    void gteCheckMACOverflow(int index, bool wrap);
+    void gteCheckMAC0Overflow();
+    void gteSaturate(Reg32 value, int32_t min, int32_t max, uint32_t flag);
+    void gteMultiplyMatrixVector(int mx, int v, int cv, bool sf);
+    void gteStoreIR(int index, bool lm);
+    void gteDepthCue(int index, bool sf, bool fromIR);
+    void gtePushColour();
+    void gteDivide();
+
     template <bool readSR>
     void testSoftwareInterrupt();
 
@@ -526,6 +748,14 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     template <int size, bool signExtend>
     void recompileLoadWithDelay(uint32_t code, LoadDelayDependencyType dependencyType);
 
+    // Inline memory accesses for addresses only known at runtime. Address in arg2, value to store in arg3.
+    template <int size>
+    void emitFastmemLoad();
+    template <int size>
+    void emitFastmemStore();
+    void backupVolatileRegisters();
+    void restoreVolatileRegisters();
+
     const recompilationFunc m_recBSC[64] = {
         &DynaRecCPU::recSpecial, &DynaRecCPU::recREGIMM,  &DynaRecCPU::recJ,       &DynaRecCPU::recJAL,      // 00
         &DynaRecCPU::recBEQ,     &DynaRecCPU::recBNE,     &DynaRecCPU::recBLEZ,    &DynaRecCPU::recBGTZ,     // 04
@@ -584,6 +814,7 @@ class DynaRecCPU final : public PCSX::R3000Acpu {
     };
 
     static constexpr bool ENABLE_BLOCK_LINKING = true;
+    static constexpr bool ENABLE_FASTMEM = true;
     static constexpr bool ENABLE_PROFILER = false;
     static constexpr bool ENABLE_SYMBOLS = false;
 };
@@ -0,0 +1,149 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "recompiler.h"
+
+#if defined(DYNAREC_X86_64)
+#include <algorithm>
+
+#include "core/debug.h"
+
+// Kernel call vectors, the shell entry point and execution breakpoints emit extra code at the start of their block,
+// so traces stop there
+bool DynaRecCPU::isTraceBoundary(uint32_t pc) {
+    if (pc == 0x80030000) return true;
+    if (PCSX::g_emulator->m_debug->hasExecBreakpoint(pc)) return true;
+
+    const uint32_t base = (pc >> 20) & 0xffc;
+    if ((base != 0x000) && (base != 0x800) && (base != 0xa00)) return false;
+    const uint32_t offset = pc & PCSX::g_emulator->getRamMask();
+    return offset == 0xA0 || offset == 0xB0 || offset == 0xC0;
+}
+
+// Counts down every time the block is entered, and jumps to m_promoteBlock once the counter runs out
+void DynaRecCPU::emitHeatCounter(uint32_t pc) {
+    const auto heatOffset = (uintptr_t)&m_blockHeat[heatSlot(pc)] - (uintptr_t)this;
+    gen.sub(word[contextPointer + heatOffset], 1);
+    gen.jz((void*)m_promoteBlock);
+}
+
+// Called with the PC of a block whose counter ran out. Compiles it again as a trace, which replaces the block.
+DynarecCallback DynaRecCPU::promoteBlock(uint32_t pc) {
+    m_blockHeat[heatSlot(pc)] = c_heatThreshold;
+    m_compilingTrace = true;
+    const auto code = recompile(pc, false);
+    m_compilingTrace = false;
+    return code;
+}
+
+// Called instead of ending the trace when a jump or branch has been compiled, after its delay slot.
+// If the trace can carry on, emits the side exit check and points the recompiler to the next piece of code.
+bool DynaRecCPU::continueTrace(uint32_t startPC, unsigned count, const uint8_t* code) {
+    if (!m_linkedPC || m_crossBlockLoadDelay) return false;
+    if (m_delayedLoadInfo[0].active || m_delayedLoadInfo[1].active) return false;
+    if (count >= MAX_TRACE_SIZE || m_traceSegments.size() >= MAX_TRACE_SEGMENTS) return false;
+    if (gen.getCurr<const uint8_t*>() - code >= maxBlockCodeSize / 4) return false;
+
+    uint32_t next = m_linkedPC.value();
+    std::optional<uint32_t> other = std::nullopt;
+    if (m_linkedFallthroughPC) {
+        // Blocks with lower counters have been entered more often. If that doesn't tell, assume loops keep looping.
+        const uint32_t taken = m_linkedPC.value();
+        const uint32_t notTaken = m_linkedFallthroughPC.value();
+        const auto takenHeat = m_blockHeat[heatSlot(taken)];
+        const auto notTakenHeat = m_blockHeat[heatSlot(notTaken)];
+        const bool likelyTaken = takenHeat == notTakenHeat ? taken < notTaken : takenHeat < notTakenHeat;
+
+        next = likelyTaken ? taken : notTaken;
+        other = likelyTaken ? notTaken : taken;
+    }
+
+    // Going back to the start of the trace, or anywhere it's already been, is left to block linking
+    if (next == startPC || !isPcValid(next) || isTraceBoundary(next)) return false;
+    if (std::find(m_traceSegments.begin(), m_traceSegments.end(), next) != m_traceSegments.end()) return false;
+
+    // The PC was written back by the branch. It can also differ from both sides if the delay slot threw an exception.
+    auto& exit = m_traceExits.emplace_back();
+    exit.target = other;
+    exit.count = count;
+    std::copy(std::begin(m_gprs), std::end(m_gprs), exit.gprs.begin());
+    gen.cmp(dword[contextPointer + PC_OFFSET], next);
+    gen.jne(exit.label, CodeGenerator::T_NEAR);
+
+    m_traceSegments.push_back(next);
+    m_pc = next;
+    m_stopCompiling = false;
+    m_pcWrittenBack = false;
+    m_linkedPC = std::nullopt;
+    m_linkedFallthroughPC = std::nullopt;
+    m_stats.traceBranchesFollowed++;
+    return true;
+}
+
+// Emits the side exits of the trace, out of line after its main exit.
+// Each of them writes back the registers the trace had in flight at the time, without touching the allocator.
+void DynaRecCPU::emitTraceExits() {
+    for (auto& exit : m_traceExits) {
+        gen.L(exit.label);
+        for (auto i = 1; i < 32; i++) {
+            const auto& reg = exit.gprs[i];
+            if (reg.state == RegState::Constant) {
+                gen.mov(dword[contextPointer + GPR_OFFSET(i)], reg.val);
+            } else if (reg.allocated && reg.writeback) {
+                gen.mov(dword[contextPointer + GPR_OFFSET(i)], reg.allocatedReg);
+            }
+        }
+
+        gen.add(qword[contextPointer + CYCLE_OFFSET], exit.count * PCSX::Emulator::BIAS);
+        if (exit.target && m_blockLinking) {
+            emitLinkableExit(exit.target.value(), true);
+        } else {
+            gen.jmp((void*)m_returnFromBlock);
+        }
+    }
+    m_traceExits.clear();
+}
+
+// Writes to the code a trace went through only invalidate the block starting at the address written, so remember
+// which traces have to go along with it. Segments that were never compiled on their own get marked, as fastmem stores
+// only take the slow path that ends up in Clear when the block at the address written isn't m_uncompiledBlock
+void DynaRecCPU::registerTrace(DynarecCallback* block) {
+    for (const auto pc : m_traceSegments) {
+        const auto segment = getBlockPointer(pc);
+        if (*segment == m_uncompiledBlock) {
+            *segment = m_traceSegmentBlock;
+        }
+        m_traceDependents[segment].push_back(block);
+    }
+}
+
+void DynaRecCPU::dropDependentTraces(DynarecCallback* block) {
+    const auto dependents = m_traceDependents.find(block);
+    if (dependents == m_traceDependents.end()) return;
+
+    const auto traces = std::move(dependents->second);
+    m_traceDependents.erase(dependents);
+    for (auto trace : traces) {
+        if (*trace != m_uncompiledBlock && *trace != m_traceSegmentBlock) {
+            unlinkBlock(trace);
+            *trace = uncompiledBlockFor(trace);
+        }
+    }
+}
+#endif  // DYNAREC_X86_64
@@ -112,6 +112,7 @@ void DynaRecCPU::makeSymbols() {
     m_symbols += fmt::format("{} dispatcher_entry\n", (void*)m_dispatcher);
     m_symbols += fmt::format("{} return_from_block\n", (void*)m_returnFromBlock);
     m_symbols += fmt::format("{} uncompiled_block_handler\n", (void*)m_uncompiledBlock);
+    m_symbols += fmt::format("{} trace_segment_handler\n", (void*)m_traceSegmentBlock);
     m_symbols += fmt::format("{} invalid_block_handler\n", (void*)m_invalidBlock);
 }
 
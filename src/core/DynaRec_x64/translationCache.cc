@@ -0,0 +1,297 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "recompiler.h"
+
+#if defined(DYNAREC_X86_64)
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/debug.h"
+#include "core/gte.h"
+#include "core/psxcounters.h"
+#include "support/binpath.h"
+#include "support/djbhash.h"
+#include "support/file.h"
+
+// Bump this whenever the file layout changes. Code generation changes are covered by the executable fingerprint.
+static constexpr uint32_t c_translationCacheVersion = 2;
+static constexpr uint64_t c_translationCacheMagic = PCSX::djb::ctHash("PCSX-Redux translation cache");
+
+std::filesystem::path DynaRecCPU::translationCachePath() {
+    std::filesystem::path path = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDynarecCachePath>();
+    if (path.is_relative()) {
+        path = PCSX::g_system->getPersistentDir() / path;
+    }
+    return path;
+}
+
+// Saved blocks are only valid for the exact same executable, emitting the exact same dispatcher,
+// with the same settings as the ones that influence code generation.
+uint64_t DynaRecCPU::translationCacheFingerprint() {
+    std::error_code error;
+    const std::filesystem::path executable = PCSX::BinPath::getExecutablePath();
+    const auto executableSize = std::filesystem::file_size(executable, error);
+    const auto executableTime = std::filesystem::last_write_time(executable, error).time_since_epoch().count();
+
+    const auto base = gen.getCode<const uint8_t*>();
+    const auto offset = [base](DynarecCallback entry) { return (const uint8_t*)entry - base; };
+    const auto description = fmt::format(
+        "{}:{}:{}:{}:{}:{}:{}:{}:{}:{}:{}:{}:{}:{}:{}:{}:{}:{}:{}:{}", c_translationCacheVersion, executableSize,
+        executableTime, m_ramSize, m_blockLinking, m_superblocks, gen.hasAVX, gen.hasBMI2, gen.hasLZCNT,
+        codeCacheSize, codeRegionCount, offset(m_returnFromBlock), offset(m_uncompiledBlock), offset(m_invalidBlock),
+        offset(m_invalidateBlocks), offset(m_linkBlock), offset(m_loadDelayHandler), offset(m_needFullLoadDelays),
+        offset(m_promoteBlock), offset(m_traceSegmentBlock));
+    return PCSX::djb::hash(description);
+}
+
+// Every host pointer a block embeds has to point inside one of these, or the block can't be saved.
+// Relocations refer to them by index, so new entries go at the end.
+std::array<std::pair<uintptr_t, size_t>, 15> DynaRecCPU::translationCacheAnchors() {
+    const auto& memory = PCSX::g_emulator->m_mem;
+    const auto anchor = [](const void* pointer, size_t size) { return std::make_pair((uintptr_t)pointer, size); };
+
+    return {
+        anchor(this, sizeof(DynaRecCPU)),
+        anchor(PCSX::g_emulator, sizeof(PCSX::Emulator)),
+        anchor(memory.get(), sizeof(PCSX::Memory)),
+        anchor(memory->m_wram, 0x800000),
+        anchor(memory->m_exp1, 0x800000),
+        anchor(memory->m_bios, 0x80000),
+        anchor(memory->m_hard, 0x10000),
+        anchor(memory->m_readLUT, 0x10000 * sizeof(uint8_t*)),
+        anchor(memory->m_writeLUT, 0x10000 * sizeof(uint8_t*)),
+        anchor(PCSX::g_emulator->m_counters.get(), sizeof(PCSX::Counters)),
+        anchor(PCSX::g_emulator->m_gte.get(), sizeof(PCSX::GTE)),
+        anchor(PCSX::GTE::c_unrTable, sizeof(PCSX::GTE::c_unrTable)),
+        anchor(memory->m_readPages, 0x10000 * sizeof(PCSX::Memory::PageKind)),
+        anchor(memory->m_writePages, 0x10000 * sizeof(PCSX::Memory::PageKind)),
+        anchor(PCSX::g_system, sizeof(PCSX::System)),
+    };
+}
+
+uint32_t DynaRecCPU::hashGuestCode(uint32_t pc, uint32_t size) {
+    static constexpr uint8_t unmapped[4] = {0xff, 0xff, 0xff, 0xff};
+    auto& memory = PCSX::g_emulator->m_mem;
+    uLong hash = crc32(0L, Z_NULL, 0);
+
+    for (uint32_t offset = 0; offset < size; offset += 4) {
+        const auto pointer = memory->getPointer<uint8_t>(pc + offset);
+        hash = crc32(hash, pointer ? pointer : unmapped, 4);
+    }
+    return hash;
+}
+
+// Called at the end of recompile, while gen.pointerFixups still lists the pointers emitted for the block
+void DynaRecCPU::recordTranslation(uint32_t startPC, const uint8_t* code) {
+    const auto base = gen.getCode<const uint8_t*>();
+    const auto anchors = translationCacheAnchors();
+    CachedBlock block;
+
+    block.key = startPC | (m_fullLoadDelayEmulation ? 1 : 0);
+    block.guestSize = m_pc + 4 - startPC;  // The instruction right after the block gets peeked at for load delays
+    block.guestHash = hashGuestCode(startPC, block.guestSize);
+    block.codeOffset = code - base;
+    block.codeSize = gen.getCurr<const uint8_t*>() - code;
+
+    for (const auto fixup : gen.pointerFixups) {
+        uint64_t pointer;
+        std::memcpy(&pointer, base + fixup, sizeof(pointer));
+        const auto anchor = std::find_if(anchors.begin(), anchors.end(), [pointer](const auto& anchor) {
+            return pointer >= anchor.first && pointer - anchor.first < anchor.second;
+        });
+        if (anchor == anchors.end()) return;  // We wouldn't know where this points to in the next run
+
+        block.relocations.push_back(
+            {uint32_t(base + fixup - code), uint32_t(anchor - anchors.begin()), pointer - anchor->first});
+    }
+
+    m_translations[code] = std::move(block);
+}
+
+void DynaRecCPU::readTranslationCache() {
+    m_translationCacheRead = true;
+    m_loadedTranslations.clear();
+
+    IO<PCSX::File> file(new PCSX::PosixFile(translationCachePath()));
+    if (file->failed()) return;
+    if (file->read<uint64_t>() != c_translationCacheMagic) return;
+    if (file->read<uint64_t>() != translationCacheFingerprint()) {
+        PCSX::g_system->printf("[Dynarec] Ignoring translation cache made by a different build or configuration\n");
+        return;
+    }
+
+    const uint32_t count = file->read<uint32_t>();
+    const size_t anchorCount = translationCacheAnchors().size();
+    std::vector<CachedBlock> blocks;
+
+    for (uint32_t i = 0; i < count; i++) {
+        CachedBlock block;
+        block.key = file->read<uint32_t>();
+        block.guestSize = file->read<uint32_t>();
+        block.guestHash = file->read<uint32_t>();
+        block.codeOffset = file->read<uint32_t>();
+        block.codeSize = file->read<uint32_t>();
+        const uint32_t relocationCount = file->read<uint32_t>();
+        if (block.codeSize == 0 || block.codeSize > maxBlockCodeSize || relocationCount > block.codeSize / 8) return;
+
+        block.relocations.resize(relocationCount);
+        for (auto& relocation : block.relocations) {
+            relocation.offset = file->read<uint32_t>();
+            relocation.anchor = file->read<uint32_t>();
+            relocation.delta = file->read<uint64_t>();
+            if (relocation.offset > block.codeSize - 8 || relocation.anchor >= anchorCount) return;
+        }
+
+        block.code.resize(block.codeSize);
+        if (file->read(block.code.data(), block.codeSize) != (ssize_t)block.codeSize) return;
+        blocks.push_back(std::move(block));
+    }
+
+    m_loadedTranslations = std::move(blocks);
+    PCSX::g_system->printf("[Dynarec] Read %zu blocks from the translation cache\n", m_loadedTranslations.size());
+}
+
+// Copies the blocks read from the file back to where they were in the code cache, and patches their pointers.
+// They only get hooked into the block LUTs by useCachedTranslation, once their guest code has been checked.
+void DynaRecCPU::restoreTranslationCache() {
+    if (!m_translationCacheRead) readTranslationCache();
+
+    const auto anchors = translationCacheAnchors();
+    const auto base = gen.getCode<uint8_t*>();
+    const size_t dispatcherEnd = m_regionCursors[0];
+
+    for (const auto& loaded : m_loadedTranslations) {
+        const size_t start = loaded.codeOffset;
+        const size_t end = start + loaded.codeSize;
+        const size_t region = start / codeRegionSize;
+        if (start < dispatcherEnd || end > codeCacheSize || (end - 1) / codeRegionSize != region) continue;
+
+        const bool relocatable = std::all_of(loaded.relocations.begin(), loaded.relocations.end(),
+                                             [&anchors](const auto& relocation) {
+                                                 const auto& anchor = anchors[relocation.anchor];
+                                                 return anchor.first != 0 && relocation.delta < anchor.second;
+                                             });
+        if (!relocatable) continue;
+
+        std::memcpy(base + start, loaded.code.data(), loaded.codeSize);
+        for (const auto& relocation : loaded.relocations) {
+            const uint64_t pointer = anchors[relocation.anchor].first + relocation.delta;
+            std::memcpy(base + start + relocation.offset, &pointer, sizeof(pointer));
+        }
+        m_regionCursors[region] = std::max(m_regionCursors[region], end);
+
+        auto& pending = m_pendingTranslations[loaded.key];
+        pending.key = loaded.key;
+        pending.guestSize = loaded.guestSize;
+        pending.guestHash = loaded.guestHash;
+        pending.codeOffset = loaded.codeOffset;
+        pending.codeSize = loaded.codeSize;
+        pending.relocations = loaded.relocations;
+    }
+
+    gen.setSize(m_regionCursors[m_activeRegion]);
+}
+
+// Returns the loaded block for "pc" after making it the current one, or nullptr if it has to be compiled
+DynarecCallback DynaRecCPU::useCachedTranslation(uint32_t pc, bool fullLoadDelayEmulation) {
+    const auto pending = m_pendingTranslations.find(pc | (fullLoadDelayEmulation ? 1 : 0));
+    if (pending == m_pendingTranslations.end()) return nullptr;
+
+    CachedBlock block = std::move(pending->second);
+    m_pendingTranslations.erase(pending);
+    if (hashGuestCode(pc, block.guestSize) != block.guestHash) {
+        m_stats.translationCacheStale++;
+        return nullptr;
+    }
+    // Cached code wasn't compiled with the breakpoints we have now
+    if (PCSX::g_emulator->m_debug->hasExecBreakpoint(pc, block.guestSize)) return nullptr;
+
+    const auto code = gen.getCode<const uint8_t*>() + block.codeOffset;
+    const auto callback = getBlockPointer(pc);
+    if (*callback != m_uncompiledBlock) {
+        unlinkBlock(callback);
+    }
+    *callback = (DynarecCallback)code;
+    m_regionBlocks[block.codeOffset / codeRegionSize].push_back(callback);
+    if (callback >= m_ramBlocks && callback < m_ramBlocks + m_ramSize / 4) {
+        m_evictedRamBlocks[callback - m_ramBlocks] = false;
+    }
+    for (uint32_t offset = 0; offset < block.guestSize; offset += 4) {
+        markCodePage(pc + offset);
+    }
+
+    if (m_perfEnabled) {
+        perfRecordCode(code, block.codeSize, perfSymbolName(pc));
+    }
+    m_translations[code] = std::move(block);
+    m_stats.translationCacheHits++;
+    return *callback;
+}
+
+// Forgets about the blocks in [start, end) of the code cache, as that code is about to be overwritten
+void DynaRecCPU::dropTranslations(const uint8_t* start, const uint8_t* end) {
+    const auto base = gen.getCode<const uint8_t*>();
+    std::erase_if(m_translations,
+                  [start, end](const auto& entry) { return entry.first >= start && entry.first < end; });
+    std::erase_if(m_pendingTranslations, [base, start, end](const auto& entry) {
+        const auto code = base + entry.second.codeOffset;
+        return code >= start && code < end;
+    });
+}
+
+// Writes all the blocks that are still current out, so that the next run can pick them up
+void DynaRecCPU::saveTranslationCache() {
+    unlinkAll();  // Patched exits jump straight into other blocks, which may not get loaded back
+
+    const auto base = gen.getCode<const uint8_t*>();
+    std::vector<const CachedBlock*> blocks;
+    for (const auto& [code, block] : m_translations) {
+        if (*getBlockPointer(block.key & ~1) == (DynarecCallback)code) blocks.push_back(&block);
+    }
+
+    IO<PCSX::File> file(new PCSX::PosixFile(translationCachePath(), PCSX::FileOps::TRUNCATE));
+    if (file->failed()) {
+        PCSX::g_system->printf("[Dynarec] Unable to write the translation cache\n");
+        return;
+    }
+
+    file->write<uint64_t>(c_translationCacheMagic);
+    file->write<uint64_t>(translationCacheFingerprint());
+    file->write<uint32_t>(blocks.size());
+    for (const auto block : blocks) {
+        file->write<uint32_t>(block->key);
+        file->write<uint32_t>(block->guestSize);
+        file->write<uint32_t>(block->guestHash);
+        file->write<uint32_t>(block->codeOffset);
+        file->write<uint32_t>(block->codeSize);
+        file->write<uint32_t>(block->relocations.size());
+        for (const auto& relocation : block->relocations) {
+            file->write<uint32_t>(relocation.offset);
+            file->write<uint32_t>(relocation.anchor);
+            file->write<uint64_t>(relocation.delta);
+        }
+        file->write(base + block->codeOffset, block->codeSize);
+    }
+    PCSX::g_system->printf("[Dynarec] Wrote %zu blocks to the translation cache\n", blocks.size());
+}
+
+#endif  // DYNAREC_X86_64
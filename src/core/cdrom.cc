@@ -185,7 +185,7 @@ class CDRomImpl : public PCSX::CDRom {
     inline void StopReading() {
         if (m_reading) {
             m_reading = 0;
-            PCSX::g_emulator->m_cpu->m_regs.interrupt &= ~(1 << PCSX::PSXINT_CDREAD);
+            PCSX::g_emulator->m_cpu->cancelInterrupt(PCSX::PSXINT_CDREAD);
         }
         m_statP &= ~(STATUS_READ | STATUS_SEEK);
     }
@@ -1470,7 +1470,7 @@ class CDRomImpl : public PCSX::CDRom {
                         .get<PCSX::Emulator::DebugSettings::Debug>()) {
                     PCSX::g_emulator->m_debug->checkDMAwrite(3, madr, cdsize);
                 }
-                PCSX::g_emulator->m_cpu->Clear(madr, cdsize / 4);
+                PCSX::g_emulator->m_cpu->clearIfCode(madr, cdsize / 4);
                 // burst vs normal
                 if (chcr == 0x11400100) {
                     scheduleCDDMAIRQ((cdsize / 4) / 4);
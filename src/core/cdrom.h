@@ -159,7 +159,7 @@ class CDRom {
     } m_subq;
     bool m_trackChanged;
     // end savestate
-    friend SaveStates::SaveState SaveStates::constructSaveState();
+    friend SaveStates::SaveState SaveStates::constructSaveState(bool incremental);
 
   private:
     friend class Widgets::IsoBrowser;
@@ -0,0 +1,146 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/cpu-trace-recorder.h"
+
+#include <string.h>
+
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+#include "mips/common/util/decoder.hh"
+#include "support/zfile.h"
+
+bool PCSX::CPUTraceRecorder::start(const std::filesystem::path& path) {
+    stop();
+    IO<File> file(new PosixFile(path, FileOps::TRUNCATE));
+    if (file->failed()) return false;
+    m_file = new ZWriter(file, ZWriter::GZIP);
+    if (!m_buffer) m_buffer.reset(new uint8_t[c_bufferSize]);
+    m_used = 0;
+    m_recordCount = 0;
+    for (auto c : CPUTrace::c_magic) put8(c);
+    put32(CPUTrace::c_version);
+
+    if (g_emulator && g_emulator->m_cpu) {
+        memcpy(m_registers, g_emulator->m_cpu->m_regs.GPR.r, sizeof(m_registers));
+    } else {
+        memset(m_registers, 0, sizeof(m_registers));
+    }
+    // Makes sure the first record carries its pc and cycle.
+    m_nextPC = 1;
+    m_recording = true;
+    return true;
+}
+
+void PCSX::CPUTraceRecorder::stop() {
+    if (!m_recording) return;
+    flush();
+    m_file->close();
+    m_file.reset();
+    m_recording = false;
+}
+
+void PCSX::CPUTraceRecorder::flush() {
+    m_file->write(m_buffer.get(), m_used);
+    m_used = 0;
+}
+
+void PCSX::CPUTraceRecorder::begin(psxRegisters& regs, uint32_t pc, uint32_t code) {
+    m_flags = pc == m_nextPC ? 0 : CPUTrace::NewPC;
+    m_pc = pc;
+    m_code = code;
+    m_cycle = regs.cycle;
+
+    Mips::Decoder::Instruction instruction(code);
+    switch (instruction.mnemonic()) {
+        case Mips::Decoder::Instruction::LB:
+        case Mips::Decoder::Instruction::LBU:
+            m_read.size = 1;
+            break;
+        case Mips::Decoder::Instruction::LH:
+        case Mips::Decoder::Instruction::LHU:
+            m_read.size = 2;
+            break;
+        case Mips::Decoder::Instruction::LW:
+        case Mips::Decoder::Instruction::LWL:
+        case Mips::Decoder::Instruction::LWR:
+        case Mips::Decoder::Instruction::LWC2:
+            m_read.size = 4;
+            break;
+        case Mips::Decoder::Instruction::SB:
+            m_write.size = 1;
+            break;
+        case Mips::Decoder::Instruction::SH:
+            m_write.size = 2;
+            break;
+        case Mips::Decoder::Instruction::SW:
+        case Mips::Decoder::Instruction::SWL:
+        case Mips::Decoder::Instruction::SWR:
+        case Mips::Decoder::Instruction::SWC2:
+            m_write.size = 4;
+            break;
+        default:
+            return;
+    }
+    if (instruction.isLoad()) {
+        m_flags |= CPUTrace::MemoryRead;
+        m_read.address = instruction.getLoadAddress(regs.GPR);
+    } else {
+        m_flags |= CPUTrace::MemoryWrite;
+        m_write.address = instruction.getStoreAddress(regs.GPR);
+        m_write.value = instruction.getValueToStore(regs.GPR, regs.CP2D.r) & instruction.getStoreMask(regs.GPR);
+    }
+}
+
+void PCSX::CPUTraceRecorder::end(const psxRegisters& regs) {
+    uint8_t changed[34];
+    unsigned count = 0;
+    for (unsigned i = 0; i < 34; i++) {
+        if (regs.GPR.r[i] == m_registers[i]) continue;
+        m_registers[i] = regs.GPR.r[i];
+        changed[count++] = i;
+    }
+    if (count != 0) m_flags |= CPUTrace::Registers;
+
+    put8(m_flags);
+    if (m_flags & CPUTrace::NewPC) {
+        put32(m_pc);
+        put64(m_cycle);
+    }
+    put32(m_code);
+    if (count != 0) {
+        put8(count);
+        for (unsigned i = 0; i < count; i++) {
+            put8(changed[i]);
+            put32(m_registers[changed[i]]);
+        }
+    }
+    if (m_flags & CPUTrace::MemoryRead) {
+        put32(m_read.address);
+        put8(m_read.size);
+    }
+    if (m_flags & CPUTrace::MemoryWrite) {
+        put32(m_write.address);
+        put8(m_write.size);
+        put32(m_write.value);
+    }
+    m_nextPC = m_pc + 4;
+    m_recordCount++;
+    if (m_used > c_bufferSize - c_maxRecordSize) flush();
+}
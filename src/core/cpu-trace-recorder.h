@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <memory>
+
+#include "support/file.h"
+#include "supportpsx/cpu-trace.h"
+
+namespace PCSX {
+
+struct psxRegisters;
+
+// Writes binary CPU traces, in the format described in supportpsx/cpu-trace.h. The interpreter feeds it from its
+// trace path, while it's recording. Records are encoded into a local buffer, then compressed a chunk at a time.
+class CPUTraceRecorder {
+  public:
+    ~CPUTraceRecorder() { stop(); }
+    bool start(const std::filesystem::path& path);
+    void stop();
+    bool recording() const { return m_recording; }
+    uint64_t recordCount() const { return m_recordCount; }
+
+    // Called before the instruction's handler runs, with pc and code being the instruction's.
+    void begin(psxRegisters& regs, uint32_t pc, uint32_t code);
+    // Called once the instruction, including its delayed load bookkeeping, is done.
+    void end(const psxRegisters& regs);
+
+  private:
+    void put8(uint8_t value) { m_buffer[m_used++] = value; }
+    void put32(uint32_t value) {
+        for (unsigned i = 0; i < 4; i++) put8(value >> (i * 8));
+    }
+    void put64(uint64_t value) {
+        put32(value);
+        put32(value >> 32);
+    }
+    void flush();
+
+    static constexpr size_t c_bufferSize = 65536;
+    static constexpr size_t c_maxRecordSize = 1 + 12 + 4 + 1 + 34 * 5 + 5 + 9;
+
+    IO<File> m_file;
+    std::unique_ptr<uint8_t[]> m_buffer;
+    size_t m_used = 0;
+    uint64_t m_recordCount = 0;
+    bool m_recording = false;
+
+    uint32_t m_registers[34];
+    uint32_t m_nextPC = 0;
+
+    uint8_t m_flags = 0;
+    uint32_t m_pc = 0;
+    uint32_t m_code = 0;
+    uint64_t m_cycle = 0;
+    CPUTrace::Access m_read;
+    CPUTrace::Access m_write;
+};
+
+}  // namespace PCSX
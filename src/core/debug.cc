@@ -172,42 +172,42 @@ void PCSX::Debug::process(uint32_t oldPC, uint32_t newPC, uint32_t oldCode, uint
     if (isAnyLoadOrStore) {
         if (isLWL || isLWR || isSWR || isSWL) offset &= ~3;
         if (isLB || isLBU) {
-            checkBP(offset, BreakpointType::Read, 1);
+            checkCop0BP(offset, BreakpointType::Read);
             if (m_breakmp_r8 && !isMapMarked(offset, MAP_R8)) {
                 triggerBP(nullptr, offset, 1, _("Read 8 map"));
             }
             if (m_mapping_r8) markMap(offset, MAP_R8);
         }
         if (isLH || isLHU) {
-            checkBP(offset, BreakpointType::Read, 2);
+            checkCop0BP(offset, BreakpointType::Read);
             if (m_breakmp_r16 && !isMapMarked(offset, MAP_R16)) {
                 triggerBP(nullptr, offset, 2, _("Read 16 map"));
             }
             if (m_mapping_r16) markMap(offset, MAP_R16);
         }
         if (isLW || isLWR || isLWL || isLWC2) {
-            checkBP(offset, BreakpointType::Read, 4);
+            checkCop0BP(offset, BreakpointType::Read);
             if (m_breakmp_r32 && !isMapMarked(offset, MAP_R32)) {
                 triggerBP(nullptr, offset, 4, _("Read 32 map"));
             }
             if (m_mapping_r32) markMap(offset, MAP_R32);
         }
         if (isSB) {
-            checkBP(offset, BreakpointType::Write, 1);
+            checkCop0BP(offset, BreakpointType::Write);
             if (m_breakmp_w8 && !isMapMarked(offset, MAP_W8)) {
                 triggerBP(nullptr, offset, 1, _("Write 8 map"));
             }
             if (m_mapping_w8) markMap(offset, MAP_W8);
         }
         if (isSH) {
-            checkBP(offset, BreakpointType::Write, 2);
+            checkCop0BP(offset, BreakpointType::Write);
             if (m_breakmp_w16 && !isMapMarked(offset, MAP_W16)) {
                 triggerBP(nullptr, offset, 2, _("Write 16 map"));
             }
             if (m_mapping_w16) markMap(offset, MAP_W16);
         }
         if (isSW || isSWR || isSWL || isSWC2) {
-            checkBP(offset, BreakpointType::Write, 4);
+            checkCop0BP(offset, BreakpointType::Write);
             if (m_breakmp_w32 && !isMapMarked(offset, MAP_W32)) {
                 triggerBP(nullptr, offset, 4, _("Write 32 map"));
             }
@@ -293,6 +293,44 @@ bool PCSX::Debug::triggerBP(Breakpoint* bp, uint32_t address, unsigned width, co
 }
 
 void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width, const char* cause) {
+    checkCop0BP(address, type);
+    runBreakpoints(address, type, width, cause);
+}
+
+bool PCSX::Debug::checkWatchpoint(uint32_t address, BreakpointType type, unsigned width) {
+    runBreakpoints(address, type, width, "");
+
+    const uint32_t page = normalizeAddress(address & ~0xe0000000) & ~0xffff;
+    auto end = m_breakpoints.end();
+    for (auto it = m_breakpoints.find(page, page | 0xffff); it != end; it++) {
+        if (it->type() == type) return true;
+    }
+    return false;
+}
+
+bool PCSX::Debug::hasExecBreakpoint(uint32_t address, uint32_t width) {
+    if (!m_filters[unsigned(BreakpointType::Exec)].test(address, address + width - 1)) return false;
+    const uint32_t normalizedAddress = normalizeAddress(address & ~0xe0000000);
+    auto end = m_breakpoints.end();
+    for (auto it = m_breakpoints.find(normalizedAddress, normalizedAddress + width - 1); it != end; it++) {
+        if (it->type() == BreakpointType::Exec) return true;
+    }
+    return false;
+}
+
+// Memory breakpoints get their pages watched, and execution breakpoints get the code compiled around them dropped,
+// so that the dynarec can put a trap in. Neither needs undoing when a breakpoint goes away: the next access or
+// trap to find nothing there takes care of it.
+void PCSX::Debug::installBreakpoint(const Breakpoint* bp) {
+    markFilter(bp);
+    if (bp->type() == BreakpointType::Exec) {
+        g_emulator->m_cpu->invalidateBreakpoint(bp->address());
+    } else {
+        g_emulator->m_mem->watchRange(bp->address(), bp->width(), bp->type() == BreakpointType::Write);
+    }
+}
+
+void PCSX::Debug::checkCop0BP(uint32_t address, BreakpointType type) {
     auto& cpu = g_emulator->m_cpu;
     auto& regs = cpu->m_regs;
 
@@ -315,6 +353,11 @@ void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width,
             }
         }
     }
+}
+
+void PCSX::Debug::runBreakpoints(uint32_t address, BreakpointType type, uint32_t width, const char* cause) {
+    auto& filter = m_filters[unsigned(type)];
+    if (!filter.test(address, address + width - 1)) return;
 
     auto end = m_breakpoints.end();
     uint32_t normalizedAddress = normalizeAddress(address & ~0xe0000000);
@@ -326,6 +369,18 @@ void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width,
         torun.push_back(bp);
     }
 
+    if (torun.empty()) {
+        // Stale bits, unless another breakpoint shares one of the words
+        const uint32_t low = normalizedAddress & ~3;
+        const uint32_t high = (normalizedAddress + width - 1) | 3;
+        bool shared = false;
+        for (auto it = m_breakpoints.find(low, high); it != end; it++) {
+            if (it->type() == type) shared = true;
+        }
+        if (!shared) filter.clear(address, address + width - 1);
+        return;
+    }
+
     while (!torun.empty()) {
         auto it = torun.begin();
         auto bp = &*it;
@@ -334,6 +389,62 @@ void PCSX::Debug::checkBP(uint32_t address, BreakpointType type, uint32_t width,
     }
 }
 
+void PCSX::Debug::markFilter(const Breakpoint* bp) {
+    auto& filter = m_filters[unsigned(bp->type())];
+    const uint32_t low = bp->address() & 0x1fffffff;
+    const uint32_t high = low + bp->width() - 1;
+    if (low < 0x00800000) {
+        for (uint32_t mirror = 0; mirror < 0x00800000; mirror += 0x00200000) {
+            const uint32_t base = (low & 0x001fffff) + mirror;
+            filter.mark(base, base + (high - low));
+        }
+    } else {
+        filter.mark(low, high);
+    }
+}
+
+void PCSX::Debug::rebuildFilters() {
+    for (auto& filter : m_filters) filter.reset();
+    for (auto& bp : m_breakpoints) markFilter(&bp);
+}
+
+void PCSX::Debug::BreakpointFilter::mark(uint32_t low, uint32_t high) {
+    for (uint32_t address = low & ~3; address <= high && address < 0x20000000; address += 4) {
+        auto& words = m_words[address >> 16];
+        if (!words) words = std::make_unique<Words>();
+        words->set((address & 0xffff) >> 2);
+    }
+}
+
+void PCSX::Debug::BreakpointFilter::clear(uint32_t low, uint32_t high) {
+    low &= 0x1fffffff;
+    high &= 0x1fffffff;
+    for (uint32_t address = low & ~3; address <= high; address += 4) {
+        auto& words = m_words[address >> 16];
+        if (!words) continue;
+        words->reset((address & 0xffff) >> 2);
+        if (words->none()) words.reset();
+    }
+}
+
+bool PCSX::Debug::BreakpointFilter::testRange(uint32_t low, uint32_t high) const {
+    if (high < low) return true;  // Wrapped around, let the tree sort it out
+    for (uint32_t address = low & ~3; address <= high;) {
+        const auto words = m_words[address >> 16].get();
+        if (!words) {
+            address = (address | 0xffff) + 1;
+            continue;
+        }
+        if (words->test((address & 0xffff) >> 2)) return true;
+        address += 4;
+    }
+    return false;
+}
+
+void PCSX::Debug::BreakpointFilter::reset() {
+    for (auto& words : m_words) words.reset();
+}
+
 std::string PCSX::Debug::generateFlowIDC() {
     std::stringstream ss;
     ss << "#include <idc.idc>\r\n\r\n";
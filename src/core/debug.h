@@ -19,7 +19,10 @@
 
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <functional>
+#include <memory>
 #include <string>
 
 #include "core/psxemulator.h"
@@ -48,8 +51,18 @@ class Debug {
         checkBP(address, BreakpointType::Write, len, cause.c_str());
     }
 
+    // Called by the memory handlers for accesses to watched pages. Returns false once there is no breakpoint
+    // of this type left in the page, so it can go back to running at full speed.
+    bool checkWatchpoint(uint32_t address, BreakpointType type, unsigned width);
+    // For CPU cores which look for execution breakpoints on their own, instead of going through process.
+    bool hasExecBreakpoint(uint32_t address, uint32_t width = 4);
+    void checkExecBreakpoint(uint32_t pc) { runBreakpoints(pc, BreakpointType::Exec, 4, ""); }
+
   private:
     void checkBP(uint32_t address, BreakpointType type, uint32_t width, const char* cause = "");
+    void checkCop0BP(uint32_t address, BreakpointType type);
+    void runBreakpoints(uint32_t address, BreakpointType type, uint32_t width, const char* cause);
+    void installBreakpoint(const Breakpoint* bp);
 
   public:
     // call this if PC is being set, like when the emulation is being reset, or when doing fastboot
@@ -146,7 +159,9 @@ class Debug {
         }) {
         uint32_t base = address & 0xe0000000;
         address &= ~0xe0000000;
-        return &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base));
+        auto bp = &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base));
+        installBreakpoint(bp);
+        return bp;
     }
     inline Breakpoint* addBreakpoint(
         uint32_t address, BreakpointType type, unsigned width, const std::string& source, std::string label,
@@ -156,23 +171,59 @@ class Debug {
         }) {
         uint32_t base = address & 0xe0000000;
         address &= ~0xe0000000;
-        return &*m_breakpoints.insert(address, address + width - 1, new Breakpoint(type, source, invoker, base, label));
+        auto bp = &*m_breakpoints.insert(address, address + width - 1,
+                                         new Breakpoint(type, source, invoker, base, label));
+        installBreakpoint(bp);
+        return bp;
     }
     const BreakpointTreeType& getTree() { return m_breakpoints; }
     const Breakpoint* lastBP() { return m_lastBP; }
     void removeBreakpoint(const Breakpoint* bp) {
         if (m_lastBP == bp) m_lastBP = nullptr;
         delete const_cast<Breakpoint*>(bp);
+        rebuildFilters();
     }
     void removeAllBreakpoints() {
         m_breakpoints.clear();
         m_lastBP = nullptr;
+        rebuildFilters();
     }
 
   private:
     bool triggerBP(Breakpoint* bp, uint32_t address, unsigned width, const char* reason = "");
     BreakpointTreeType m_breakpoints;
 
+    // Sits in front of m_breakpoints, with one for each breakpoint type: a bit per 64KB page holding any
+    // breakpoint, then a bit per word of these pages. Addresses are physical, and breakpoints in main RAM
+    // are marked in all of its mirrors, so that lookups don't need to normalize anything first. Bits can
+    // outlive their breakpoints when these get deleted behind our back; a lookup which finds nothing in
+    // the tree clears them.
+    class BreakpointFilter {
+      public:
+        void mark(uint32_t low, uint32_t high);
+        void clear(uint32_t low, uint32_t high);
+        bool test(uint32_t low, uint32_t high) const {
+            low &= 0x1fffffff;
+            high &= 0x1fffffff;
+            if (high - low < 4) {
+                const auto words = m_words[low >> 16].get();
+                if (words && words->test((low & 0xffff) >> 2)) return true;
+                const auto highWords = m_words[high >> 16].get();
+                return highWords && highWords->test((high & 0xffff) >> 2);
+            }
+            return testRange(low, high);
+        }
+        void reset();
+
+      private:
+        bool testRange(uint32_t low, uint32_t high) const;
+        typedef std::bitset<0x4000> Words;
+        std::array<std::unique_ptr<Words>, 0x2000> m_words;
+    };
+    std::array<BreakpointFilter, 3> m_filters;
+    void markFilter(const Breakpoint* bp);
+    void rebuildFilters();
+
     uint8_t m_mainMemoryMap[0x00800000] = {0};
     uint8_t m_biosMemoryMap[0x00080000] = {0};
     uint8_t m_scratchPadMap[0x00000400] = {0};
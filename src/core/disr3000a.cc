@@ -19,10 +19,7 @@
 
 #include "core/disr3000a.h"
 
-#include <stdarg.h>
-
-#include "core/psxemulator.h"
-#include "core/r3000a.h"
+#include "fmt/format.h"
 
 // Names of registers
 const char *PCSX::Disasm::s_disRNameGPR[] = {
@@ -79,167 +76,6 @@ const char *PCSX::Disasm::s_disRNameCP0[] = {
 #define _Branch_ (pc + 4 + ((short)_Im_ * 4))
 #define _OfB_ _Im_, _nRs_
 
-namespace {
-struct StringDisasm : public PCSX::Disasm {
-    const uint8_t *ptr(uint32_t addr) {
-        auto ptr = static_cast<const uint8_t *>(PCSX::g_emulator->m_mem->pointerRead(addr));
-        if (ptr != nullptr) {
-            return ptr;
-        } else {
-            static uint8_t dummy[4] = {0, 0, 0, 0};
-            return dummy;
-        }
-    }
-    uint8_t mem8(uint32_t addr) { return *ptr(addr); }
-    uint16_t mem16(uint32_t addr) { return SWAP_LE16(*(int16_t *)ptr(addr)); }
-    uint32_t mem32(uint32_t addr) { return SWAP_LE32(*(int32_t *)ptr(addr)); }
-    void append(const char *str, ...) {
-        va_list va;
-        va_start(va, str);
-        char buf[64];
-        std::vsnprintf(buf, 64, str, va);
-        va_end(va);
-        size_t len = strlen(buf);
-        memcpy(m_buf + m_len, buf, len + 1);
-        m_len += len;
-    }
-    void comma() {
-        if (m_gotArg) append(", ");
-        m_gotArg = true;
-    }
-    virtual void Invalid() final { strcpy(m_buf, "*** Bad OP ***"); }
-    virtual void OpCode(std::string_view name) final {
-        std::sprintf(m_buf, "%-7s", name.data());
-        m_gotArg = false;
-        m_len = 7;
-    }
-    virtual void GPR(uint8_t reg) final {
-        comma();
-        append("$");
-        append(s_disRNameGPR[reg]);
-        if (m_withValues) {
-            append("(%08x)", PCSX::g_emulator->m_cpu->m_regs.GPR.r[reg]);
-        }
-    }
-    virtual void CP0(uint8_t reg) final {
-        comma();
-        append("$");
-        append(s_disRNameCP0[reg]);
-        if (m_withValues) {
-            append("(%08x)", PCSX::g_emulator->m_cpu->m_regs.CP0.r[reg]);
-        }
-    }
-    virtual void CP2D(uint8_t reg) final {
-        comma();
-        append("$");
-        append(s_disRNameCP2D[reg]);
-        if (m_withValues) {
-            append("(%08x)", PCSX::g_emulator->m_cpu->m_regs.CP2D.r[reg]);
-        }
-    }
-    virtual void CP2C(uint8_t reg) final {
-        comma();
-        append("$");
-        append(s_disRNameCP2C[reg]);
-        if (m_withValues) {
-            append("(%08x)", PCSX::g_emulator->m_cpu->m_regs.CP2C.r[reg]);
-        }
-    }
-    virtual void HI() final {
-        comma();
-        append("$hi");
-        if (m_withValues) {
-            append("(%08x)", PCSX::g_emulator->m_cpu->m_regs.GPR.n.hi);
-        }
-    }
-    virtual void LO() final {
-        comma();
-        append("$lo");
-        if (m_withValues) {
-            append("(%08x)", PCSX::g_emulator->m_cpu->m_regs.GPR.n.lo);
-        }
-    }
-    virtual void Imm16(int16_t value) final {
-        comma();
-        if (value < 0) {
-            append("-0x%4.4x", -value);
-        } else {
-            append("0x%4.4x", value);
-        }
-    }
-    virtual void Imm16u(uint16_t value) final {
-        comma();
-        append("0x%4.4x", value);
-    }
-    virtual void Imm32(uint32_t value) final {
-        comma();
-        append("0x%8.8x", value);
-    }
-    virtual void Target(uint32_t value) final {
-        comma();
-        append("0x%8.8x", value);
-    }
-    virtual void Sa(uint8_t value) final {
-        comma();
-        append("0x%2.2x", value);
-    }
-    virtual void OfB(int16_t offset, uint8_t reg, int size) {
-        comma();
-        if (offset < 0) {
-            append("-0x%4.4x(%s)", -offset, s_disRNameGPR[reg]);
-        } else {
-            append("0x%4.4x(%s)", offset, s_disRNameGPR[reg]);
-        }
-        if (m_withValues) {
-            uint32_t addr = PCSX::g_emulator->m_cpu->m_regs.GPR.r[reg] + offset;
-            switch (size) {
-                case 1:
-                    append("([%8.8x] = %2.2x)", addr, mem8(addr));
-                    break;
-                case 2:
-                    append("([%8.8x] = %4.4x)", addr, mem16(addr));
-                    break;
-                case 4:
-                    append("([%8.8x] = %8.8x)", addr, mem32(addr));
-                    break;
-            }
-        }
-    }
-    virtual void BranchDest(uint32_t value) final {
-        comma();
-        append("0x%8.8x", value);
-    }
-    virtual void Offset(uint32_t addr, int size) final {
-        comma();
-        append("0x%8.8x", addr);
-        if (m_withValues) {
-            switch (size) {
-                case 1:
-                    append("([%8.8x] = %2.2x)", addr, mem8(addr));
-                    break;
-                case 2:
-                    append("([%8.8x] = %4.4x)", addr, mem16(addr));
-                    break;
-                case 4:
-                    append("([%8.8x] = %8.8x)", addr, mem32(addr));
-                    break;
-            }
-        }
-    }
-    virtual void reset() final {
-        m_buf[0] = 0;
-        m_len = 0;
-    }
-    char m_buf[512];
-    size_t m_len = 0;
-    bool m_gotArg = false;
-    bool m_withValues = false;
-
-  public:
-    std::string get() { return m_buf; }
-    void setValues(bool withValues) { m_withValues = withValues; }
-};
-}  // namespace
 
 #define dOpCodeGTE(i)                                                                                        \
     do {                                                                                                     \
@@ -1096,14 +932,3 @@ const PCSX::Disasm::TdisR3000AF PCSX::Disasm::s_disR3000A[] = {
     &Disasm::disNULL,    &Disasm::disNULL,  &Disasm::disSWC2, &Disasm::disNULL,   // 38
     &Disasm::disNULL,    &Disasm::disNULL,  &Disasm::disNULL, &Disasm::disNULL,   // 3c
 };
-
-std::string PCSX::Disasm::asString(uint32_t code, uint32_t nextCode, uint32_t pc, bool *skipNext, bool withValues) {
-    StringDisasm strd;
-    strd.setValues(withValues);
-    strd.process(code, nextCode, pc, skipNext);
-    char buf[64];
-    snprintf(buf, 64, "%8.8x %8.8x: ", pc, code);
-    std::string ret = buf + strd.get();
-    strd.reset();
-    return ret;
-}
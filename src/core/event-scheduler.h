@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <limits>
+
+namespace PCSX {
+
+// Pending events, identified by a small integer, and ordered by the cycle they're due at. This is an indexed binary
+// min-heap, so the earliest deadline is always available at the top, and scheduling, moving, or cancelling an event
+// only costs a few swaps. There are only a handful of event sources, so everything is fixed size.
+template <unsigned Size>
+class EventScheduler {
+    static_assert(Size < 0xff, "Event ids need to fit in a byte");
+
+  public:
+    EventScheduler() { clear(); }
+
+    void clear() {
+        m_count = 0;
+        for (auto& position : m_positions) position = c_none;
+    }
+    bool empty() const { return m_count == 0; }
+    bool pending(unsigned id) const { return m_positions[id] != c_none; }
+    uint64_t nextTarget() const { return m_count == 0 ? std::numeric_limits<uint64_t>::max() : m_targets[m_heap[0]]; }
+    // The earliest cycle at which something needs doing, when the root counters are next due at "counterTarget".
+    // Events fire once the cycle counter went strictly past their target.
+    uint64_t nextEventCycle(uint64_t counterTarget) const {
+        if ((m_count == 0) || (nextTarget() >= counterTarget)) return counterTarget;
+        return nextTarget() + 1;
+    }
+
+    // Adds the event, or moves it if it was already pending.
+    void schedule(unsigned id, uint64_t target) {
+        unsigned position = m_positions[id];
+        const uint64_t previous = m_targets[id];
+        m_targets[id] = target;
+        if (position == c_none) {
+            position = m_count++;
+            m_heap[position] = id;
+            m_positions[id] = position;
+            siftUp(position);
+        } else if (target < previous) {
+            siftUp(position);
+        } else {
+            siftDown(position);
+        }
+    }
+    void cancel(unsigned id) {
+        const unsigned position = m_positions[id];
+        if (position == c_none) return;
+        m_positions[id] = c_none;
+        const unsigned last = m_heap[--m_count];
+        if (position == m_count) return;
+        m_heap[position] = last;
+        m_positions[last] = position;
+        siftUp(position);
+        siftDown(m_positions[last]);
+    }
+    // Removes the earliest event, and returns its id. The scheduler must not be empty.
+    unsigned pop() {
+        const unsigned id = m_heap[0];
+        cancel(id);
+        return id;
+    }
+
+  private:
+    static constexpr uint8_t c_none = 0xff;
+
+    bool before(unsigned a, unsigned b) const { return m_targets[m_heap[a]] < m_targets[m_heap[b]]; }
+    void swap(unsigned a, unsigned b) {
+        const uint8_t id = m_heap[a];
+        m_heap[a] = m_heap[b];
+        m_heap[b] = id;
+        m_positions[m_heap[a]] = a;
+        m_positions[m_heap[b]] = b;
+    }
+    void siftUp(unsigned position) {
+        while (position != 0) {
+            const unsigned parent = (position - 1) / 2;
+            if (!before(position, parent)) break;
+            swap(position, parent);
+            position = parent;
+        }
+    }
+    void siftDown(unsigned position) {
+        while (true) {
+            const unsigned left = position * 2 + 1;
+            const unsigned right = left + 1;
+            unsigned smallest = position;
+            if ((left < m_count) && before(left, smallest)) smallest = left;
+            if ((right < m_count) && before(right, smallest)) smallest = right;
+            if (smallest == position) break;
+            swap(position, smallest);
+            position = smallest;
+        }
+    }
+
+    uint64_t m_targets[Size] = {};
+    uint8_t m_heap[Size] = {};
+    uint8_t m_positions[Size];
+    unsigned m_count = 0;
+};
+
+}  // namespace PCSX
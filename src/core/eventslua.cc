@@ -46,6 +46,17 @@ void pushEvent(PCSX::Lua L, const PCSX::Events::ExecutionFlow::Reset& e) {
     L.settable();
 }
 
+template <>
+void pushEvent(PCSX::Lua L, const PCSX::Events::ExecutionFlow::SaveStateWritten& e) {
+    L.newtable();
+    L.push("filename");
+    L.push(e.filename);
+    L.settable();
+    L.push("success");
+    L.push(e.success);
+    L.settable();
+}
+
 template <>
 void pushEvent(PCSX::Lua L, const PCSX::Events::GUI::JumpToPC& e) {
     L.newtable();
@@ -197,6 +208,8 @@ void PCSX::LuaBindings::open_events(Lua L) {
                 createListener<Events::ExecutionFlow::Reset>(L);
             } else if (name == "ExecutionFlow::SaveStateLoaded") {
                 createListener<Events::ExecutionFlow::SaveStateLoaded>(L);
+            } else if (name == "ExecutionFlow::SaveStateWritten") {
+                createListener<Events::ExecutionFlow::SaveStateWritten>(L);
             } else if (name == "GUI::JumpToPC") {
                 createListener<Events::GUI::JumpToPC>(L);
             } else if (name == "GUI::JumpToMemory") {
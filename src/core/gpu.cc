@@ -95,6 +95,7 @@ void GPU::Poly<shading, shape, textured, blend, modulation>::processWrite(Buffer
     offset = m_gpu->m_lastOffset;
     m_gpu->m_defaultProcessor.setActive();
     g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+    m_gpu->markDrawingAreaDirty();
     m_gpu->write0(this);
 }
 
@@ -153,6 +154,7 @@ void GPU::Line<shading, lineType, blend>::processWrite(Buffer & buf, Logged::Ori
     m_gpu->m_defaultProcessor.setActive();
     if ((colors.size() >= 2) && ((colors.size() == x.size()))) {
         g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+        m_gpu->markDrawingAreaDirty();
         m_gpu->write0(this);
     } else {
         g_system->log(LogClass::GPU, "Got an invalid line command...\n");
@@ -221,6 +223,7 @@ void GPU::Rect<size, textured, blend, modulation>::processWrite(Buffer & buf, Lo
     offset = m_gpu->m_lastOffset;
     m_gpu->m_defaultProcessor.setActive();
     g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+    m_gpu->markDrawingAreaDirty();
     m_gpu->write0(this);
 }
 // clang-format on
@@ -416,6 +419,8 @@ int PCSX::GPU::init(UI *ui) {
     m_drawingEndRaw = 0;
     m_drawingOffsetRaw = 0;
     m_dataRet = 0x400;
+    markAllVRAMDirty();
+    resetDrawingArea();
     return initBackend(ui);
 }
 
@@ -513,7 +518,7 @@ void PCSX::GPU::dma(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // GPU
             // BA blocks * BS words (word = 32-bits)
             size = (bcr >> 16) * (bcr & 0xffff);
             directDMARead(ptr, size, madr);
-            g_emulator->m_cpu->Clear(madr, size);
+            g_emulator->m_mem->markDirty(ptr, size * 4);
             if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
                 g_emulator->m_debug->checkDMAwrite(2, madr, size * 4);
             }
@@ -575,6 +580,25 @@ void PCSX::GPU::dma(uint32_t madr, uint32_t bcr, uint32_t chcr) {  // GPU
     gpuInterrupt();
 }
 
+void PCSX::GPU::markVRAMDirty(int y, int h) {
+    if (h <= 0) return;
+    if (h >= 512) {
+        markAllVRAMDirty();
+        return;
+    }
+    // Two lines per page, wrapping around the bottom of VRAM like the transfers do.
+    const unsigned first = (y & 511) >> 1;
+    const unsigned last = ((y & 511) + h - 1) >> 1;
+    for (unsigned page = first; page <= last; page++) m_vramDirtyPages[page % c_vramDirtyPageCount] = 1;
+}
+
+void PCSX::GPU::markDrawingAreaDirty() {
+    if (m_drawingAreaMarked) return;
+    m_drawingAreaMarked = true;
+    if (m_drawingAreaBottom < m_drawingAreaTop) return;
+    markVRAMDirty(m_drawingAreaTop, m_drawingAreaBottom - m_drawingAreaTop + 1);
+}
+
 void PCSX::GPU::gpuInterrupt() {
     auto &mem = g_emulator->m_mem;
     mem->clearDMABusy<2>();
@@ -600,6 +624,7 @@ void PCSX::GPU::writeStatus(uint32_t value) {
             m_drawingEndRaw = 0;
             m_drawingOffsetRaw = 0;
             m_dataRet = 0x400;
+            resetDrawingArea();
         } break;
         case 1: {
             CtrlClearFifo ctrl;
@@ -830,12 +855,16 @@ void PCSX::GPU::Command::processWrite(Buffer &buf, Logged::Origin origin, uint32
                         g_emulator->m_gpuLogger->addNode(prim, origin, originValue, length);
                         m_gpu->write0(&prim);
                         m_gpu->m_drawingStartRaw = packetInfo & 0xfffff;
+                        m_gpu->m_drawingAreaTop = prim.y;
+                        m_gpu->m_drawingAreaMarked = false;
                     } break;
                     case 4: {  // drawing area bottom right
                         DrawingAreaEnd prim(packetInfo);
                         g_emulator->m_gpuLogger->addNode(prim, origin, originValue, length);
                         m_gpu->write0(&prim);
                         m_gpu->m_drawingEndRaw = packetInfo & 0xfffff;
+                        m_gpu->m_drawingAreaBottom = prim.y;
+                        m_gpu->m_drawingAreaMarked = false;
                     } break;
                     case 5: {  // drawing offset
                         DrawingOffset prim(packetInfo);
@@ -889,6 +918,7 @@ void PCSX::GPU::FastFill::processWrite(Buffer &buf, Logged::Origin origin, uint3
             m_state = READ_COLOR;
             m_gpu->m_defaultProcessor.setActive();
             g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+            m_gpu->markVRAMDirty(y, h);
             m_gpu->write0(this);
             return;
     }
@@ -930,6 +960,7 @@ void PCSX::GPU::BlitVramVram::processWrite(Buffer &buf, Logged::Origin origin, u
             m_state = READ_COMMAND;
             m_gpu->m_defaultProcessor.setActive();
             g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+            m_gpu->markVRAMDirty(dY, h);
             m_gpu->write0(this);
             return;
     }
@@ -987,6 +1018,7 @@ void PCSX::GPU::BlitRamVram::processWrite(Buffer &buf, Logged::Origin origin, ui
         m_state = READ_COMMAND;
         m_gpu->m_defaultProcessor.setActive();
         g_emulator->m_gpuLogger->addNode(*this, origin, origvalue, length);
+        m_gpu->markVRAMDirty(y, h);
         m_gpu->partialUpdateVRAM(x, y, w, h, data.data<uint16_t>(), PartialUpdateVram::Synchronous);
     }
 }
@@ -105,6 +105,8 @@ class GPU {
     virtual void setDither(int setting) = 0;
     void reset() {
         resetBackend();
+        markAllVRAMDirty();
+        resetDrawingArea();
         m_dataRet = 0;
         m_readFifo->reset();
         m_processor->reset();
@@ -124,6 +126,18 @@ class GPU {
     virtual void partialUpdateVRAM(int x, int y, int w, int h, const uint16_t *pixels,
                                    PartialUpdateVram = PartialUpdateVram::Asynchronous) = 0;
 
+    // VRAM is tracked in 4KB pages, that is pairs of lines, flagged by every command which may write to them, so
+    // incremental save states only carry what changed. Primitives flag the whole drawing area they're clipped to,
+    // once until it moves. Anyone else writing to VRAM through partialUpdateVRAM has to flag the lines themselves.
+    static constexpr unsigned c_vramDirtyPageCount = 1024 * 512 * sizeof(uint16_t) / 4096;
+    void markVRAMDirty(int y, int h);
+    void markAllVRAMDirty() { memset(m_vramDirtyPages, 1, sizeof(m_vramDirtyPages)); }
+    void clearVRAMDirtyPages() {
+        memset(m_vramDirtyPages, 0, sizeof(m_vramDirtyPages));
+        m_drawingAreaMarked = false;
+    }
+    const uint8_t *getVRAMDirtyPages() const { return m_vramDirtyPages; }
+
     struct ScreenShot {
         Slice data;
         uint16_t width, height;
@@ -191,6 +205,19 @@ class GPU {
   private:
     uint32_t m_statusControl[256];
 
+    void markDrawingAreaDirty();
+    void resetDrawingArea() {
+        m_drawingAreaTop = 0;
+        m_drawingAreaBottom = 511;
+        m_drawingAreaMarked = false;
+    }
+    uint8_t m_vramDirtyPages[c_vramDirtyPageCount] = {};
+    // The lines primitives can draw to. It's all of VRAM until the game sets a drawing area, since the backends may
+    // not agree with us about it after a reset or a state load.
+    unsigned m_drawingAreaTop = 0;
+    unsigned m_drawingAreaBottom = 511;
+    bool m_drawingAreaMarked = false;
+
     class Buffer {
       public:
         Buffer(uint32_t value) : m_value(SWAP_LE32(value)) {
@@ -108,6 +108,9 @@ class GTE {
         return std::countl_zero<uint32_t>(value);
     }
 
+    // Reciprocal table used by the GTE's Unsigned Newton-Raphson division, shared with the dynarec
+    static const uint8_t c_unrTable[0x101];
+
     // Count leading zeroes of a 16-bit value. For an input of 0, 16 is returned
     static uint32_t countLeadingZeros16(uint16_t value) {
         // Use a 32-bit CLZ as it's what's most commonly available and Clang/GCC fail to optimize 16-bit CLZ
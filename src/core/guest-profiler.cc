@@ -0,0 +1,196 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/guest-profiler.h"
+
+#include <unordered_map>
+
+#include "core/callstacks.h"
+#include "core/psxemulator.h"
+#include "core/r3000a.h"
+#include "core/system.h"
+#include "fmt/format.h"
+#include "support/protobuf.h"
+
+PCSX::GuestProfiler::GuestProfiler() : m_listener(g_system->m_eventBus) {
+    // Resets and state loads move the cycle counter to wherever they please. Sampling starts over from there, instead
+    // of weighing the next sample by however far it jumped, or going quiet until it catches up.
+    auto resync = [this](auto&) {
+        if (running()) m_nextSample = g_emulator->m_cpu->m_regs.cycle + m_period;
+    };
+    m_listener.listen<Events::ExecutionFlow::Reset>(resync);
+    m_listener.listen<Events::ExecutionFlow::SaveStateLoaded>(resync);
+}
+
+void PCSX::GuestProfiler::start(uint32_t period, bool callStacks) {
+    m_period = period ? period : c_defaultPeriod;
+    m_callStacks = callStacks;
+    m_nextSample = g_emulator->m_cpu->m_regs.cycle + m_period;
+}
+
+void PCSX::GuestProfiler::sample(uint32_t pc, uint64_t cycle) {
+    // branchTest doesn't run on every cycle, so a late sample stands for all the periods that elapsed since the
+    // previous one, which keeps the weights right when long blocks or DMA stalls delay it.
+    uint64_t weight = (cycle - m_nextSample) / m_period + 1;
+    m_nextSample += weight * m_period;
+    m_sampleCount += weight;
+
+    std::vector<uint32_t> stack;
+    stack.push_back(pc);
+    if (m_callStacks && g_emulator->m_callStacks->hasCurrent()) {
+        auto& calls = g_emulator->m_callStacks->getCurrent().calls;
+        for (auto call = calls.end(); call != calls.begin();) {
+            if ((--call)->shadow) continue;
+            stack.push_back(call->ra);
+        }
+    }
+    m_samples[std::move(stack)] += weight;
+}
+
+namespace {
+
+std::string frameName(uint32_t address) {
+    auto symbol = PCSX::g_emulator->m_cpu->findContainingSymbol(address);
+    if (symbol) return symbol->second;
+    return fmt::format("{:08x}", address);
+}
+
+void putTag(PCSX::Protobuf::OutSlice* slice, unsigned field, unsigned wireType) {
+    slice->putVarInt((field << 3) | wireType);
+}
+
+void putVarIntField(PCSX::Protobuf::OutSlice* slice, unsigned field, uint64_t value) {
+    if (value == 0) return;
+    putTag(slice, field, 0);
+    slice->putVarInt(value);
+}
+
+void putBytesField(PCSX::Protobuf::OutSlice* slice, unsigned field, const std::string& bytes) {
+    putTag(slice, field, 2);
+    slice->putVarInt(bytes.size());
+    slice->putBytes(bytes);
+}
+
+void putMessageField(PCSX::Protobuf::OutSlice* slice, unsigned field, PCSX::Protobuf::OutSlice& message) {
+    putBytesField(slice, field, message.finalize());
+}
+
+}  // namespace
+
+std::string PCSX::GuestProfiler::folded() const {
+    std::map<std::string, uint64_t> lines;
+    for (auto& [stack, count] : m_samples) {
+        std::string line;
+        for (auto frame = stack.rbegin(); frame != stack.rend(); frame++) {
+            if (!line.empty()) line += ';';
+            line += frameName(*frame);
+        }
+        lines[std::move(line)] += count;
+    }
+
+    std::string ret;
+    for (auto& [line, count] : lines) ret += fmt::format("{} {}\n", line, count);
+    return ret;
+}
+
+std::string PCSX::GuestProfiler::pprof() const {
+    // Field numbers from pprof's profile.proto.
+    enum : unsigned {
+        SAMPLE_TYPE = 1,
+        SAMPLE = 2,
+        MAPPING = 3,
+        LOCATION = 4,
+        FUNCTION = 5,
+        STRING_TABLE = 6,
+        PERIOD_TYPE = 11,
+        PERIOD = 12,
+    };
+
+    std::vector<std::string> strings = {""};
+    std::unordered_map<std::string, uint64_t> stringIndices = {{"", 0}};
+    auto intern = [&](const std::string& str) -> uint64_t {
+        auto [it, inserted] = stringIndices.try_emplace(str, strings.size());
+        if (inserted) strings.push_back(str);
+        return it->second;
+    };
+
+    Protobuf::OutSlice profile;
+    auto putValueType = [&](unsigned field, const char* type, const char* unit) {
+        Protobuf::OutSlice valueType;
+        putVarIntField(&valueType, 1, intern(type));
+        putVarIntField(&valueType, 2, intern(unit));
+        putMessageField(&profile, field, valueType);
+    };
+    putValueType(SAMPLE_TYPE, "samples", "count");
+    putValueType(SAMPLE_TYPE, "cycles", "count");
+
+    // Ids have to be non-zero, so every table below starts numbering at 1.
+    std::map<uint32_t, uint64_t> locations;
+    std::map<std::string, uint64_t> functions;
+    for (auto& [stack, count] : m_samples) {
+        Protobuf::OutSlice locationIds;
+        for (auto address : stack) {
+            auto [it, inserted] = locations.try_emplace(address, locations.size() + 1);
+            locationIds.putVarInt(it->second);
+        }
+        Protobuf::OutSlice values;
+        values.putVarInt(count);
+        values.putVarInt(count * m_period);
+
+        Protobuf::OutSlice sample;
+        putMessageField(&sample, 1, locationIds);
+        putMessageField(&sample, 2, values);
+        putMessageField(&profile, SAMPLE, sample);
+    }
+
+    Protobuf::OutSlice mapping;
+    putVarIntField(&mapping, 1, 1);
+    putVarIntField(&mapping, 3, 0x100000000ULL);
+    putVarIntField(&mapping, 5, intern("psx"));
+    putMessageField(&profile, MAPPING, mapping);
+
+    for (auto& [address, id] : locations) {
+        auto name = frameName(address);
+        auto [function, inserted] = functions.try_emplace(name, functions.size() + 1);
+        Protobuf::OutSlice line;
+        putVarIntField(&line, 1, function->second);
+        Protobuf::OutSlice location;
+        putVarIntField(&location, 1, id);
+        putVarIntField(&location, 2, 1);
+        putVarIntField(&location, 3, address);
+        putMessageField(&location, 4, line);
+        putMessageField(&profile, LOCATION, location);
+    }
+
+    for (auto& [name, id] : functions) {
+        Protobuf::OutSlice function;
+        putVarIntField(&function, 1, id);
+        putVarIntField(&function, 2, intern(name));
+        putVarIntField(&function, 3, intern(name));
+        putMessageField(&profile, FUNCTION, function);
+    }
+
+    putValueType(PERIOD_TYPE, "cycles", "count");
+    putVarIntField(&profile, PERIOD, m_period);
+
+    // The string table has to come last, since everything above may still be adding to it.
+    for (auto& str : strings) putBytesField(&profile, STRING_TABLE, str);
+
+    return profile.finalize();
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "support/eventbus.h"
+
+namespace PCSX {
+
+// Statistical profiler for guest code. Every "period" emulated cycles, branchTest hands it the current PC, along with
+// the guest call stack if asked to. Since sampling is driven by emulated time, both CPU cores produce comparable
+// profiles, and leaving it running costs a comparison per branchTest.
+class GuestProfiler {
+  public:
+    static constexpr uint32_t c_defaultPeriod = 33868;  // About a thousand samples per emulated second
+
+    GuestProfiler();
+    void start(uint32_t period = c_defaultPeriod, bool callStacks = false);
+    void stop() { m_nextSample = std::numeric_limits<uint64_t>::max(); }
+    void reset() {
+        m_samples.clear();
+        m_sampleCount = 0;
+    }
+    bool running() const { return m_nextSample != std::numeric_limits<uint64_t>::max(); }
+    uint32_t period() const { return m_period; }
+    uint64_t sampleCount() const { return m_sampleCount; }
+
+    bool due(uint64_t cycle) const { return cycle >= m_nextSample; }
+    void sample(uint32_t pc, uint64_t cycle);
+
+    // One line per distinct stack, outermost frame first, as consumed by flamegraph.pl and friends
+    std::string folded() const;
+    // Uncompressed protobuf following pprof's profile.proto
+    std::string pprof() const;
+
+  private:
+    // Innermost frame first. Frames past the first one are return addresses.
+    std::map<std::vector<uint32_t>, uint64_t> m_samples;
+    uint64_t m_nextSample = std::numeric_limits<uint64_t>::max();
+    uint64_t m_sampleCount = 0;
+    uint32_t m_period = c_defaultPeriod;
+    bool m_callStacks = false;
+    EventBus::Listener m_listener;
+};
+
+}  // namespace PCSX
@@ -0,0 +1,329 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <iterator>
+
+#include "core/cdrom.h"
+#include "core/psxcounters.h"
+#include "core/psxemulator.h"
+#include "core/psxmem.h"
+#include "core/r3000a.h"
+
+// Idle loop skipping. Games spend a lot of their time spinning on a flag that only an interrupt handler or a DMA
+// completion is going to change, for instance waiting for VSync. Such a loop only reads memory, and every value it
+// computes is recomputed from scratch on each iteration, so as long as nothing else touches what it reads, it is
+// going to keep spinning until the next event fires. When one of those takes its back edge, we move the cycle
+// counter straight to that next event. The loop itself keeps running normally, so a misdetection can only cost
+// timing accuracy, never correctness.
+
+namespace {
+
+enum : unsigned { Invariant, Known, Unknown, Pending };
+
+struct RegState {
+    unsigned state;
+    uint32_t value;
+};
+
+// Loads only count as side-effect free if they come from memory that nothing but events can modify.
+// The root counters are excluded on purpose, since they tick on their own without an event firing.
+bool isIdleLoad(uint32_t address, unsigned size) {
+    if (address & (size - 1)) return false;  // Would raise an address error
+    const uint32_t physical = address & 0x1fffffff;
+    if (physical < 0x00800000) return true;                               // RAM and its mirrors
+    if ((physical >= 0x1f800000) && (physical < 0x1f800400)) return true;  // Scratchpad
+    if ((physical >= 0x1fc00000) && (physical < 0x1fc80000)) return true;  // BIOS
+    if ((physical == 0x1f801070) || (physical == 0x1f801074)) return true;  // ISTAT / IMASK
+    if ((physical >= 0x1f801080) && (physical < 0x1f801100)) return true;  // DMA
+    return false;
+}
+
+}  // namespace
+
+// Checks whether the loop made of [target, branchPC] plus the branch's delay slot is side-effect free, with the
+// current register values standing in for the ones the loop never writes.
+PCSX::R3000Acpu::IdleLoop PCSX::R3000Acpu::analyseIdleLoop(uint32_t branchPC, uint32_t target) {
+    if ((target > branchPC) || ((branchPC - target) > c_idleLoopMaxBytes)) return IdleLoop::NotIdle;
+    const unsigned count = (branchPC - target) / 4 + 2;
+    uint32_t codes[c_idleLoopMaxBytes / 4 + 2];
+    for (unsigned i = 0; i < count; i++) {
+        const uint32_t* ptr = g_emulator->m_mem->getPointer<uint32_t>(target + i * 4);
+        if (!ptr) return IdleLoop::NotIdle;
+        codes[i] = *ptr;
+    }
+
+    // The back edge itself: any non-linking branch that lands on the loop head.
+    const uint32_t branch = codes[count - 2];
+    const unsigned branchOp = branch >> 26;
+    bool validBranch = false;
+    if ((branchOp == 0x02) || ((branchOp >= 0x04) && (branchOp <= 0x07))) {  // J, BEQ, BNE, BLEZ, BGTZ
+        validBranch = true;
+    } else if (branchOp == 0x01) {  // BLTZ, BGEZ, but not their linking variants
+        validBranch = (_fRt_(branch) & 0x1e) != 0x10;
+    }
+    if (!validBranch) return IdleLoop::NotIdle;
+    const uint32_t branchTarget = (branchOp == 0x02) ? (((branchPC + 4) & 0xf0000000) | (_fTarget_(branch) << 2))
+                                                     : (branchPC + 4 + (_fImm_(branch) << 2));
+    if (branchTarget != target) return IdleLoop::NotIdle;
+
+    // First pass: decode, reject anything that isn't a load, a plain ALU operation, or the branch, and collect
+    // the registers the loop writes.
+    struct Decoded {
+        unsigned reads[2];
+        unsigned write;
+        unsigned loadSize;
+    };
+    Decoded decoded[c_idleLoopMaxBytes / 4 + 2];
+    uint32_t written = 0;
+    for (unsigned i = 0; i < count; i++) {
+        const uint32_t code = codes[i];
+        const unsigned op = code >> 26;
+        auto& d = decoded[i];
+        d = {{0, 0}, 0, 0};
+        if (i == count - 2) {
+            if (op != 0x02) d.reads[0] = _fRs_(code);
+            if ((op == 0x04) || (op == 0x05)) d.reads[1] = _fRt_(code);
+            continue;
+        }
+        switch (op) {
+            case 0x00:
+                switch (_fFunct_(code)) {
+                    case 0x00:  // SLL
+                    case 0x02:  // SRL
+                    case 0x03:  // SRA
+                        d.reads[0] = _fRt_(code);
+                        break;
+                    case 0x04:  // SLLV
+                    case 0x06:  // SRLV
+                    case 0x07:  // SRAV
+                    case 0x21:  // ADDU
+                    case 0x23:  // SUBU
+                    case 0x24:  // AND
+                    case 0x25:  // OR
+                    case 0x26:  // XOR
+                    case 0x27:  // NOR
+                    case 0x2a:  // SLT
+                    case 0x2b:  // SLTU
+                        d.reads[0] = _fRs_(code);
+                        d.reads[1] = _fRt_(code);
+                        break;
+                    default:
+                        return IdleLoop::NotIdle;
+                }
+                d.write = _fRd_(code);
+                break;
+            case 0x0f:  // LUI
+                d.write = _fRt_(code);
+                break;
+            case 0x09:  // ADDIU
+            case 0x0a:  // SLTI
+            case 0x0b:  // SLTIU
+            case 0x0c:  // ANDI
+            case 0x0d:  // ORI
+            case 0x0e:  // XORI
+                d.reads[0] = _fRs_(code);
+                d.write = _fRt_(code);
+                break;
+            case 0x20:  // LB
+            case 0x24:  // LBU
+                d.loadSize = 1;
+                [[fallthrough]];
+            case 0x21:  // LH
+            case 0x25:  // LHU
+                if (!d.loadSize) d.loadSize = 2;
+                [[fallthrough]];
+            case 0x23:  // LW
+                if (!d.loadSize) d.loadSize = 4;
+                d.reads[0] = _fRs_(code);
+                d.write = _fRt_(code);
+                break;
+            default:
+                return IdleLoop::NotIdle;
+        }
+        written |= 1 << d.write;
+    }
+    written &= ~1;
+
+    // Second pass: walk the loop in execution order. The branch reads its operands before its delay slot runs.
+    // Reading a register the loop writes before it got written this iteration means state carried over from the
+    // previous iteration, such as a counter, which isn't idle. Addresses of loads get computed whenever possible.
+    RegState regs[32];
+    for (unsigned r = 0; r < 32; r++) {
+        regs[r] = (written & (1 << r)) ? RegState{Pending, 0} : RegState{Invariant, m_regs.GPR.r[r]};
+    }
+    regs[0] = {Known, 0};
+    bool unsafeLoad = false;
+    unsigned delayedLoad = 0;
+    for (unsigned i = 0; i < count; i++) {
+        const uint32_t code = codes[i];
+        const auto& d = decoded[i];
+        for (auto r : d.reads) {
+            if (regs[r].state == Pending) return IdleLoop::NotIdle;
+            if (delayedLoad && (r == delayedLoad)) return IdleLoop::NotIdle;  // Depends on the load delay slot
+        }
+        if (delayedLoad && (d.write == delayedLoad)) return IdleLoop::NotIdle;
+        if (delayedLoad) {
+            regs[delayedLoad] = {Unknown, 0};
+            delayedLoad = 0;
+        }
+        const auto& rs = regs[_fRs_(code)];
+        const auto& rt = regs[_fRt_(code)];
+        const bool known = (rs.state != Unknown) && (rt.state != Unknown);
+        if (d.loadSize) {
+            if (rs.state == Unknown) {
+                unsafeLoad = true;
+            } else if (!isIdleLoad(rs.value + _fImm_(code), d.loadSize)) {
+                return IdleLoop::UnsafeLoad;
+            }
+            delayedLoad = d.write;
+            continue;
+        }
+        if (d.write == 0) continue;
+        uint32_t value = 0;
+        bool computed = known;
+        switch (code >> 26) {
+            case 0x00: {
+                const unsigned sa = _fSa_(code);
+                switch (_fFunct_(code)) {
+                    case 0x00:
+                        value = rt.value << sa;
+                        break;
+                    case 0x02:
+                        value = rt.value >> sa;
+                        break;
+                    case 0x03:
+                        value = int32_t(rt.value) >> sa;
+                        break;
+                    case 0x04:
+                        value = rt.value << (rs.value & 31);
+                        break;
+                    case 0x06:
+                        value = rt.value >> (rs.value & 31);
+                        break;
+                    case 0x07:
+                        value = int32_t(rt.value) >> (rs.value & 31);
+                        break;
+                    case 0x21:
+                        value = rs.value + rt.value;
+                        break;
+                    case 0x23:
+                        value = rs.value - rt.value;
+                        break;
+                    case 0x24:
+                        value = rs.value & rt.value;
+                        break;
+                    case 0x25:
+                        value = rs.value | rt.value;
+                        break;
+                    case 0x26:
+                        value = rs.value ^ rt.value;
+                        break;
+                    case 0x27:
+                        value = ~(rs.value | rt.value);
+                        break;
+                    case 0x2a:
+                        value = int32_t(rs.value) < int32_t(rt.value);
+                        break;
+                    case 0x2b:
+                        value = rs.value < rt.value;
+                        break;
+                }
+                break;
+            }
+            case 0x0f:
+                value = _fImmLU_(code);
+                computed = true;
+                break;
+            case 0x09:
+                value = rs.value + _fImm_(code);
+                computed = rs.state != Unknown;
+                break;
+            case 0x0a:
+                value = int32_t(rs.value) < _fImm_(code);
+                computed = rs.state != Unknown;
+                break;
+            case 0x0b:
+                value = rs.value < uint32_t(int32_t(_fImm_(code)));
+                computed = rs.state != Unknown;
+                break;
+            case 0x0c:
+                value = rs.value & _fImmU_(code);
+                computed = rs.state != Unknown;
+                break;
+            case 0x0d:
+                value = rs.value | _fImmU_(code);
+                computed = rs.state != Unknown;
+                break;
+            case 0x0e:
+                value = rs.value ^ _fImmU_(code);
+                computed = rs.state != Unknown;
+                break;
+        }
+        regs[d.write] = computed ? RegState{Known, value} : RegState{Unknown, 0};
+    }
+
+    // A load whose address depends on memory could be reading anything, so leave it to the next back edge.
+    return unsafeLoad ? IdleLoop::UnsafeLoad : IdleLoop::Idle;
+}
+
+bool PCSX::R3000Acpu::idleSkipAllowed() {
+    if (!g_emulator->settings.get<Emulator::SettingIdleSkip>()) return false;
+    auto& disabled = g_emulator->settings.get<Emulator::SettingIdleSkipDisabledGames>().value;
+    if (disabled.empty()) return true;
+    const auto& id = g_emulator->m_cdrom->getCDRomID();
+    return std::find(disabled.begin(), disabled.end(), id) == disabled.end();
+}
+
+// Called whenever a branch at "branchPC" just went backwards to m_regs.pc, right before branchTest runs.
+void PCSX::R3000Acpu::idleLoopBackEdge(uint32_t branchPC) {
+    const uint32_t target = m_regs.pc;
+    auto& memory = g_emulator->m_mem;
+    const uint32_t* branch = memory->getPointer<uint32_t>(branchPC);
+    const uint32_t* head = memory->getPointer<uint32_t>(target);
+    if (!branch || !head) return;
+
+    // Most short loops aren't idle, and they will come back here on every iteration, so remember them. The branch
+    // and the loop head are enough to notice the code got replaced.
+    auto& notIdle = m_notIdleLoops[(branchPC >> 2) % std::size(m_notIdleLoops)];
+    if ((notIdle.branchPC == branchPC) && (notIdle.branchCode == *branch) && (notIdle.headCode == *head)) return;
+
+    switch (analyseIdleLoop(branchPC, target)) {
+        case IdleLoop::NotIdle:
+            notIdle = {branchPC, *branch, *head};
+            return;
+        case IdleLoop::UnsafeLoad:
+            return;
+        case IdleLoop::Idle:
+            break;
+    }
+    if (!idleSkipAllowed()) return;
+
+    // Pending interrupts are going to be serviced by the upcoming branchTest, so there's nothing to skip to.
+    if (m_regs.spuInterrupt.load()) return;
+    if (memory->readHardwareRegister<Memory::ISTAT>() & memory->readHardwareRegister<Memory::IMASK>()) return;
+
+    const uint64_t cycle = m_regs.cycle;
+    const uint64_t next = m_regs.nextEventCycle;
+    if (next <= cycle) return;
+
+    m_regs.cycle = next;
+    m_idleLoopsSkipped++;
+    m_idleCyclesSkipped += next - cycle;
+}
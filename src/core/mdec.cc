@@ -492,6 +492,7 @@ void PCSX::MDEC::dma1(uint32_t adr, uint32_t bcr, uint32_t chcr) {
         /* do not free the dma */
     } else {
         image = g_emulator->m_mem->getPointer<uint8_t>(adr);
+        g_emulator->m_mem->markDirty(image, size);
 
         if (mdec.reg0 & MDEC0_RGB24) {
             /* 16 bits decoding
@@ -95,7 +95,7 @@ class MemoryCard {
     };
 
     friend class SIO;
-    friend SaveStates::SaveState SaveStates::constructSaveState();
+    friend SaveStates::SaveState SaveStates::constructSaveState(bool incremental);
 
     static constexpr size_t c_sectorSize = 8 * 16;
     static constexpr size_t c_blockSize = 8192;
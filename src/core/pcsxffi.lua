@@ -52,12 +52,15 @@ typedef struct { uint8_t opaque[?]; } Breakpoint;
 
 uint64_t getCPUCycles();
 uint8_t* getMemPtr();
+const uint8_t* getReadOnlyMemPtr();
 uint8_t* getParPtr();
 uint8_t* getRomPtr();
 uint8_t* getScratchPtr();
 psxRegisters* getRegisters();
 uint8_t** getReadLUT();
 uint8_t** getWriteLUT();
+uint8_t* getReadPages();
+uint8_t* getWritePages();
 Breakpoint* addBreakpoint(uint32_t address, enum BreakpointType type, unsigned width, const char* cause, bool (*invoker)(uint32_t address, unsigned width, const char* cause), const char* label);
 void enableBreakpoint(Breakpoint*);
 void disableBreakpoint(Breakpoint*);
@@ -72,6 +75,7 @@ void luaLog(const char* msg);
 void jumpToPC(uint32_t address);
 void jumpToMemory(uint32_t address, unsigned width);
 void invalidateCache();
+void resetCPUStatistics();
 
 typedef enum { BPP_16, BPP_24 } ScreenShotBPP;
 
@@ -84,12 +88,35 @@ typedef struct {
 LuaScreenShot takeScreenShot();
 
 LuaSlice* createSaveState();
+void writeSaveState(const char* filename);
 void loadSaveStateFromSlice(LuaSlice*);
 void loadSaveStateFromFile(LuaFile*);
 
 LuaFile* getMemoryAsFile();
 
 void quit(int code);
+
+void startGuestProfiler(uint32_t period, bool callStacks);
+void stopGuestProfiler();
+void resetGuestProfiler();
+bool guestProfilerRunning();
+uint64_t getGuestProfilerSampleCount();
+LuaSlice* getGuestProfile(bool pprof);
+
+bool startCPUTrace(const char* path);
+void stopCPUTrace();
+bool cpuTraceRecording();
+uint64_t getCPUTraceRecordCount();
+
+uint64_t getEmulatedFrames();
+double getEmulatedFPS();
+
+void captureRewindSnapshot();
+bool rewindEmulation(uint32_t steps);
+void clearRewindHistory();
+uint32_t getRewindSnapshotCount();
+uint64_t getRewindMemoryUsage();
+uint64_t getRewindCaptureTime();
 ]]
 
 local C = ffi.load 'PCSX'
@@ -160,6 +187,12 @@ local function printLike(callback, ...)
     callback(s)
 end
 
+local function getGuestProfile(format)
+    if format == nil then format = 'folded' end
+    if format ~= 'folded' and format ~= 'pprof' then error 'PCSX.Profiler.getProfile needs "folded" or "pprof"' end
+    return Support.File._createSliceWrapper(C.getGuestProfile(format == 'pprof'))
+end
+
 local function jumpToPC(pc)
     if type(pc) ~= 'number' then error 'PCSX.GUI.jumpToPC requires a numeric address' end
     C.jumpToPC(pc)
@@ -174,19 +207,25 @@ end
 
 PCSX = {
     getCPUCycles = function() return C.getCPUCycles() end,
+    getEmulatedFrames = function() return tonumber(C.getEmulatedFrames()) end,
+    getEmulatedFPS = function() return C.getEmulatedFPS() end,
     getMemPtr = function() return C.getMemPtr() end,
+    getReadOnlyMemPtr = function() return C.getReadOnlyMemPtr() end,
     getParPtr = function() return C.getParPtr() end,
     getRomPtr = function() return C.getRomPtr() end,
     getScratchPtr = function() return C.getScratchPtr() end,
     getRegisters = function() return C.getRegisters() end,
     getReadLUT = function() return C.getReadLUT() end,
     getWriteLUT = function() return C.getWriteLUT() end,
+    getReadPages = function() return C.getReadPages() end,
+    getWritePages = function() return C.getWritePages() end,
     addBreakpoint = addBreakpoint,
     pauseEmulator = function() C.pauseEmulator() end,
     resumeEmulator = function() C.resumeEmulator() end,
     softResetEmulator = function() C.softResetEmulator() end,
     hardResetEmulator = function() C.hardResetEmulator() end,
     invalidateCache = function() C.invalidateCache() end,
+    resetCPUStatistics = function() C.resetCPUStatistics() end,
     log = function(...) printLike(function(msg) C.luaLog(msg .. '\n') end, ...) end,
     GUI = { jumpToPC = jumpToPC, jumpToMemory = jumpToMemory },
     nextTick = function(f)
@@ -211,6 +250,10 @@ PCSX = {
         local slice = C.createSaveState()
         return Support.File._createSliceWrapper(slice)
     end,
+    writeSaveState = function(filename)
+        if type(filename) ~= 'string' then error('writeSaveState: requires a filename as input') end
+        C.writeSaveState(filename)
+    end,
     loadSaveState = function(obj)
         if type(obj) ~= 'table' then error('loadSaveState: requires an object as input') end
         if obj._type == 'Slice' then
@@ -223,6 +266,31 @@ PCSX = {
     end,
     getMemoryAsFile = function() return Support.File._createFileWrapper(C.getMemoryAsFile()) end,
     quit = function(code) C.quit(code or 0) end,
+    Profiler = {
+        start = function(period, callStacks) C.startGuestProfiler(period or 0, callStacks == true) end,
+        stop = function() C.stopGuestProfiler() end,
+        reset = function() C.resetGuestProfiler() end,
+        isRunning = function() return C.guestProfilerRunning() end,
+        getSampleCount = function() return tonumber(C.getGuestProfilerSampleCount()) end,
+        getProfile = getGuestProfile,
+    },
+    CPUTrace = {
+        start = function(path)
+            if type(path) ~= 'string' then error 'PCSX.CPUTrace.start requires a filename' end
+            return C.startCPUTrace(path)
+        end,
+        stop = function() C.stopCPUTrace() end,
+        isRecording = function() return C.cpuTraceRecording() end,
+        getRecordCount = function() return tonumber(C.getCPUTraceRecordCount()) end,
+    },
+    Rewind = {
+        capture = function() C.captureRewindSnapshot() end,
+        rewind = function(steps) return C.rewindEmulation(steps or 1) end,
+        clear = function() C.clearRewindHistory() end,
+        getSnapshotCount = function() return C.getRewindSnapshotCount() end,
+        getMemoryUsage = function() return tonumber(C.getRewindMemoryUsage()) end,
+        getCaptureTime = function() return tonumber(C.getRewindCaptureTime()) end,
+    },
 }
 
 print = function(...) printLike(function(s) C.luaMessage(s, false) end, ...) end
@@ -19,11 +19,14 @@
 
 #include "core/pcsxlua.h"
 
+#include "core/cpu-trace-recorder.h"
 #include "core/debug.h"
 #include "core/gpu.h"
+#include "core/guest-profiler.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
 #include "core/sstate.h"
 #include "lua/luafile.h"
 #include "lua/luawrapper.h"
@@ -35,13 +38,21 @@ struct LuaBreakpoint {
 };
 
 uint64_t getCPUCycles() { return PCSX::g_emulator->m_cpu->m_regs.cycle; }
-void* getMemPtr() { return PCSX::g_emulator->m_mem->m_wram; }
+// Writes through this pointer can't be tracked, so whoever asks for it is assumed to write everywhere, at any time,
+// until the next hard reset or state load. Scripts which only read should use getReadOnlyMemPtr instead.
+void* getMemPtr() {
+    PCSX::g_emulator->m_mem->exposeRawPointer();
+    return PCSX::g_emulator->m_mem->m_wram;
+}
+const void* getReadOnlyMemPtr() { return PCSX::g_emulator->m_mem->m_wram; }
 void* getParPtr() { return PCSX::g_emulator->m_mem->m_exp1; }
 void* getRomPtr() { return PCSX::g_emulator->m_mem->m_bios; }
 void* getScratchPtr() { return PCSX::g_emulator->m_mem->m_hard; }
 void* getRegisters() { return &PCSX::g_emulator->m_cpu->m_regs; }
 void* getReadLUT() { return PCSX::g_emulator->m_mem->m_readLUT; }
 void* getWriteLUT() { return PCSX::g_emulator->m_mem->m_writeLUT; }
+void* getReadPages() { return PCSX::g_emulator->m_mem->m_readPages; }
+void* getWritePages() { return PCSX::g_emulator->m_mem->m_writePages; }
 
 LuaBreakpoint* addBreakpoint(uint32_t address, PCSX::Debug::BreakpointType type, unsigned width, const char* cause,
                              bool (*invoker)(uint32_t address, unsigned width, const char* cause), const char* label) {
@@ -88,6 +99,7 @@ void jumpToMemory(uint32_t address, unsigned width) {
     PCSX::g_system->m_eventBus->signal(PCSX::Events::GUI::JumpToMemory{address, width});
 }
 void invalidateCache() { PCSX::g_emulator->m_cpu->invalidateCache(); }
+void resetCPUStatistics() { PCSX::g_emulator->m_cpu->resetStatistics(); }
 
 struct LuaScreenShot {
     PCSX::Slice* data;
@@ -110,11 +122,13 @@ PCSX::Slice* createSaveState() {
     return new PCSX::Slice(std::move(ss));
 }
 
+void writeSaveState(const char* filename) { PCSX::SaveStates::saveToFile(filename); }
+
 void loadSaveStateFromSlice(PCSX::Slice* data) { PCSX::SaveStates::load(data->asStringView()); }
 
 void loadSaveStateFromFile(PCSX::LuaFFI::LuaFile* file) {
-    auto data = file->file->readAt(64 * 1024 * 1024, 0);
-    PCSX::SaveStates::load(data.asStringView());
+    file->file->rSeek(0, SEEK_SET);
+    PCSX::SaveStates::loadFromFile(file->file);
 }
 
 PCSX::LuaFFI::LuaFile* getMemoryAsFile() {
@@ -123,6 +137,33 @@ PCSX::LuaFFI::LuaFile* getMemoryAsFile() {
 
 void quit(int code) { PCSX::g_system->quit(code); }
 
+void startGuestProfiler(uint32_t period, bool callStacks) {
+    PCSX::g_emulator->m_guestProfiler->start(period, callStacks);
+}
+void stopGuestProfiler() { PCSX::g_emulator->m_guestProfiler->stop(); }
+void resetGuestProfiler() { PCSX::g_emulator->m_guestProfiler->reset(); }
+bool guestProfilerRunning() { return PCSX::g_emulator->m_guestProfiler->running(); }
+uint64_t getGuestProfilerSampleCount() { return PCSX::g_emulator->m_guestProfiler->sampleCount(); }
+PCSX::Slice* getGuestProfile(bool pprof) {
+    auto& profiler = PCSX::g_emulator->m_guestProfiler;
+    return new PCSX::Slice(pprof ? profiler->pprof() : profiler->folded());
+}
+
+bool startCPUTrace(const char* path) { return PCSX::g_emulator->m_cpuTrace->start(path); }
+void stopCPUTrace() { PCSX::g_emulator->m_cpuTrace->stop(); }
+bool cpuTraceRecording() { return PCSX::g_emulator->m_cpuTrace->recording(); }
+uint64_t getCPUTraceRecordCount() { return PCSX::g_emulator->m_cpuTrace->recordCount(); }
+
+uint64_t getEmulatedFrames() { return PCSX::g_emulator->getEmulatedFrames(); }
+double getEmulatedFPS() { return PCSX::g_emulator->getEmulatedFPS(); }
+
+void captureRewindSnapshot() { PCSX::g_emulator->m_rewind->capture(); }
+bool rewindEmulation(uint32_t steps) { return PCSX::g_emulator->m_rewind->rewind(steps); }
+void clearRewindHistory() { PCSX::g_emulator->m_rewind->clear(); }
+uint32_t getRewindSnapshotCount() { return PCSX::g_emulator->m_rewind->snapshotCount(); }
+uint64_t getRewindMemoryUsage() { return PCSX::g_emulator->m_rewind->memoryUsage(); }
+uint64_t getRewindCaptureTime() { return PCSX::g_emulator->m_rewind->averageCaptureTime(); }
+
 }  // namespace
 
 template <typename T, size_t S>
@@ -140,12 +181,15 @@ static void registerAllSymbols(PCSX::Lua L) {
     L.newtable();
     REGISTER(L, getCPUCycles);
     REGISTER(L, getMemPtr);
+    REGISTER(L, getReadOnlyMemPtr);
     REGISTER(L, getParPtr);
     REGISTER(L, getRomPtr);
     REGISTER(L, getScratchPtr);
     REGISTER(L, getRegisters);
     REGISTER(L, getReadLUT);
     REGISTER(L, getWriteLUT);
+    REGISTER(L, getReadPages);
+    REGISTER(L, getWritePages);
     REGISTER(L, addBreakpoint);
     REGISTER(L, enableBreakpoint);
     REGISTER(L, disableBreakpoint);
@@ -160,12 +204,32 @@ static void registerAllSymbols(PCSX::Lua L) {
     REGISTER(L, jumpToPC);
     REGISTER(L, jumpToMemory);
     REGISTER(L, invalidateCache);
+    REGISTER(L, resetCPUStatistics);
     REGISTER(L, takeScreenShot);
     REGISTER(L, createSaveState);
+    REGISTER(L, writeSaveState);
     REGISTER(L, loadSaveStateFromSlice);
     REGISTER(L, loadSaveStateFromFile);
     REGISTER(L, getMemoryAsFile);
     REGISTER(L, quit);
+    REGISTER(L, startGuestProfiler);
+    REGISTER(L, stopGuestProfiler);
+    REGISTER(L, resetGuestProfiler);
+    REGISTER(L, guestProfilerRunning);
+    REGISTER(L, getGuestProfilerSampleCount);
+    REGISTER(L, getGuestProfile);
+    REGISTER(L, startCPUTrace);
+    REGISTER(L, stopCPUTrace);
+    REGISTER(L, cpuTraceRecording);
+    REGISTER(L, getCPUTraceRecordCount);
+    REGISTER(L, getEmulatedFrames);
+    REGISTER(L, getEmulatedFPS);
+    REGISTER(L, captureRewindSnapshot);
+    REGISTER(L, rewindEmulation);
+    REGISTER(L, clearRewindHistory);
+    REGISTER(L, getRewindSnapshotCount);
+    REGISTER(L, getRewindMemoryUsage);
+    REGISTER(L, getRewindCaptureTime);
     L.settable();
     L.pop();
 }
@@ -191,6 +255,19 @@ void PCSX::LuaFFI::open_pcsx(Lua L) {
             return 1;
         },
         -1);
+    L.declareFunc(
+        "getCPUStatistics",
+        [](lua_State* L_) -> int {
+            Lua L(L_);
+            L.newtable();
+            for (auto& [name, value] : g_emulator->m_cpu->getStatistics()) {
+                L.push(name);
+                L.push(lua_Number(value));
+                L.settable();
+            }
+            return 1;
+        },
+        -1);
     L.declareFunc(
         "insertSymbol",
         [](lua_State* L_) -> int {
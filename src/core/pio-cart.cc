@@ -52,6 +52,8 @@ void PCSX::PIOCart::setLuts() {
 
     memcpy(&m_readLUT[0x9f00], &m_readLUT[0x1f00], 0x6 * sizeof(void *));
     memcpy(&m_readLUT[0xbf00], &m_readLUT[0x1f00], 0x6 * sizeof(void *));
+
+    g_emulator->m_mem->setPIOPages(g_emulator->settings.get<Emulator::SettingPIOConnected>().value);
 }
 
 uint8_t PCSX::PIOCart::read8(uint32_t address) {
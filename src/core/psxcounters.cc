@@ -23,6 +23,8 @@
 
 #include "core/psxcounters.h"
 
+#include <thread>
+
 #include "core/debug.h"
 #include "core/gpu.h"
 #include "core/sio1.h"
@@ -87,6 +89,7 @@ void PCSX::Counters::set() {
     }
 
     m_psxNextCounter += next;
+    g_emulator->m_cpu->updateNextEventCycle();
 }
 
 void PCSX::Counters::reset(uint32_t index) {
@@ -137,25 +140,100 @@ void PCSX::Counters::reset(uint32_t index) {
     set();
 }
 
+void PCSX::Counters::paceAudio(uint64_t cycle) {
+    uint64_t prev = g_emulator->m_cpu->m_regs.previousCycles;
+    uint64_t diff = cycle - prev;
+    diff *= 4410000;
+    diff /= g_emulator->settings.get<Emulator::SettingScaler>();
+    diff /= g_emulator->m_psxClockSpeed;
+    uint32_t target = m_audioFrames + diff;
+    uint32_t newFrames = g_emulator->m_spu->getCurrentFrames();
+    int32_t framesDiff = target - newFrames;
+    if (framesDiff > 0) {
+        g_emulator->m_cpu->m_regs.previousCycles = cycle;
+        g_emulator->m_spu->waitForGoal(target);
+        m_audioFrames = target;
+    } else if (framesDiff < -2000000000) {
+        m_audioFrames = newFrames;
+    }
+}
+
+void PCSX::Counters::enterTurbo(uint64_t cycle) {
+    auto& path = g_emulator->settings.get<Emulator::SettingTurboAudioDump>().value;
+    IO<File> sink;
+    if (path.empty()) {
+        sink.setFile(new FailedFile);
+    } else if (path == m_turboAudioDumpPath) {
+        // Going in and out of turbo keeps adding to the same dump, which only starts over on a new path.
+        sink.setFile(new PosixFile(path, FileOps::CREATE));
+        if (!sink->failed()) sink->wSeek(0, SEEK_END);
+    } else {
+        sink.setFile(new PosixFile(path, FileOps::TRUNCATE));
+    }
+    if (sink->failed() && !path.empty()) {
+        g_system->printf(_("Unable to open audio dump file %s\n"), path.string());
+    } else {
+        m_turboAudioDumpPath = path;
+    }
+    m_turbo = true;
+    m_turboSpeed = -1;
+    m_audioFrames = m_turboAudioFrames = g_emulator->m_spu->getCurrentFrames();
+    m_turboAudioCycle = cycle;
+    g_emulator->m_spu->setOutputSink(sink);
+}
+
+void PCSX::Counters::leaveTurbo() {
+    m_turbo = false;
+    g_emulator->m_spu->setOutputSink({});
+    m_audioFrames = g_emulator->m_spu->getCurrentFrames();
+}
+
+void PCSX::Counters::paceTurbo(uint64_t cycle) {
+    using namespace std::chrono;
+
+    // Loading a save state can send the cycle counter backwards.
+    if (cycle < m_turboAudioCycle) {
+        m_turboAudioFrames = m_audioFrames;
+        m_turboAudioCycle = cycle;
+    }
+    // The audio sink produces exactly as much as the emulated time, regardless of the speed scaler.
+    const uint64_t frames = (cycle - m_turboAudioCycle) * 44100 / g_emulator->m_psxClockSpeed;
+    m_audioFrames = m_turboAudioFrames + frames;
+    g_emulator->m_cpu->m_regs.previousCycles = cycle;
+    g_emulator->m_spu->setOutputSinkGoal(m_audioFrames);
+
+    const int speed = g_emulator->settings.get<Emulator::SettingTurboSpeed>();
+    if (speed <= 0) return;
+    const auto now = steady_clock::now();
+    // Start over after a speed change, or when too far behind, such as when coming back from a pause, instead of
+    // running flat out until catching up.
+    bool resync = (speed != m_turboSpeed) || (cycle < m_turboReferenceCycle);
+    steady_clock::time_point goal;
+    if (!resync) {
+        const double seconds =
+            double(cycle - m_turboReferenceCycle) * 100.0 / (double(g_emulator->m_psxClockSpeed) * speed);
+        goal = m_turboReference + duration_cast<steady_clock::duration>(duration<double>(seconds));
+        resync = now > goal + 100ms;
+    }
+    if (resync) {
+        m_turboSpeed = speed;
+        m_turboReference = now;
+        m_turboReferenceCycle = cycle;
+        return;
+    }
+    // Sleeping is coarse on some systems, so only bother when far enough ahead.
+    if (goal - now > 1ms) std::this_thread::sleep_until(goal);
+}
+
 void PCSX::Counters::update() {
     const uint64_t cycle = PCSX::g_emulator->m_cpu->m_regs.cycle;
 
-    {
-        uint64_t prev = g_emulator->m_cpu->m_regs.previousCycles;
-        uint64_t diff = cycle - prev;
-        diff *= 4410000;
-        diff /= g_emulator->settings.get<Emulator::SettingScaler>();
-        diff /= g_emulator->m_psxClockSpeed;
-        uint32_t target = m_audioFrames + diff;
-        uint32_t newFrames = g_emulator->m_spu->getCurrentFrames();
-        int32_t framesDiff = target - newFrames;
-        if (framesDiff > 0) {
-            g_emulator->m_cpu->m_regs.previousCycles = cycle;
-            g_emulator->m_spu->waitForGoal(target);
-            m_audioFrames = target;
-        } else if (framesDiff < -2000000000) {
-            m_audioFrames = newFrames;
-        }
+    if (g_emulator->settings.get<Emulator::SettingTurbo>()) {
+        if (!m_turbo) enterTurbo(cycle);
+        paceTurbo(cycle);
+    } else {
+        if (m_turbo) leaveTurbo();
+        paceAudio(cycle);
     }
 
     // rcnt 0.
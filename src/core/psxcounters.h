@@ -19,6 +19,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <filesystem>
+
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
@@ -36,6 +39,10 @@ class Counters {
     void set();
     void reset(uint32_t index);
     void calculateHsync();
+    void paceAudio(uint64_t cycle);
+    void paceTurbo(uint64_t cycle);
+    void enterTurbo(uint64_t cycle);
+    void leaveTurbo();
 
     struct Rcnt {
         uint16_t mode, target;
@@ -84,6 +91,17 @@ class Counters {
     uint32_t m_audioFrames = 0;
     int32_t m_spuSyncCountdown = 0;
 
+    // Turbo mode, see Emulator::SettingTurbo. The audio sink is fed from the emulated time since entering it, and
+    // the wall clock pacing, if any, from the emulated time since the last time it had to resynchronize. The audio
+    // dump is appended to for as long as its path stays the same.
+    bool m_turbo = false;
+    int m_turboSpeed = 0;
+    uint32_t m_turboAudioFrames = 0;
+    uint64_t m_turboAudioCycle = 0;
+    std::chrono::steady_clock::time_point m_turboReference;
+    uint64_t m_turboReferenceCycle = 0;
+    std::filesystem::path m_turboAudioDumpPath;
+
     uint32_t m_HSyncTotal[PCSX::Emulator::PSX_TYPE_PAL + 1];  // 2
   public:
     uint64_t m_psxNextCounter;
@@ -21,12 +21,14 @@
 
 #include "core/callstacks.h"
 #include "core/cdrom.h"
+#include "core/cpu-trace-recorder.h"
 #include "core/debug.h"
 #include "core/eventslua.h"
 #include "core/gdb-server.h"
 #include "core/gpu.h"
 #include "core/gpulogger.h"
 #include "core/gte.h"
+#include "core/guest-profiler.h"
 #include "core/luaiso.h"
 #include "core/mdec.h"
 #include "core/pad.h"
@@ -34,6 +36,7 @@
 #include "core/pcsxlua.h"
 #include "core/pio-cart.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
 #include "core/sio.h"
 #include "core/sio1-server.h"
 #include "core/sio1.h"
@@ -58,10 +61,12 @@ PCSX::Emulator::Emulator()
     : m_callStacks(new PCSX::CallStacks),
       m_cdrom(PCSX::CDRom::factory()),
       m_counters(new PCSX::Counters()),
+      m_cpuTrace(new PCSX::CPUTraceRecorder()),
       m_debug(new PCSX::Debug()),
       m_gdbServer(new PCSX::GdbServer()),
       m_gpuLogger(new PCSX::GPULogger()),
       m_gte(new PCSX::GTE()),
+      m_guestProfiler(new PCSX::GuestProfiler()),
       m_hw(new PCSX::HW()),
       m_lua(new PCSX::Lua()),
       m_mdec(new PCSX::MDEC()),
@@ -69,6 +74,7 @@ PCSX::Emulator::Emulator()
       m_pads(PCSX::Pads::factory()),
       m_patchManager(new PatchManager()),
       m_pioCart(new PCSX::PIOCart),
+      m_rewind(new PCSX::Rewind()),
       m_sio(new PCSX::SIO()),
       m_sio1(new PCSX::SIO1()),
       m_sio1Server(new PCSX::SIO1Server()),
@@ -173,13 +179,20 @@ void PCSX::Emulator::shutdown() {
 }
 
 void PCSX::Emulator::vsync() {
+    m_emulatedFrames++;
+    const auto now = std::chrono::steady_clock::now();
+    const auto elapsed = now - m_fpsReference;
+    if (elapsed >= std::chrono::seconds(1)) {
+        m_emulatedFPS = (m_emulatedFrames - m_fpsReferenceFrames) / std::chrono::duration<double>(elapsed).count();
+        m_fpsReference = now;
+        m_fpsReferenceFrames = m_emulatedFrames;
+    }
+
     m_gpu->vblank();
     g_system->m_eventBus->signal<Events::GPU::VSync>({});
     g_system->update(true);
 
-    if (m_config.RewindInterval > 0 && !(++m_rewind_counter % m_config.RewindInterval)) {
-        // CreateRewindState();
-    }
+    m_rewind->vsync();
 }
 
 void PCSX::Emulator::setPGXPMode(uint32_t pgxpMode) { m_cpu->psxSetPGXPMode(pgxpMode); }
@@ -40,6 +40,7 @@
 #include <time.h>
 #include <zlib.h>
 
+#include <chrono>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -69,11 +70,13 @@ namespace PCSX {
 class CallStacks;
 class CDRom;
 class Counters;
+class CPUTraceRecorder;
 class Debug;
 class GdbServer;
 class GPU;
 class GPULogger;
 class GTE;
+class GuestProfiler;
 class HW;
 class Lua;
 class MDEC;
@@ -81,6 +84,7 @@ class Memory;
 class Pads;
 class PatchManager;
 class R3000Acpu;
+class Rewind;
 class SIO;
 class SPUInterface;
 class System;
@@ -161,6 +165,14 @@ class Emulator {
     typedef Setting<bool, TYPESTRING("SpuIrq")> SettingSpuIrq;
     typedef Setting<bool, TYPESTRING("BnWMdec")> SettingBnWMdec;
     typedef Setting<int, TYPESTRING("Scaler"), 100> SettingScaler;
+    // Turbo mode stops pacing the emulation against the audio device. TurboSpeed is then a percentage of real time,
+    // where 0 means as fast as possible, and the audio output goes to TurboAudioDump, or nowhere if it's empty.
+    typedef Setting<bool, TYPESTRING("Turbo"), false> SettingTurbo;
+    typedef Setting<int, TYPESTRING("TurboSpeed"), 0> SettingTurboSpeed;
+    typedef SettingPath<TYPESTRING("TurboAudioDump")> SettingTurboAudioDump;
+    // Rewind snapshots the emulation every RewindInterval frames, 0 meaning never, within RewindMemory megabytes.
+    typedef Setting<int, TYPESTRING("RewindInterval"), 0> SettingRewindInterval;
+    typedef Setting<int, TYPESTRING("RewindMemory"), 256> SettingRewindMemory;
     typedef Setting<bool, TYPESTRING("AutoVideo"), true> SettingAutoVideo;
     typedef Setting<VideoType, TYPESTRING("Video"), PSX_TYPE_NTSC> SettingVideo;
     typedef Setting<bool, TYPESTRING("FastBoot"), false> SettingFastBoot;
@@ -170,6 +182,14 @@ class Emulator {
     typedef Setting<bool, TYPESTRING("Mcd1Inserted"), true> SettingMcd1Inserted;
     typedef Setting<bool, TYPESTRING("Mcd2Inserted"), true> SettingMcd2Inserted;
     typedef Setting<bool, TYPESTRING("Dynarec"), true> SettingDynarec;
+    typedef Setting<bool, TYPESTRING("DynarecLinking"), true> SettingDynarecLinking;
+    typedef Setting<bool, TYPESTRING("DynarecSuperblocks"), false> SettingDynarecSuperblocks;
+    typedef Setting<bool, TYPESTRING("DynarecCache"), false> SettingDynarecCache;
+    typedef Setting<bool, TYPESTRING("DynarecPerf"), false> SettingDynarecPerf;
+    typedef SettingPath<TYPESTRING("DynarecCachePath"), TYPESTRING("dynarec.cache")> SettingDynarecCachePath;
+    typedef Setting<bool, TYPESTRING("ThreadedInterpreter"), false> SettingThreadedInterpreter;
+    typedef Setting<bool, TYPESTRING("IdleSkip"), false> SettingIdleSkip;
+    typedef SettingVector<std::string, TYPESTRING("IdleSkipDisabledGames")> SettingIdleSkipDisabledGames;
     typedef Setting<bool, TYPESTRING("8Megs"), false> Setting8MB;
     typedef Setting<int, TYPESTRING("GUITheme"), 0> SettingGUITheme;
     typedef Setting<int, TYPESTRING("Dither"), 1> SettingDither;
@@ -195,11 +215,14 @@ class Emulator {
     Settings<SettingMcd1, SettingMcd2, SettingBios, SettingPpfDir, SettingPsxExe, SettingXa, SettingSpuIrq,
              SettingBnWMdec, SettingScaler, SettingAutoVideo, SettingVideo, SettingFastBoot, SettingDebugSettings,
              SettingRCntFix, SettingIsoPath, SettingLocale, SettingMcd1Inserted, SettingMcd2Inserted, SettingDynarec,
-             Setting8MB, SettingGUITheme, SettingDither, SettingCachedDithering, SettingGLErrorReporting,
+             SettingDynarecLinking, SettingDynarecSuperblocks, SettingDynarecCache, SettingDynarecCachePath,
+             SettingDynarecPerf, SettingThreadedInterpreter, SettingIdleSkip, SettingIdleSkipDisabledGames, Setting8MB,
+             SettingGUITheme, SettingDither, SettingCachedDithering, SettingGLErrorReporting,
              SettingGLErrorReportingSeverity, SettingFullCaching, SettingHardwareRenderer, SettingShownAutoUpdateConfig,
              SettingAutoUpdate, SettingMSAA, SettingLinearFiltering, SettingKioskMode, SettingMcd1Pocketstation,
              SettingMcd2Pocketstation, SettingBiosBrowsePath, SettingEXP1Filepath, SettingEXP1BrowsePath,
-             SettingPIOConnected, SettingMapBrowsePath, SettingOpenDialogFavorites>
+             SettingPIOConnected, SettingMapBrowsePath, SettingOpenDialogFavorites, SettingTurbo, SettingTurboSpeed,
+             SettingTurboAudioDump, SettingRewindInterval, SettingRewindMemory>
         settings;
     class PcsxConfig {
       public:
@@ -209,8 +232,6 @@ class Emulator {
         bool HideCursor = false;
         bool SaveWindowPos = false;
         int32_t WindowPos[2] = {0, 0};
-        uint32_t RewindCount = 0;
-        uint32_t RewindInterval = 0;
         uint32_t AltSpeed1 = 0;  // Percent relative to natural speed.
         uint32_t AltSpeed2 = 0;
         bool OverClock = false;  // enable overclocking
@@ -222,8 +243,10 @@ class Emulator {
         uint32_t PGXP_Mode = 0;
     };
 
-    // It is safe if these overflow
-    uint32_t m_rewind_counter = 0;
+    uint64_t m_emulatedFrames = 0;
+    uint64_t m_fpsReferenceFrames = 0;
+    std::chrono::steady_clock::time_point m_fpsReference;
+    double m_emulatedFPS = 0.0;
 
     // Used for overclocking
     // Make the timing events trigger faster as we are currently assuming everything
@@ -246,6 +269,10 @@ class Emulator {
     void reset();
     void shutdown();
     void vsync();
+    // Emulated frames, as in vertical blanks, since the emulator started, and how many of them went by during the
+    // last second of wall time. Unlike the UI's frame rate, this isn't capped by the display or the audio device.
+    uint64_t getEmulatedFrames() const { return m_emulatedFrames; }
+    double getEmulatedFPS() const { return m_emulatedFPS; }
     void setPGXPMode(uint32_t pgxpMode);
 
     void setLua();
@@ -255,11 +282,13 @@ class Emulator {
     std::unique_ptr<CallStacks> m_callStacks;
     std::unique_ptr<CDRom> m_cdrom;
     std::unique_ptr<Counters> m_counters;
+    std::unique_ptr<CPUTraceRecorder> m_cpuTrace;
     std::unique_ptr<Debug> m_debug;
     std::unique_ptr<GdbServer> m_gdbServer;
     std::unique_ptr<GPU> m_gpu;
     std::unique_ptr<GPULogger> m_gpuLogger;
     std::unique_ptr<GTE> m_gte;
+    std::unique_ptr<GuestProfiler> m_guestProfiler;
     std::unique_ptr<HW> m_hw;
     std::unique_ptr<Lua> m_lua;
     std::unique_ptr<MDEC> m_mdec;
@@ -268,6 +297,7 @@ class Emulator {
     std::unique_ptr<PatchManager> m_patchManager;
     std::unique_ptr<PIOCart> m_pioCart;
     std::unique_ptr<R3000Acpu> m_cpu;
+    std::unique_ptr<Rewind> m_rewind;
     std::unique_ptr<SIO> m_sio;
     std::unique_ptr<SIO1> m_sio1;
     std::unique_ptr<SIO1Server> m_sio1Server;
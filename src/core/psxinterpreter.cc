@@ -17,7 +17,10 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
  ***************************************************************************/
 
+#include <algorithm>
+
 #include "core/callstacks.h"
+#include "core/cpu-trace-recorder.h"
 #include "core/debug.h"
 #include "core/disr3000a.h"
 #include "core/gte.h"
@@ -81,9 +84,24 @@
 #define _JumpTarget_ ((_Target_ * 4) + (_PC_ & 0xf0000000))  // Calculates the target during a jump instruction
 #define _BranchTarget_ ((int16_t)_Im_ * 4 + _PC_)            // Calculates the target during a branch instruction
 
+// Instructions the threaded dispatcher has a label of its own for. The label calls the handler directly, which lets
+// the compiler inline it. Everything else, including all of the PGXP variants, goes through the handler pointer.
+#define INTERPRETER_THREADED_OPS(X)                                                                                \
+    X(SLL) X(SRL) X(SRA) X(JR) X(JALR) X(MFHI) X(MFLO) X(ADDU) X(SUBU) X(AND) X(OR) X(XOR) X(NOR) X(SLT) X(SLTU) \
+    X(J) X(JAL) X(BEQ) X(BNE) X(BLEZ) X(BGTZ) X(ADDIU) X(SLTI) X(SLTIU) X(ANDI) X(ORI) X(XORI) X(LUI) X(LB)      \
+    X(LH) X(LW) X(LBU) X(LHU) X(SB) X(SH) X(SW)
+
+// Instructions which can never queue a delayed load or a jump. When nothing else is in flight, the interpreter can skip
+// all of the delay bookkeeping after them. Loads, branches, and the coprocessor moves all take the full path.
+#define INTERPRETER_UNDELAYED_OPS(X)                                                                             \
+    X(SLL) X(SRL) X(SRA) X(SLLV) X(SRLV) X(SRAV) X(MFHI) X(MTHI) X(MFLO) X(MTLO) X(MULT) X(MULTU) X(DIV) X(DIVU) \
+    X(ADD) X(ADDU) X(SUB) X(SUBU) X(AND) X(OR) X(XOR) X(NOR) X(SLT) X(SLTU) X(ADDI) X(ADDIU) X(SLTI) X(SLTIU)    \
+    X(ANDI) X(ORI) X(XORI) X(LUI) X(SB) X(SH) X(SW) X(SWL) X(SWR)
+
 class InterpretedCPU final : public PCSX::R3000Acpu {
   public:
-    InterpretedCPU() : R3000Acpu("Interpreted") {}
+    InterpretedCPU(bool threaded)
+        : R3000Acpu(threaded ? "Interpreted (threaded)" : "Interpreted"), m_threaded(threaded) {}
 
   private:
     virtual bool Implemented() final { return true; }
@@ -94,6 +112,15 @@ class InterpretedCPU final : public PCSX::R3000Acpu {
     virtual void Shutdown() override;
     virtual void SetPGXPMode(uint32_t pgxpMode) override;
     virtual bool isDynarec() override { return false; }
+    virtual std::vector<std::pair<std::string_view, uint64_t>> getStatistics() override {
+        auto statistics = R3000Acpu::getStatistics();
+        statistics.emplace_back("instructions", m_instructions);
+        return statistics;
+    }
+    virtual void resetStatistics() override {
+        R3000Acpu::resetStatistics();
+        m_instructions = 0;
+    }
     void maybeCancelDelayedLoad(uint32_t index) {
         unsigned other = m_currentDelayedLoad ^ 1;
         if (m_delayedLoadInfo[other].index == index) m_delayedLoadInfo[other].active = false;
@@ -116,8 +143,148 @@ class InterpretedCPU final : public PCSX::R3000Acpu {
 
     template <bool debug, bool trace>
     void execBlock();
+    void execBlockThreaded();
     void doBranch(uint32_t target, bool fromLink);
 
+    const bool m_threaded;
+    uint64_t m_instructions = 0;
+
+    enum class ThreadedOp : uint8_t {
+        Call,
+#define THREADED_OP_ENUM(name) name,
+        INTERPRETER_THREADED_OPS(THREADED_OP_ENUM)
+#undef THREADED_OP_ENUM
+    };
+
+    // Pre-decoded instructions, one page per 4KB of RAM or BIOS, allocated on first use. Each entry holds the
+    // instruction word, along with its handler already resolved through the SPECIAL, REGIMM and COP0 tables, and its
+    // threaded dispatch label when the CPU uses one. Entries are dropped by Clear, which writes bypassing the CPU
+    // reach through Memory::markDirty, and whole pages by invalidateCache.
+    struct DecodedInstruction {
+        intFunc_t handler = nullptr;
+        uint32_t code = 0;
+        ThreadedOp op = ThreadedOp::Call;
+        bool undelayed = false;
+    };
+    static constexpr uint32_t c_decodedPageSize = 0x1000;
+    static constexpr uint32_t c_biosBase = 0x1fc00000;
+    static constexpr uint32_t c_biosSize = 0x80000;
+    std::unique_ptr<DecodedInstruction[]> m_decodedPages[(c_codePagesRange + c_biosSize) / c_decodedPageSize];
+    DecodedInstruction *m_lastDecodedPage = nullptr;
+    uint32_t m_lastDecodedTag = 0xffffffff;
+
+    DecodedInstruction *getDecodedPage(uint32_t pc, bool allocate) {
+        const uint32_t physical = pc & 0x1fffffff;
+        uint32_t index;
+        if (physical < c_codePagesRange) {
+            // Writes through a raw pointer to RAM would never reach Clear
+            if (PCSX::g_emulator->m_mem->rawPointerExposed()) return nullptr;
+            index = (physical & PCSX::g_emulator->getRamMask()) / c_decodedPageSize;
+        } else if ((physical >= c_biosBase) && (physical < c_biosBase + c_biosSize)) {
+            index = (c_codePagesRange + physical - c_biosBase) / c_decodedPageSize;
+        } else {
+            return nullptr;
+        }
+        auto &page = m_decodedPages[index];
+        if (!page && allocate) page.reset(new DecodedInstruction[c_decodedPageSize / 4]);
+        return page.get();
+    }
+    DecodedInstruction decode(uint32_t code) {
+        intFunc_t handler = s_pPsxBSC[code >> 26];
+        if (handler == &InterpretedCPU::psxSPECIAL) {
+            handler = s_pPsxSPC[_fFunct_(code)];
+        } else if (handler == &InterpretedCPU::psxREGIMM) {
+            handler = s_pPsxREG[_fRt_(code)];
+        } else if (handler == &InterpretedCPU::psxCOP0) {
+            handler = s_pPsxCP0[_fRs_(code)];
+        }
+        DecodedInstruction decoded{handler, code};
+        if (m_threaded) {
+#define THREADED_OP_MATCH(name) \
+    if (handler == &InterpretedCPU::psx##name) decoded.op = ThreadedOp::name;
+            INTERPRETER_THREADED_OPS(THREADED_OP_MATCH)
+#undef THREADED_OP_MATCH
+        }
+#define UNDELAYED_OP_MATCH(name) \
+    if (handler == &InterpretedCPU::psx##name) decoded.undelayed = true;
+        INTERPRETER_UNDELAYED_OPS(UNDELAYED_OP_MATCH)
+#undef UNDELAYED_OP_MATCH
+        return decoded;
+    }
+    DecodedInstruction fetchDecoded(uint32_t pc) {
+        const uint32_t tag = pc / c_decodedPageSize;
+        if (tag != m_lastDecodedTag) {
+            m_lastDecodedPage = getDecodedPage(pc, true);
+            m_lastDecodedTag = tag;
+        }
+        // Uncached region, such as the expansion ports, or RAM once Lua got a raw pointer to it
+        if (!m_lastDecodedPage) return decode(readICache(pc));
+        auto &decoded = m_lastDecodedPage[(pc % c_decodedPageSize) / 4];
+        if (!decoded.handler) {
+            // Going through the icache makes sure we see the same thing the interpreter always did. Since these
+            // entries outlive icache lines, the page has to be marked as code no matter which segment we came from.
+            decoded = decode(readICache(pc));
+            markCodePage(pc);
+        }
+        return decoded;
+    }
+    void clearDecoded(uint32_t address, uint32_t size) {
+        while (size != 0) {
+            const uint32_t index = (address % c_decodedPageSize) / 4;
+            const uint32_t count = std::min(size, c_decodedPageSize / 4 - index);
+            auto page = getDecodedPage(address, false);
+            if (page) std::fill_n(page + index, count, DecodedInstruction{});
+            address += count * 4;
+            size -= count;
+        }
+    }
+    virtual void invalidateCache() override {
+        R3000Acpu::invalidateCache();
+        for (auto &page : m_decodedPages) page.reset();
+        m_lastDecodedPage = nullptr;
+        m_lastDecodedTag = 0xffffffff;
+    }
+
+    // What execBlock does around an instruction's handler, shared with execBlockThreaded.
+    DecodedInstruction startInstruction(uint32_t pc) {
+        if (m_nextIsDelaySlot) {
+            m_inDelaySlot = true;
+            m_nextIsDelaySlot = false;
+        }
+        // TODO: throw an exception here if pc is out of range
+        const auto decoded = fetchDecoded(pc);
+        m_regs.code = decoded.code;
+        m_regs.pc = pc + 4;
+        m_regs.cycle += PCSX::Emulator::BIAS;
+        m_instructions++;
+        return decoded;
+    }
+    // True when neither a delayed load nor a jump is in flight. Until the next instruction which isn't in
+    // INTERPRETER_UNDELAYED_OPS, finishInstruction would then have nothing to do, and the loops skip it.
+    bool delaysSettled() const {
+        return !(m_delayedLoadInfo[0].active || m_delayedLoadInfo[1].active || m_delayedLoadInfo[0].pcActive ||
+                 m_delayedLoadInfo[1].pcActive || m_nextIsDelaySlot || m_inDelaySlot);
+    }
+    // Returns true once the instruction that just ran was a delay slot, which ends the block.
+    bool finishInstruction(uint32_t pc, bool &fromLink) {
+        m_currentDelayedLoad ^= 1;
+        flushCurrentDelayedLoad();
+        auto &delayedLoad = m_delayedLoadInfo[m_currentDelayedLoad];
+        fromLink = false;
+        if (delayedLoad.pcActive) {
+            m_regs.pc = delayedLoad.pcValue;
+            fromLink = delayedLoad.fromLink;
+            delayedLoad.pcActive = false;
+            delayedLoad.fromLink = false;
+        }
+        if (!m_inDelaySlot) return false;
+        m_inDelaySlot = false;
+        InterceptBIOS<true>(m_regs.pc);
+        if ((pc - 4 - m_regs.pc) <= c_idleLoopMaxBytes) idleLoopBackEdge(pc - 4);
+        branchTest();
+        return true;
+    }
+
     void MTC0(int reg, uint32_t val);
 
     /* Arithmetic with immediate operand */
@@ -1582,14 +1749,17 @@ void InterpretedCPU::Execute() {
                                 .get<PCSX::Emulator::DebugSettings::Trace>();
         const bool &skipISR = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
                                   .get<PCSX::Emulator::DebugSettings::SkipISR>();
+        const bool traced = (trace || PCSX::g_emulator->m_cpuTrace->recording()) && !(skipISR && m_inISR);
         if (debug) {
-            if (!trace || (skipISR && m_inISR)) {
+            if (!traced) {
                 execBlock<true, false>();
             } else {
                 execBlock<true, true>();
             }
         } else {
-            if (!trace || (skipISR && m_inISR)) {
+            if (!traced && m_threaded) {
+                execBlockThreaded();
+            } else if (!traced) {
                 execBlock<false, false>();
             } else {
                 execBlock<false, true>();
@@ -1599,6 +1769,7 @@ void InterpretedCPU::Execute() {
 }
 
 void InterpretedCPU::Clear(uint32_t Addr, uint32_t Size) {
+    clearDecoded(Addr, Size);
     for (auto i = 0; i < Size; i += 4) {
         flushICacheLine(Addr);
         Addr += 16;
@@ -1610,44 +1781,33 @@ void InterpretedCPU::Shutdown() {}
 template <bool debug, bool trace>
 inline void InterpretedCPU::execBlock() {
     bool ranDelaySlot = false;
+    bool settled = delaysSettled();
     do {
-        if (m_nextIsDelaySlot) {
-            m_inDelaySlot = true;
-            m_nextIsDelaySlot = false;
-        }
-        // TODO: throw an exception here if pc is out of range
         const uint32_t pc = m_regs.pc;
         // TODO: throw an exception here if we don't have a pointer
-        uint32_t code = readICache(pc);
-
-        m_regs.code = code;
+        const auto decoded = startInstruction(pc);
+        const uint32_t code = decoded.code;
 
+        // The binary recorder takes precedence over the text log, which is much slower.
+        auto &recorder = *PCSX::g_emulator->m_cpuTrace;
         if constexpr (trace) {
-            std::string ins = PCSX::Disasm::asString(code, 0, pc, nullptr, true);
-            PCSX::g_system->log(PCSX::LogClass::CPU, "%s\n", ins);
+            if (recorder.recording()) {
+                recorder.begin(m_regs, pc, code);
+            } else {
+                std::string ins = PCSX::Disasm::asString(code, 0, pc, nullptr, true);
+                PCSX::g_system->log(PCSX::LogClass::CPU, "%s\n", ins);
+            }
         }
 
-        m_regs.pc += 4;
-        m_regs.cycle += PCSX::Emulator::BIAS;
-
-        cIntFunc_t func = s_pPsxBSC[code >> 26];
-        (*this.*func)(code);
+        (*this.*decoded.handler)(code);
 
-        m_currentDelayedLoad ^= 1;
-        flushCurrentDelayedLoad();
-        auto &delayedLoad = m_delayedLoadInfo[m_currentDelayedLoad];
         bool fromLink = false;
-        if (delayedLoad.pcActive) {
-            m_regs.pc = delayedLoad.pcValue;
-            fromLink = delayedLoad.fromLink;
-            delayedLoad.pcActive = false;
-            delayedLoad.fromLink = false;
+        if (!settled || !decoded.undelayed) {
+            ranDelaySlot = finishInstruction(pc, fromLink);
+            settled = delaysSettled();
         }
-        if (m_inDelaySlot) {
-            m_inDelaySlot = false;
-            ranDelaySlot = true;
-            InterceptBIOS<true>(m_regs.pc);
-            branchTest();
+        if constexpr (trace) {
+            if (recorder.recording()) recorder.end(m_regs);
         }
         if constexpr (debug) {
             uint32_t newPC = m_regs.pc;
@@ -1657,6 +1817,63 @@ inline void InterpretedCPU::execBlock() {
     } while (!ranDelaySlot && !debug);
 }
 
+// Direct-threaded version of execBlock<false, false>. Every opcode label ends with its own copy of the fetch and
+// dispatch, so the host's branch predictor gets one indirect jump per opcode to learn from, instead of a single one
+// shared by all of them. It also keeps going across blocks, until the emulator needs to stop or the debugger or the
+// tracer gets enabled. Compilers without labels as values get a switch on the opcode instead of the jump table.
+void InterpretedCPU::execBlockThreaded() {
+    const bool &debug = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
+                            .get<PCSX::Emulator::DebugSettings::Debug>();
+    const bool &trace = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingDebugSettings>()
+                            .get<PCSX::Emulator::DebugSettings::Trace>();
+    const auto &recorder = *PCSX::g_emulator->m_cpuTrace;
+    uint32_t pc = m_regs.pc;
+    DecodedInstruction decoded = startInstruction(pc);
+    bool settled = delaysSettled();
+    bool fromLink;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define THREADED_OP_LABEL(name) &&op_##name,
+    static const void *const c_labels[] = {&&op_Call, INTERPRETER_THREADED_OPS(THREADED_OP_LABEL)};
+#undef THREADED_OP_LABEL
+#define THREADED_DISPATCH() goto *c_labels[static_cast<unsigned>(decoded.op)]
+#else
+#define THREADED_OP_CASE(name) \
+    case ThreadedOp::name:     \
+        goto op_##name;
+#define THREADED_DISPATCH()                        \
+    switch (decoded.op) {                          \
+        INTERPRETER_THREADED_OPS(THREADED_OP_CASE) \
+        default:                                   \
+            goto op_Call;                          \
+    }
+#endif
+#define THREADED_NEXT()                                                              \
+    if (!settled || !decoded.undelayed) {                                            \
+        const bool stop = finishInstruction(pc, fromLink);                           \
+        if (stop && (debug || trace || recorder.recording() || !hasToRun())) return; \
+        settled = delaysSettled();                                                   \
+    }                                                                                \
+    pc = m_regs.pc;                                                                  \
+    decoded = startInstruction(pc);                                                  \
+    THREADED_DISPATCH();
+#define THREADED_OP_BODY(name) \
+    op_##name:                 \
+    psx##name(decoded.code);   \
+    THREADED_NEXT();
+
+    THREADED_DISPATCH();
+op_Call:
+    (*this.*decoded.handler)(decoded.code);
+    THREADED_NEXT();
+    INTERPRETER_THREADED_OPS(THREADED_OP_BODY)
+
+#undef THREADED_OP_BODY
+#undef THREADED_NEXT
+#undef THREADED_DISPATCH
+#undef THREADED_OP_CASE
+}
+
 void InterpretedCPU::SetPGXPMode(uint32_t pgxpMode) {
     switch (pgxpMode) {
         case 0:  // PGXP_MODE_DISABLED:
@@ -1690,5 +1907,9 @@ void InterpretedCPU::SetPGXPMode(uint32_t pgxpMode) {
 }
 
 std::unique_ptr<PCSX::R3000Acpu> PCSX::Cpus::getInterpreted() {
-    return std::unique_ptr<PCSX::R3000Acpu>(new InterpretedCPU());
+    return std::unique_ptr<PCSX::R3000Acpu>(new InterpretedCPU(false));
+}
+
+std::unique_ptr<PCSX::R3000Acpu> PCSX::Cpus::getInterpretedThreaded() {
+    return std::unique_ptr<PCSX::R3000Acpu>(new InterpretedCPU(true));
 }
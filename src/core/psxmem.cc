@@ -24,6 +24,7 @@
 #include <map>
 #include <string_view>
 
+#include "core/debug.h"
 #include "core/pio-cart.h"
 #include "core/psxhw.h"
 #include "core/r3000a.h"
@@ -86,20 +87,16 @@ static const std::map<uint32_t, std::string_view> s_knownBioses = {
 };
 
 PCSX::Memory::Memory() : m_listener(g_system->m_eventBus) {
-    m_listener.listen<Events::ExecutionFlow::Reset>([this](auto &) {
-        free(m_msanRAM);
-        free(m_msanUsableBitmap);
-        free(m_msanInitializedBitmap);
-        m_msanRAM = nullptr;
-        m_msanUsableBitmap = nullptr;
-        m_msanInitializedBitmap = nullptr;
-        m_msanAllocs.clear();
-    });
+    m_listener.listen<Events::ExecutionFlow::Reset>([this](auto &) { freeMsan(); });
+    m_listener.listen<Events::ExecutionFlow::SaveStateLoaded>([this](auto &) { m_rawPointerExposed = false; });
 }
 
 int PCSX::Memory::init() {
     m_readLUT = (uint8_t **)calloc(0x10000, sizeof(void *));
     m_writeLUT = (uint8_t **)calloc(0x10000, sizeof(void *));
+    m_readPages = (PageKind *)calloc(0x10000, sizeof(PageKind));
+    m_writePages = (PageKind *)calloc(0x10000, sizeof(PageKind));
+    m_watchedPages = (uint8_t *)calloc(0x10000, 1);
 
     // Init all memory as named mappings
     bool success = m_wramShared.init("wram", 0x00800000, true);
@@ -110,12 +107,20 @@ int PCSX::Memory::init() {
     m_hard = (uint8_t *)calloc(0x00010000, 1);
     m_bios = (uint8_t *)calloc(0x00080000, 1);
 
-    if (m_readLUT == NULL || m_writeLUT == NULL || m_wram == NULL || m_exp1 == NULL || m_bios == NULL ||
-        m_hard == NULL) {
+    if (m_readLUT == NULL || m_writeLUT == NULL || m_readPages == NULL || m_writePages == NULL ||
+        m_watchedPages == NULL || m_wram == NULL || m_exp1 == NULL || m_bios == NULL || m_hard == NULL) {
         g_system->message("%s", _("Error allocating memory!"));
         return -1;
     }
 
+    // Scratchpad and hardware registers, and the cache control register
+    for (auto page : {0x1f80, 0x9f80, 0xbf80}) {
+        m_readPages[page] = PageKind::Hardware;
+        m_writePages[page] = PageKind::Hardware;
+    }
+    m_readPages[0xfffe] = PageKind::Control;
+    m_writePages[0xfffe] = PageKind::Control;
+
     // EXP1
     if (g_emulator->settings.get<Emulator::SettingPIOConnected>().value) {
         // Don't overwrite LUTs if not connected, in case these have been set externally
@@ -172,6 +177,8 @@ void PCSX::Memory::reset() {
     const uint32_t bios_size = 0x00080000;
     const uint32_t exp1_size = 0x00040000;
     memset(m_wram, 0, 0x00800000);
+    m_rawPointerExposed = false;
+    markAllDirty();
     memset(m_exp1, 0xff, exp1_size);
     memset(m_bios, 0, bios_size);
     static const uint32_t nobios[6] = {
@@ -260,165 +267,147 @@ void PCSX::Memory::shutdown() {
     free(m_hard);
     free(m_bios);
 
+    freeMsan();
+
     free(m_readLUT);
     free(m_writeLUT);
+    free(m_readPages);
+    free(m_writePages);
+    free(m_watchedPages);
+    m_readLUT = nullptr;
+    m_writeLUT = nullptr;
+    m_readPages = nullptr;
+    m_writePages = nullptr;
+    m_watchedPages = nullptr;
+}
 
-    free(m_msanRAM);
-    free(m_msanUsableBitmap);
-    free(m_msanInitializedBitmap);
-    m_msanRAM = nullptr;
-    m_msanUsableBitmap = nullptr;
-    m_msanInitializedBitmap = nullptr;
-    m_msanAllocs.clear();
+namespace {
+
+template <unsigned width>
+uint32_t loadLE(const uint8_t *ptr) {
+    if constexpr (width == 1) {
+        return *ptr;
+    } else if constexpr (width == 2) {
+        return SWAP_LEu16(*(const uint16_t *)ptr);
+    } else {
+        return SWAP_LEu32(*(const uint32_t *)ptr);
+    }
+}
+
+template <unsigned width>
+void storeLE(uint8_t *ptr, uint32_t value) {
+    if constexpr (width == 1) {
+        *ptr = static_cast<uint8_t>(value);
+    } else if constexpr (width == 2) {
+        *(uint16_t *)ptr = SWAP_LEu16(static_cast<uint16_t>(value));
+    } else {
+        *(uint32_t *)ptr = SWAP_LEu32(value);
+    }
 }
 
+}  // namespace
+
 uint8_t PCSX::Memory::read8(uint32_t address) {
     g_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
-    const auto pointer = (uint8_t *)m_readLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const auto pointer = m_readLUT[page];
 
-    if (pointer != nullptr) {
-        if (msanInitialized() && inMsanRange(address)) [[unlikely]] {
-            switch (msanGetStatus<1>(address)) {
-                case MsanStatus::UNINITIALIZED:
-                    g_system->log(LogClass::CPU, _("8-bit read from usable but uninitialized msan memory: %8.8lx\n"),
-                                  address);
-                    break;
-                case MsanStatus::UNUSABLE:
-                    g_system->log(LogClass::CPU, _("8-bit read from unusable msan memory: %8.8lx\n"), address);
-                    break;
-                case MsanStatus::OK:
-                    return m_msanRAM[address - c_msanStart];
-            }
-            g_system->pause();
-            return 0;
-        }
-        [[likely]];
-        const uint32_t offset = address & 0xffff;
-        return *(pointer + offset);
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            return m_hard[address & 0x3ff];
-        } else {
-            return g_emulator->m_hw->read8(address);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        return g_emulator->m_pioCart->read8(address);
-    } else if (sendReadToLua(address, 1)) {
-        auto L = *g_emulator->m_lua;
-        const uint8_t ret = L.tonumber();
-        L.pop();
-        return ret;
-    } else if (address == 0x1f000004 || address == 0x1f000084) {
-        // EXP1 not mapped, likely the bios looking for pre/post boot entry point
-        // We probably don't want to pause here so just throw it a dummy value
-        return 0xff;
-    } else if (isiCacheEnabled()) {
-        g_system->log(LogClass::CPU, _("8-bit read from unknown address: %8.8lx\n"), address);
-        if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-            g_system->pause();
-        }
+    if (m_readPages[page] == PageKind::Direct && pointer != nullptr) [[likely]] {
+        return loadLE<1>(pointer + (address & 0xffff));
     }
-    return 0xff;
+    return readHandler<1>(address);
 }
 
 uint16_t PCSX::Memory::read16(uint32_t address) {
     g_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
-    const auto pointer = (uint8_t *)m_readLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const auto pointer = m_readLUT[page];
 
-    if (pointer != nullptr) {
-        if (msanInitialized() && inMsanRange(address)) {
-            switch (msanGetStatus<2>(address)) {
-                case MsanStatus::UNINITIALIZED:
-                    g_system->log(LogClass::CPU, _("16-bit read from usable but uninitialized msan memory: %8.8lx\n"),
-                                  address);
-                    break;
-                case MsanStatus::UNUSABLE:
-                    g_system->log(LogClass::CPU, _("16-bit read from unusable msan memory: %8.8lx\n"), address);
-                    break;
-                case MsanStatus::OK:
-                    return SWAP_LEu16(*(uint16_t *)&m_msanRAM[address - c_msanStart]);
-            }
-            g_system->pause();
-            return 0;
-        }
-        [[likely]];
-        const uint32_t offset = address & 0xffff;
-        return SWAP_LEu16(*(uint16_t *)(pointer + offset));
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            uint16_t *ptr = (uint16_t *)&m_hard[address & 0x3ff];
-            return SWAP_LEu16(*ptr);
-        } else {
-            return g_emulator->m_hw->read16(address);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        return g_emulator->m_pioCart->read8(address);
-    } else if (sendReadToLua(address, 2)) {
-        auto L = *g_emulator->m_lua;
-        const uint16_t ret = L.tonumber();
-        L.pop();
-        return ret;
-    } else if (isiCacheEnabled()) {
-        g_system->log(LogClass::CPU, _("16-bit read from unknown address: %8.8lx\n"), address);
-        if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-            g_system->pause();
-        }
+    if (m_readPages[page] == PageKind::Direct && pointer != nullptr) [[likely]] {
+        return loadLE<2>(pointer + (address & 0xffff));
     }
-    return 0xffff;
+    return readHandler<2>(address);
 }
 
 uint32_t PCSX::Memory::read32(uint32_t address, ReadType readType) {
     if (readType == ReadType::Data) g_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
-    const auto pointer = (uint8_t *)m_readLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const auto pointer = m_readLUT[page];
 
-    if (pointer != nullptr) {
-        if (msanInitialized() && inMsanRange(address)) {
-            switch (msanGetStatus<4>(address)) {
+    if (m_readPages[page] == PageKind::Direct && pointer != nullptr) [[likely]] {
+        return loadLE<4>(pointer + (address & 0xffff));
+    }
+    return readHandler<4>(address, readType == ReadType::Instr);
+}
+
+template <unsigned width>
+uint32_t PCSX::Memory::readHandler(uint32_t address, bool instruction) {
+    const uint32_t page = address >> 16;
+    if ((m_watchedPages[page] & c_watchRead) && !instruction) checkWatchpoint(address, width, false);
+    switch (m_readPages[page]) {
+        case PageKind::Direct:
+            break;
+        case PageKind::Watch:
+            if (m_readLUT[page] != nullptr) return loadLE<width>(m_readLUT[page] + (address & 0xffff));
+            break;
+        case PageKind::Msan:
+            switch (msanGetStatus<width>(address)) {
                 case MsanStatus::UNINITIALIZED:
-                    g_system->log(LogClass::CPU, _("32-bit read from usable but uninitialized msan memory: %8.8lx\n"),
-                                  address);
+                    g_system->log(LogClass::CPU, _("%u-bit read from usable but uninitialized msan memory: %8.8lx\n"),
+                                  width * 8, address);
                     break;
                 case MsanStatus::UNUSABLE:
-                    g_system->log(LogClass::CPU, _("32-bit read from unusable msan memory: %8.8lx\n"), address);
+                    g_system->log(LogClass::CPU, _("%u-bit read from unusable msan memory: %8.8lx\n"), width * 8,
+                                  address);
                     break;
                 case MsanStatus::OK:
-                    return SWAP_LEu32(*(uint32_t *)&m_msanRAM[address - c_msanStart]);
+                    return loadLE<width>(&m_msanRAM[address - c_msanStart]);
             }
             g_system->pause();
             return 0;
-        }
-        [[likely]];
-        const uint32_t offset = address & 0xffff;
-        return SWAP_LEu32(*(uint32_t *)(pointer + offset));
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            uint32_t *ptr = (uint32_t *)&m_hard[address & 0x3ff];
-            return SWAP_LEu32(*ptr);
-        } else {
-            return g_emulator->m_hw->read32(address);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        return g_emulator->m_pioCart->read32(address);
-    } else if (address == 0xfffe0130) {
-        return m_BIU;
-    } else if (sendReadToLua(address, 4)) {
+        case PageKind::Hardware:
+            if ((address & 0xffff) < 0x400) return loadLE<width>(&m_hard[address & 0x3ff]);
+            if constexpr (width == 1) {
+                return g_emulator->m_hw->read8(address);
+            } else if constexpr (width == 2) {
+                return g_emulator->m_hw->read16(address);
+            } else {
+                return g_emulator->m_hw->read32(address);
+            }
+        case PageKind::PIO:
+            if constexpr (width == 1) {
+                return g_emulator->m_pioCart->read8(address);
+            } else if constexpr (width == 2) {
+                return g_emulator->m_pioCart->read16(address);
+            } else {
+                return g_emulator->m_pioCart->read32(address);
+            }
+        case PageKind::Control:
+            if (width == 4 && address == 0xfffe0130) return m_BIU;
+            break;
+    }
+    return readUnknown<width>(address);
+}
+
+template <unsigned width>
+uint32_t PCSX::Memory::readUnknown(uint32_t address) {
+    constexpr uint32_t allOnes = 0xffffffff >> (32 - width * 8);
+    if (sendReadToLua(address, width)) {
         auto L = *g_emulator->m_lua;
         const uint32_t ret = L.tonumber();
         L.pop();
-        return ret;
+        return ret & allOnes;
+    } else if (width == 1 && (address == 0x1f000004 || address == 0x1f000084)) {
+        // EXP1 not mapped, likely the bios looking for pre/post boot entry point
+        // We probably don't want to pause here so just throw it a dummy value
+        return allOnes;
     } else if (isiCacheEnabled()) {
-        g_system->log(LogClass::CPU, _("32-bit read from unknown address: %8.8lx\n"), address);
+        g_system->log(LogClass::CPU, _("%u-bit read from unknown address: %8.8lx\n"), width * 8, address);
         if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
             g_system->pause();
         }
     }
-    return 0xffffffff;
+    return allOnes;
 }
 
 int PCSX::Memory::sendReadToLua(const uint32_t address, const size_t size) {
@@ -498,134 +487,151 @@ bool PCSX::Memory::sendWriteToLua(const uint32_t address, const size_t size, uin
 void PCSX::Memory::write8(uint32_t address, uint32_t value) {
     g_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
-    const auto pointer = (uint8_t *)m_writeLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const auto pointer = m_writeLUT[page];
 
-    if (pointer != nullptr) {
-        if (msanInitialized() && inMsanRange(address)) {
-            if (msanValidateWrite<1>(address)) {
-                m_msanRAM[address - c_msanStart] = value;
-            } else {
-                g_system->log(LogClass::CPU, _("8-bit write to unusable msan memory: %8.8lx\n"), address);
-                g_system->pause();
-            }
-        }
-        [[likely]];
-        const uint32_t offset = address & 0xffff;
-        *(pointer + offset) = static_cast<uint8_t>(value);
-        g_emulator->m_cpu->Clear((address & (~3)), 1);
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            m_hard[address & 0x3ff] = value;
-        } else {
-            g_emulator->m_hw->write8(address, value);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        g_emulator->m_pioCart->write8(address, value);
-    } else if (sendWriteToLua(address, 1, value)) {
-    } else if (isiCacheEnabled()) {
-        g_emulator->m_cpu->Clear(address, 1);
-        g_system->log(LogClass::CPU, _("8-bit write to unknown address: %8.8lx\n"), address);
-        if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-            g_system->pause();
-        }
+    if (m_writePages[page] == PageKind::Direct && pointer != nullptr) [[likely]] {
+        storeLE<1>(pointer + (address & 0xffff), value);
+        markWritten(pointer + (address & 0xffff));
+        g_emulator->m_cpu->clearIfCode((address & (~3)), 1);
+        return;
     }
+    writeHandler<1>(address, value);
 }
 
 void PCSX::Memory::write16(uint32_t address, uint32_t value) {
     g_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
-    const auto pointer = (uint8_t *)m_writeLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const auto pointer = m_writeLUT[page];
 
-    if (pointer != nullptr) {
-        if (msanInitialized() && inMsanRange(address)) {
-            if (msanValidateWrite<2>(address)) {
-                *(uint16_t *)&m_msanRAM[address - c_msanStart] = SWAP_LEu16(value);
-            } else {
-                g_system->log(LogClass::CPU, _("16-bit write to unusable msan memory: %8.8lx\n"), address);
-                g_system->pause();
-            }
-        }
-        [[likely]];
-        const uint32_t offset = address & 0xffff;
-        *(uint16_t *)(pointer + offset) = SWAP_LEu16(static_cast<uint16_t>(value));
-        g_emulator->m_cpu->Clear((address & (~3)), 1);
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            uint16_t *ptr = (uint16_t *)&m_hard[address & 0x3ff];
-            *ptr = SWAP_LEu16(value);
-        } else {
-            g_emulator->m_hw->write16(address, value);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        g_emulator->m_pioCart->write16(address, value);
-    } else if (sendWriteToLua(address, 2, value)) {
-    } else if (isiCacheEnabled()) {
-        g_emulator->m_cpu->Clear(address, 1);
-        g_system->log(LogClass::CPU, _("16-bit write to unknown address: %8.8lx\n"), address);
-        if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-            g_system->pause();
-        }
+    if (m_writePages[page] == PageKind::Direct && pointer != nullptr) [[likely]] {
+        storeLE<2>(pointer + (address & 0xffff), value);
+        markWritten(pointer + (address & 0xffff));
+        g_emulator->m_cpu->clearIfCode((address & (~3)), 1);
+        return;
     }
+    writeHandler<2>(address, value);
 }
 
 void PCSX::Memory::write32(uint32_t address, uint32_t value) {
     g_emulator->m_cpu->m_regs.cycle += 1;
     const uint32_t page = address >> 16;
-    const auto pointer = (uint8_t *)m_writeLUT[page];
-    const bool pioConnected = g_emulator->settings.get<Emulator::SettingPIOConnected>().value;
+    const auto pointer = m_writeLUT[page];
+
+    if (m_writePages[page] == PageKind::Direct && pointer != nullptr) [[likely]] {
+        storeLE<4>(pointer + (address & 0xffff), value);
+        markWritten(pointer + (address & 0xffff));
+        g_emulator->m_cpu->clearIfCode((address & (~3)), 1);
+        return;
+    }
+    writeHandler<4>(address, value);
+}
 
-    if (pointer != nullptr) {
-        if (msanInitialized() && inMsanRange(address)) {
-            if (msanValidateWrite<4>(address)) {
-                *(uint32_t *)&m_msanRAM[address - c_msanStart] = SWAP_LEu32(value);
+template <unsigned width>
+void PCSX::Memory::writeHandler(uint32_t address, uint32_t value) {
+    const uint32_t page = address >> 16;
+    if (m_watchedPages[page] & c_watchWrite) checkWatchpoint(address, width, true);
+    switch (m_writePages[page]) {
+        case PageKind::Direct:
+            break;
+        case PageKind::Watch:
+            if (m_writeLUT[page] != nullptr) {
+                storeLE<width>(m_writeLUT[page] + (address & 0xffff), value);
+                markWritten(m_writeLUT[page] + (address & 0xffff));
+                g_emulator->m_cpu->clearIfCode((address & (~3)), 1);
+                return;
+            }
+            break;
+        case PageKind::Msan:
+            if (msanValidateWrite<width>(address)) {
+                storeLE<width>(&m_msanRAM[address - c_msanStart], value);
+                g_emulator->m_cpu->clearIfCode((address & (~3)), 1);
             } else {
-                g_system->log(LogClass::CPU, _("32-bit write to unusable msan memory: %8.8lx\n"), address);
+                g_system->log(LogClass::CPU, _("%u-bit write to unusable msan memory: %8.8lx\n"), width * 8, address);
                 g_system->pause();
             }
-        }
-        [[likely]];
-        const uint32_t offset = address & 0xffff;
-        *(uint32_t *)(pointer + offset) = SWAP_LEu32(value);
-        g_emulator->m_cpu->Clear((address & (~3)), 1);
-    } else if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
-        if ((address & 0xffff) < 0x400) {
-            uint32_t *ptr = (uint32_t *)&m_hard[address & 0x3ff];
-            *ptr = SWAP_LEu32(value);
-        } else {
-            g_emulator->m_hw->write32(address, value);
-        }
-    } else if ((page & 0x1fff) >= 0x1f00 && (page & 0x1fff) < 0x1f80 && pioConnected) {
-        g_emulator->m_pioCart->write32(address, value);
-    } else if (address == 0xfffe0130) {
-        m_BIU = value;
-        switch (value) {
-            case 0x00000800:
-            case 0x00000804:
-            case 0x0001e90c:  // TOCA World Touring Cars, SLES-02572, FlushCache at 0xa002f79c
-                g_emulator->m_cpu->invalidateCache();
-                [[fallthrough]];
-            case 0x0001e988:
-                setLuts();
-                break;
-            default:
-                g_system->log(LogClass::CPU, _("Unknown BIU value: %8.8lx\n"), value);
-                if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
-                    g_system->pause();
-                }
-                break;
-        }
-    } else if (sendWriteToLua(address, 4, value)) {
+            return;
+        case PageKind::Hardware:
+            if ((address & 0xffff) < 0x400) {
+                storeLE<width>(&m_hard[address & 0x3ff], value);
+            } else if constexpr (width == 1) {
+                g_emulator->m_hw->write8(address, value);
+            } else if constexpr (width == 2) {
+                g_emulator->m_hw->write16(address, value);
+            } else {
+                g_emulator->m_hw->write32(address, value);
+            }
+            return;
+        case PageKind::PIO:
+            if constexpr (width == 1) {
+                g_emulator->m_pioCart->write8(address, value);
+            } else if constexpr (width == 2) {
+                g_emulator->m_pioCart->write16(address, value);
+            } else {
+                g_emulator->m_pioCart->write32(address, value);
+            }
+            return;
+        case PageKind::Control:
+            if (width == 4 && address == 0xfffe0130) {
+                writeBIU(value);
+                return;
+            }
+            break;
+    }
+    writeUnknown<width>(address, value);
+}
+
+template <unsigned width>
+void PCSX::Memory::writeUnknown(uint32_t address, uint32_t value) {
+    if (sendWriteToLua(address, width, value)) {
     } else if (isiCacheEnabled()) {
         g_emulator->m_cpu->Clear(address, 1);
-        g_system->log(LogClass::CPU, _("32-bit write to unknown address: %8.8lx\n"), address);
+        g_system->log(LogClass::CPU, _("%u-bit write to unknown address: %8.8lx\n"), width * 8, address);
         if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
             g_system->pause();
         }
     }
 }
 
+void PCSX::Memory::writeBIU(uint32_t value) {
+    m_BIU = value;
+    switch (value) {
+        case 0x00000800:
+        case 0x00000804:
+        case 0x0001e90c:  // TOCA World Touring Cars, SLES-02572, FlushCache at 0xa002f79c
+            g_emulator->m_cpu->invalidateCache();
+            [[fallthrough]];
+        case 0x0001e988:
+            setLuts();
+            break;
+        default:
+            g_system->log(LogClass::CPU, _("Unknown BIU value: %8.8lx\n"), value);
+            if (g_emulator->settings.get<Emulator::SettingDebugSettings>().get<Emulator::DebugSettings::Debug>()) {
+                g_system->pause();
+            }
+            break;
+    }
+}
+
+void PCSX::Memory::markDirty(const void *pointer, size_t size) {
+    if (size == 0) return;
+    const auto start = reinterpret_cast<const uint8_t *>(pointer) - m_wram;
+    const auto end = start + ptrdiff_t(size);
+    if ((end <= 0) || (start >= 0x00800000)) return;
+    const auto low = std::max(start, ptrdiff_t(0));
+    const auto high = std::min(end, ptrdiff_t(0x00800000));
+    memset(m_dirtyPages + (low >> c_dirtyPageShift), 1, ((high - 1) >> c_dirtyPageShift) - (low >> c_dirtyPageShift) + 1);
+    // These writes didn't go through the CPU, which may be holding on to what was there before.
+    const auto aligned = low & ~ptrdiff_t(3);
+    g_emulator->m_cpu->clearIfCode(uint32_t(aligned), uint32_t((high - aligned + 3) / 4));
+}
+
+void PCSX::Memory::exposeRawPointer() {
+    // The CPU can't be told about these writes, so it has to stop caching anything decoded out of RAM.
+    if (!m_rawPointerExposed) g_emulator->m_cpu->invalidateCache();
+    m_rawPointerExposed = true;
+    markAllDirty();
+}
+
 const void *PCSX::Memory::pointerRead(uint32_t address) {
     const auto page = address >> 16;
 
@@ -676,6 +682,7 @@ const void *PCSX::Memory::pointerRead(uint32_t address) {
 
 const void *PCSX::Memory::pointerWrite(uint32_t address, int size) {
     const auto page = address >> 16;
+    if (m_watchedPages[page] & c_watchWrite) return nullptr;
 
     if (page == 0x1f80 || page == 0x9f80 || page == 0xbf80) {
         if ((address & 0xffff) < 0x400)
@@ -811,19 +818,85 @@ void PCSX::Memory::MemoryAsFile::writeBlock(const void *src, size_t size, size_t
     auto offset = ptr % c_blockSize;
     auto toCopy = std::min(size, c_blockSize - offset);
     memcpy(block + offset, src, toCopy);
+    m_memory->markDirty(block + offset, toCopy);
 }
 
-void PCSX::Memory::initMsan(bool reset) {
-    if (reset) {
-        free(m_msanRAM);
-        free(m_msanUsableBitmap);
-        free(m_msanInitializedBitmap);
-        m_msanRAM = nullptr;
-        m_msanUsableBitmap = nullptr;
-        m_msanInitializedBitmap = nullptr;
-        m_msanAllocs.clear();
-        m_msanChainRegistry.clear();
+void PCSX::Memory::setPIOPages(bool connected) {
+    // The PIO region is mirrored in every segment, including the ones MSAN takes over while it is enabled.
+    // Pages the cart maps straight into the LUTs stay direct.
+    for (uint32_t segment = 0; segment < 0x10000; segment += 0x2000) {
+        for (uint32_t page = segment + 0x1f00; page < segment + 0x1f80; page++) {
+            if (m_readPages[page] == PageKind::Msan) continue;
+            m_readPages[page] = connected && !m_readLUT[page] ? PageKind::PIO : directKind(page, c_watchRead);
+            m_writePages[page] = connected && !m_writeLUT[page] ? PageKind::PIO : directKind(page, c_watchWrite);
+        }
+    }
+}
+
+void PCSX::Memory::setMsanPages(bool enabled) {
+    if (!m_readLUT) return;
+    for (uint32_t segment = c_msanStart; segment < c_msanEnd; segment += 0x10000) {
+        const uint32_t page = segment >> 16;
+        m_readLUT[page] = enabled ? m_msanRAM + (segment - c_msanStart) : nullptr;
+        m_writeLUT[page] = enabled ? m_msanRAM + (segment - c_msanStart) : nullptr;
+        m_readPages[page] = enabled ? PageKind::Msan : directKind(page, c_watchRead);
+        m_writePages[page] = enabled ? PageKind::Msan : directKind(page, c_watchWrite);
+    }
+    if (!enabled) setPIOPages(g_emulator->settings.get<Emulator::SettingPIOConnected>().value);
+}
+
+void PCSX::Memory::watchRange(uint32_t address, uint32_t width, bool write) {
+    if (!m_watchedPages || width == 0) return;
+    const uint8_t flag = write ? c_watchWrite : c_watchRead;
+    const uint32_t first = (address & 0x1fffffff) >> 16;
+    const uint32_t last = ((address & 0x1fffffff) + width - 1) >> 16;
+    for (uint32_t page = first; page <= last && page < 0x2000; page++) {
+        // Main RAM pages get all of their mirrors watched, whatever the size of the RAM is. The breakpoint checks
+        // will sort out which ones actually matter, and unwatch the others on their first access.
+        const uint32_t mirrors = page < 0x80 ? 4 : 1;
+        for (uint32_t mirror = 0; mirror < mirrors; mirror++) {
+            const uint32_t physical = page < 0x80 ? (page & 0x1f) + mirror * 0x20 : page;
+            for (uint32_t segment : {0x0000, 0x8000, 0xa000}) watchPage(segment | physical, flag);
+        }
+    }
+}
+
+void PCSX::Memory::watchPage(uint32_t page, uint8_t flag) {
+    if (m_watchedPages[page] & flag) return;
+    m_watchedPages[page] |= flag;
+    auto &kind = flag == c_watchWrite ? m_writePages[page] : m_readPages[page];
+    if (kind == PageKind::Direct) kind = PageKind::Watch;
+    // The dynarec may have compiled direct accesses to constant addresses in this page.
+    if (g_emulator->m_cpu->isDynarec()) g_emulator->m_cpu->invalidateCache();
+}
+
+void PCSX::Memory::unwatchPage(uint32_t page, uint8_t flag) {
+    m_watchedPages[page] &= ~flag;
+    auto &kind = flag == c_watchWrite ? m_writePages[page] : m_readPages[page];
+    if (kind == PageKind::Watch) kind = PageKind::Direct;
+}
+
+void PCSX::Memory::checkWatchpoint(uint32_t address, unsigned width, bool write) {
+    const auto type = write ? Debug::BreakpointType::Write : Debug::BreakpointType::Read;
+    if (!g_emulator->m_debug->checkWatchpoint(address, type, width)) {
+        unwatchPage(address >> 16, write ? c_watchWrite : c_watchRead);
     }
+}
+
+void PCSX::Memory::freeMsan() {
+    if (msanInitialized()) setMsanPages(false);
+    free(m_msanRAM);
+    free(m_msanUsableBitmap);
+    free(m_msanInitializedBitmap);
+    m_msanRAM = nullptr;
+    m_msanUsableBitmap = nullptr;
+    m_msanInitializedBitmap = nullptr;
+    m_msanAllocs.clear();
+    m_msanChainRegistry.clear();
+}
+
+void PCSX::Memory::initMsan(bool reset) {
+    if (reset) freeMsan();
     if (msanInitialized()) {
         g_system->printf(_("MSAN system was already initialized.\n"));
         g_system->pause();
@@ -835,10 +908,7 @@ void PCSX::Memory::initMsan(bool reset) {
     m_msanUsableBitmap = (uint8_t *)calloc(c_msanSize / 8, 1);
     m_msanInitializedBitmap = (uint8_t *)calloc(c_msanSize / 8, 1);
     m_msanPtr = 1024;
-    for (uint32_t segment = c_msanStart; segment < c_msanEnd; segment += 0x10000) {
-        m_readLUT[segment >> 16] = m_msanRAM + (segment - c_msanStart);
-        m_writeLUT[segment >> 16] = m_msanRAM + (segment - c_msanStart);
-    }
+    setMsanPages(true);
 }
 
 uint32_t PCSX::Memory::msanAlloc(uint32_t size) {
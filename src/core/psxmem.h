@@ -62,6 +62,20 @@ class Memory {
 
     void setLuts();
 
+    // What backs each 64KB page of the address space, besides the read and write LUTs. Direct pages are served
+    // from the LUT pointer when there is one, and fall back to the unknown address handling otherwise. The other
+    // kinds are only installed while the corresponding device is present, so the accessors never have to test
+    // for them on the fast path. Watch is a direct page with a memory breakpoint somewhere in it.
+    enum class PageKind : uint8_t { Direct, Msan, Hardware, PIO, Control, Watch };
+    void setPIOPages(bool connected);
+
+    // Sends accesses to the pages covering this range through the breakpoint checks, until an access finds no
+    // breakpoint of that type left in its page.
+    void watchRange(uint32_t address, uint32_t width, bool write);
+    bool isWatched(uint32_t address, bool write) const {
+        return m_watchedPages[address >> 16] & (write ? c_watchWrite : c_watchRead);
+    }
+
     enum class ReadType { Data, Instr };
 
     uint8_t read8(uint32_t address);
@@ -73,6 +87,28 @@ class Memory {
     const void *pointerRead(uint32_t address);
     const void *pointerWrite(uint32_t address, int size);
 
+    // Main RAM is tracked in 4KB pages, flagged by everything that writes to it: the accessors above, the stores
+    // the recompilers inline, the DMA channels, and the debugging tools. Incremental save states only carry the pages
+    // flagged since clearDirtyPages was last called. Anything outside of RAM is ignored.
+    static constexpr unsigned c_dirtyPageShift = 12;
+    static constexpr unsigned c_dirtyPageCount = 0x00800000 >> c_dirtyPageShift;
+    // For writers which bypass the CPU. Anything it cached from the range gets dropped as well.
+    void markDirty(const void *pointer, size_t size);
+    void markAllDirty() { memset(m_dirtyPages, 1, sizeof(m_dirtyPages)); }
+    // Once a raw pointer to RAM was handed out, writes through it can happen at any time, so every page stays dirty.
+    // Whoever holds one isn't expected to keep using it past a hard reset or a state load, which both end this.
+    // Nothing decoded out of RAM got cached by the CPU in the meantime, so there's nothing for it to drop then.
+    void clearDirtyPages() { memset(m_dirtyPages, m_rawPointerExposed ? 1 : 0, sizeof(m_dirtyPages)); }
+    void exposeRawPointer();
+    bool rawPointerExposed() const { return m_rawPointerExposed; }
+    const uint8_t *getDirtyPages() const { return m_dirtyPages; }
+    // The flag to set when storing to a host pointer obtained from pointerWrite, or nullptr if it isn't into RAM.
+    uint8_t *dirtyFlag(const void *pointer) {
+        const auto offset = reinterpret_cast<const uint8_t *>(pointer) - m_wram;
+        if ((offset < 0) || (offset >= 0x00800000)) return nullptr;
+        return &m_dirtyPages[offset >> c_dirtyPageShift];
+    }
+
     static constexpr uint16_t ISTAT = 0x1070;
     static constexpr uint16_t IMASK = 0x1074;
 
@@ -303,6 +339,28 @@ class Memory {
 
     uint32_t m_BIU = 0;
 
+    template <unsigned width>
+    uint32_t readHandler(uint32_t address, bool instruction = false);
+    template <unsigned width>
+    void writeHandler(uint32_t address, uint32_t value);
+    template <unsigned width>
+    uint32_t readUnknown(uint32_t address);
+    template <unsigned width>
+    void writeUnknown(uint32_t address, uint32_t value);
+    void writeBIU(uint32_t value);
+    void checkWatchpoint(uint32_t address, unsigned width, bool write);
+    void watchPage(uint32_t page, uint8_t flag);
+    void unwatchPage(uint32_t page, uint8_t flag);
+    PageKind directKind(uint32_t page, uint8_t flag) const {
+        return m_watchedPages[page] & flag ? PageKind::Watch : PageKind::Direct;
+    }
+    void setMsanPages(bool enabled);
+    void freeMsan();
+    // The write LUT only ever maps RAM, so whatever it points to has a page to flag.
+    void markWritten(const uint8_t *pointer) { m_dirtyPages[(pointer - m_wram) >> c_dirtyPageShift] = 1; }
+    uint8_t m_dirtyPages[c_dirtyPageCount] = {};
+    bool m_rawPointerExposed = false;
+
     // hopefully this should become private eventually, with only certain classes having direct access.
   public:
     uint8_t *m_wram = nullptr;  // Kernel & User Memory (8 Meg)
@@ -312,6 +370,11 @@ class Memory {
 
     uint8_t **m_writeLUT = nullptr;
     uint8_t **m_readLUT = nullptr;
+    PageKind *m_writePages = nullptr;
+    PageKind *m_readPages = nullptr;
+    static constexpr uint8_t c_watchRead = 1;
+    static constexpr uint8_t c_watchWrite = 2;
+    uint8_t *m_watchedPages = nullptr;
 
     static constexpr uint32_t c_msanSize = 1'610'612'736;
     static constexpr uint32_t c_msanStart = 0x20000000;
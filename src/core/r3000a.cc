@@ -29,6 +29,7 @@
 #include "core/debug.h"
 #include "core/gpu.h"
 #include "core/gte.h"
+#include "core/guest-profiler.h"
 #include "core/mdec.h"
 #include "core/pgxp_mem.h"
 #include "core/sio.h"
@@ -46,6 +47,10 @@ int PCSX::R3000Acpu::psxInit() {
         g_emulator->m_cpu = Cpus::DynaRec();
     }
 
+    if (!g_emulator->m_cpu && g_emulator->settings.get<Emulator::SettingThreadedInterpreter>()) {
+        g_emulator->m_cpu = Cpus::InterpretedThreaded();
+    }
+
     if (!g_emulator->m_cpu) g_emulator->m_cpu = Cpus::Interpreted();
 
     PGXP_Init();
@@ -328,6 +333,18 @@ void PCSX::R3000Acpu::restorePCdrvFile(const std::filesystem::path& filename, ui
     }
 }
 
+void PCSX::R3000Acpu::updateNextEventCycle() {
+    m_regs.nextEventCycle = m_events.nextEventCycle(g_emulator->m_counters->m_psxNextCounter);
+}
+
+void PCSX::R3000Acpu::rescheduleEvents() {
+    m_events.clear();
+    for (unsigned i = 0; i < 32; i++) {
+        if (m_regs.interrupt & (1 << i)) m_events.schedule(i, m_regs.intTargets[i]);
+    }
+    updateNextEventCycle();
+}
+
 void PCSX::R3000Acpu::branchTest() {
 #if 0
     if( SPU_async )
@@ -354,49 +371,43 @@ void PCSX::R3000Acpu::branchTest() {
 
     const uint64_t cycle = m_regs.cycle;
 
-    if (cycle >= g_emulator->m_counters->m_psxNextCounter) g_emulator->m_counters->update();
+    if (g_emulator->m_guestProfiler->due(cycle)) g_emulator->m_guestProfiler->sample(m_regs.pc, cycle);
 
     if (m_regs.spuInterrupt.exchange(false)) g_emulator->m_spu->interrupt();
 
-    const uint32_t interrupts = m_regs.interrupt;
-
-    int32_t lowestDistance = std::numeric_limits<int64_t>::max();
-    uint64_t lowestTarget = cycle;
-    uint64_t* targets = m_regs.intTargets;
-
-    if ((interrupts != 0) && (m_regs.lowestTarget < cycle)) {
-#define checkAndUpdate(irq, act)                                                          \
+    if (cycle >= m_regs.nextEventCycle) {
+        if (cycle >= g_emulator->m_counters->m_psxNextCounter) g_emulator->m_counters->update();
+        if (m_events.nextTarget() < cycle) {
+            // Pull everything that's due out of the queue before firing anything, so that an event rescheduled by
+            // one of the handlers waits for the next pass. Then fire them in a fixed order, independent from their
+            // deadlines, so that simultaneous events always resolve the same way.
+            uint32_t due = 0;
+            while (m_events.nextTarget() <= cycle) due |= 1u << m_events.pop();
+#define fireIfDue(irq, act)                                                               \
     {                                                                                     \
         constexpr uint32_t mask = 1 << irq;                                               \
-        if ((interrupts & mask) != 0) {                                                   \
-            uint64_t target = targets[irq];                                               \
-            int64_t dist = target - cycle;                                                \
-            if (dist > 0) {                                                               \
-                if (lowestDistance > dist) {                                              \
-                    lowestDistance = dist;                                                \
-                    lowestTarget = target;                                                \
-                }                                                                         \
-            } else {                                                                      \
-                m_regs.interrupt &= ~mask;                                                \
-                PSXIRQ_LOG("Triggering interrupt %08x\n", magic_enum::enum_integer(irq)); \
-                act();                                                                    \
-            }                                                                             \
+        if ((due & mask) && (m_regs.interrupt & mask) && !m_events.pending(irq)) {        \
+            m_regs.interrupt &= ~mask;                                                    \
+            PSXIRQ_LOG("Triggering interrupt %08x\n", magic_enum::enum_integer(irq));     \
+            act();                                                                        \
         }                                                                                 \
     }
-        checkAndUpdate(PSXINT_SIO, g_emulator->m_sio->interrupt);
-        checkAndUpdate(PSXINT_SIO1, g_emulator->m_sio1->interrupt);
-        checkAndUpdate(PSXINT_CDR, g_emulator->m_cdrom->interrupt);
-        checkAndUpdate(PSXINT_CDREAD, g_emulator->m_cdrom->readInterrupt);
-        checkAndUpdate(PSXINT_GPUDMA, GPU::gpuInterrupt);
-        checkAndUpdate(PSXINT_MDECOUTDMA, g_emulator->m_mdec->mdec1Interrupt);
-        checkAndUpdate(PSXINT_SPUDMA, spuInterrupt);
-        checkAndUpdate(PSXINT_MDECINDMA, g_emulator->m_mdec->mdec0Interrupt);
-        checkAndUpdate(PSXINT_GPUOTCDMA, gpuotcInterrupt);
-        checkAndUpdate(PSXINT_CDRDMA, g_emulator->m_cdrom->dmaInterrupt);
-        checkAndUpdate(PSXINT_CDRPLAY, g_emulator->m_cdrom->playInterrupt);
-        checkAndUpdate(PSXINT_CDRDBUF, g_emulator->m_cdrom->decodedBufferInterrupt);
-        checkAndUpdate(PSXINT_CDRLID, g_emulator->m_cdrom->lidSeekInterrupt);
-        m_regs.lowestTarget = lowestTarget;
+            fireIfDue(PSXINT_SIO, g_emulator->m_sio->interrupt);
+            fireIfDue(PSXINT_SIO1, g_emulator->m_sio1->interrupt);
+            fireIfDue(PSXINT_CDR, g_emulator->m_cdrom->interrupt);
+            fireIfDue(PSXINT_CDREAD, g_emulator->m_cdrom->readInterrupt);
+            fireIfDue(PSXINT_GPUDMA, GPU::gpuInterrupt);
+            fireIfDue(PSXINT_MDECOUTDMA, g_emulator->m_mdec->mdec1Interrupt);
+            fireIfDue(PSXINT_SPUDMA, spuInterrupt);
+            fireIfDue(PSXINT_MDECINDMA, g_emulator->m_mdec->mdec0Interrupt);
+            fireIfDue(PSXINT_GPUOTCDMA, gpuotcInterrupt);
+            fireIfDue(PSXINT_CDRDMA, g_emulator->m_cdrom->dmaInterrupt);
+            fireIfDue(PSXINT_CDRPLAY, g_emulator->m_cdrom->playInterrupt);
+            fireIfDue(PSXINT_CDRDBUF, g_emulator->m_cdrom->decodedBufferInterrupt);
+            fireIfDue(PSXINT_CDRLID, g_emulator->m_cdrom->lidSeekInterrupt);
+#undef fireIfDue
+        }
+        updateNextEventCycle();
     }
     auto& mem = g_emulator->m_mem;
     auto istat = mem->readHardwareRegister<Memory::ISTAT>();
@@ -428,6 +439,12 @@ std::unique_ptr<PCSX::R3000Acpu> PCSX::Cpus::Interpreted() {
     return nullptr;
 }
 
+std::unique_ptr<PCSX::R3000Acpu> PCSX::Cpus::InterpretedThreaded() {
+    std::unique_ptr<PCSX::R3000Acpu> cpu = getInterpretedThreaded();
+    if (cpu->Implemented()) return cpu;
+    return nullptr;
+}
+
 std::unique_ptr<PCSX::R3000Acpu> PCSX::Cpus::DynaRec() {
     std::unique_ptr<PCSX::R3000Acpu> cpu = getDynaRec();
     if (cpu->Implemented()) return cpu;
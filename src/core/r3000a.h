@@ -26,8 +26,12 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "core/event-scheduler.h"
 #include "core/kernel.h"
 #include "core/psxcounters.h"
 #include "core/psxemulator.h"
@@ -192,7 +196,8 @@ struct psxRegisters {
     uint32_t interrupt;
     std::atomic<bool> spuInterrupt;
     uint64_t intTargets[32];
-    uint64_t lowestTarget;
+    // The earliest cycle at which branchTest has something to do, be it root counters or scheduled interrupts.
+    uint64_t nextEventCycle;
     uint8_t iCacheAddr[0x1000];
     uint8_t iCacheCode[0x1000];
 };
@@ -276,6 +281,18 @@ class R3000Acpu {
 
     const std::string &getName() { return m_name; }
 
+    // Named counters describing what the CPU core has been up to, mostly for benchmarking purposes.
+    virtual std::vector<std::pair<std::string_view, uint64_t>> getStatistics() {
+        return {{"clearsSkipped", m_clearsSkipped},
+                {"idleLoopsSkipped", m_idleLoopsSkipped},
+                {"idleCyclesSkipped", m_idleCyclesSkipped}};
+    }
+    virtual void resetStatistics() {
+        m_clearsSkipped = 0;
+        m_idleLoopsSkipped = 0;
+        m_idleCyclesSkipped = 0;
+    }
+
     std::map<uint32_t, std::string> m_symbols;
 
     std::pair<const uint32_t, std::string> *findContainingSymbol(uint32_t addr);
@@ -303,6 +320,7 @@ class R3000Acpu {
     }
     void exception(uint32_t code, bool bd, bool cop0 = false);
     void branchTest();
+    void idleLoopBackEdge(uint32_t branchPC);
 
     void psxSetPGXPMode(uint32_t pgxpMode);
 
@@ -312,8 +330,17 @@ class R3000Acpu {
         uint64_t target = cycle + uint64_t(eCycle * m_interruptScales[interrupt]);
         m_regs.interrupt |= (1 << interrupt);
         m_regs.intTargets[interrupt] = target;
-        if (target < m_regs.lowestTarget) m_regs.lowestTarget = target;
+        m_events.schedule(interrupt, target);
+        updateNextEventCycle();
     }
+    void cancelInterrupt(unsigned interrupt) {
+        m_regs.interrupt &= ~(1 << interrupt);
+        m_events.cancel(interrupt);
+        updateNextEventCycle();
+    }
+    // Rebuilds the event queue out of the interrupt mask and targets, such as after loading a save state.
+    void rescheduleEvents();
+    void updateNextEventCycle();
 
     psxRegisters m_regs;
     float m_interruptScales[15] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
@@ -322,7 +349,10 @@ class R3000Acpu {
 
     virtual void Reset() {
         invalidateCache();
+        memset(m_codePages, 0, sizeof(m_codePages));
         m_regs.interrupt = 0;
+        m_regs.nextEventCycle = 0;
+        m_events.clear();
     }
     bool m_inISR = false;
     bool m_nextIsDelaySlot = false;
@@ -368,6 +398,21 @@ class R3000Acpu {
 
   protected:
     R3000Acpu(const std::string &name) : m_name(name) {}
+    static constexpr uint32_t c_codePagesRange = 0x800000;  // Physical RAM window, mirrors included
+    uint64_t m_codePages[(c_codePagesRange >> 12) / 64] = {};
+    uint64_t m_clearsSkipped = 0;
+
+    // Idle loop skipping, see idle-skip.cc. Loops are at most this many bytes from their head to their back edge.
+    static constexpr uint32_t c_idleLoopMaxBytes = 32;
+    enum class IdleLoop { NotIdle, UnsafeLoad, Idle };
+    IdleLoop analyseIdleLoop(uint32_t branchPC, uint32_t target);
+    bool idleSkipAllowed();
+    struct NotIdleLoop {
+        uint32_t branchPC = 0, branchCode = 0, headCode = 0;
+    };
+    NotIdleLoop m_notIdleLoops[256];
+    uint64_t m_idleLoopsSkipped = 0;
+    uint64_t m_idleCyclesSkipped = 0;
     static inline const uint32_t MASKS[7] = {0, 0xffffff, 0xffff, 0xff, 0xff000000, 0xffff0000, 0xffffff00};
     static inline const uint32_t LWL_MASK[4] = {0xffffff, 0xffff, 0xff, 0};
     static inline const uint32_t LWL_MASK_INDEX[4] = {1, 2, 3, 0};
@@ -450,6 +495,10 @@ Formula One 2001
         memset(m_regs.iCacheCode, 0xff, sizeof(m_regs.iCacheCode));
     }
 
+    // An execution breakpoint was added at this address. Cores which compile breakpoints into their code
+    // have to drop anything they compiled over it.
+    virtual void invalidateBreakpoint(uint32_t pc) {}
+
     inline void flushICacheLine(uint32_t pc) {
         uint32_t pcBank = pc >> 24;
         if (pcBank == 0x00 || pcBank == 0x80) {
@@ -492,6 +541,8 @@ Formula One 2001
                 pcOffset &= ~0xf;
                 pcCache &= ~0xf;
 
+                markCodePage(pcOffset);
+
                 // address line
                 *(uint32_t *)(iAddr + pcCache + 0x0) = SWAP_LE32(pcOffset + 0x0);
                 *(uint32_t *)(iAddr + pcCache + 0x4) = SWAP_LE32(pcOffset + 0x4);
@@ -515,8 +566,51 @@ Formula One 2001
         return g_emulator->m_mem->read32(pc, Memory::ReadType::Instr);
     }
 
+    // Self-modifying code tracking. Each 4KB page of RAM gets a bit which is set as soon as the CPU core caches
+    // anything coming from it, be it an icache line or a recompiled block. Writes to pages without that bit can't
+    // affect anything the core holds on to, so they don't need to go through Clear. Bits are only dropped on reset.
+    void markCodePage(uint32_t address) {
+        const uint32_t physical = address & 0x1fffffff;
+        if (physical >= c_codePagesRange) return;
+        const uint32_t page = (physical & g_emulator->getRamMask()) >> 12;
+        m_codePages[page / 64] |= uint64_t(1) << (page % 64);
+    }
+
+    // Same as Clear, with the size in words, but skipped entirely if the range doesn't touch any code page.
+    // Anything outside of RAM, such as the scratchpad, is always forwarded.
+    void clearIfCode(uint32_t address, uint32_t size) {
+        if (size == 0) return;
+        const uint32_t physical = address & 0x1fffffff;
+        if ((physical >= c_codePagesRange) || (size >= c_codePagesRange / 4)) {
+            Clear(address, size);
+            return;
+        }
+
+        const uint32_t mask = g_emulator->getRamMask();
+        const uint32_t pageMask = mask >> 12;
+        const uint32_t last = ((physical + size * 4 - 1) & mask) >> 12;
+        for (uint32_t page = (physical & mask) >> 12;; page = (page + 1) & pageMask) {
+            if (m_codePages[page / 64] & (uint64_t(1) << (page % 64))) {
+                Clear(address, size);
+                return;
+            }
+            if (page == last) break;
+        }
+        m_clearsSkipped++;
+    }
+
+    // Lines restored from a save state came from code pages as well
+    void markICacheCodePages() {
+        for (unsigned i = 0; i < sizeof(m_regs.iCacheAddr); i += 16) {
+            markCodePage(SWAP_LE32(*(uint32_t *)(m_regs.iCacheAddr + i)));
+        }
+    }
+
   private:
     const std::string m_name;
+    // Pending interrupts, keyed by their PSXINT_* number. m_regs.interrupt and m_regs.intTargets remain the reference,
+    // since they are what save states hold, and this only orders them by deadline.
+    EventScheduler<32> m_events;
 
     struct PCdrvFile;
     typedef Intrusive::HashTable<uint32_t, PCdrvFile> PCdrvFiles;
@@ -554,11 +648,13 @@ Formula One 2001
 class Cpus {
   public:
     static std::unique_ptr<R3000Acpu> Interpreted();
+    static std::unique_ptr<R3000Acpu> InterpretedThreaded();
     static std::unique_ptr<R3000Acpu> DynaRec();
 
   private:
     static std::unique_ptr<R3000Acpu> getDynaRec();
     static std::unique_ptr<R3000Acpu> getInterpreted();
+    static std::unique_ptr<R3000Acpu> getInterpretedThreaded();
 };
 
 }  // namespace PCSX
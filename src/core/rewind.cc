@@ -0,0 +1,134 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/rewind.h"
+
+#include <zlib.h>
+
+#include <chrono>
+
+#include "core/psxemulator.h"
+#include "core/sstate.h"
+
+void PCSX::Rewind::vsync() {
+    int interval = g_emulator->settings.get<Emulator::SettingRewindInterval>();
+    if (interval <= 0) return;
+    if (++m_frameCounter < interval) return;
+    m_frameCounter = 0;
+    capture();
+}
+
+void PCSX::Rewind::capture() {
+    auto start = std::chrono::steady_clock::now();
+
+    Snapshot snapshot;
+    snapshot.keyframe = m_keyframe.empty() || (m_sinceKeyframe >= c_keyframeInterval);
+    // The dirty pages are only reset on keyframes, so each delta holds everything written since its keyframe.
+    std::string state = snapshot.keyframe ? SaveStates::save() : SaveStates::saveIncremental();
+    if (snapshot.keyframe) SaveStates::clearDirtyPages();
+    snapshot.size = state.size();
+    snapshot.frame = g_emulator->getEmulatedFrames();
+
+    uLongf compressedSize = compressBound(state.size());
+    if (m_scratch.size() < compressedSize) m_scratch.resize(compressedSize);
+    if (compress2(reinterpret_cast<Bytef *>(m_scratch.data()), &compressedSize,
+                  reinterpret_cast<const Bytef *>(state.data()), state.size(), Z_BEST_SPEED) != Z_OK) {
+        return;
+    }
+    snapshot.data.assign(m_scratch.data(), compressedSize);
+
+    if (snapshot.keyframe) {
+        m_keyframe = std::move(state);
+        m_sinceKeyframe = 0;
+        m_keyframes++;
+    } else {
+        m_sinceKeyframe++;
+    }
+    m_memoryUsage += snapshot.data.size();
+    m_snapshots.push_back(std::move(snapshot));
+    trim();
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    m_lastCaptureTime = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    m_totalCaptureTime += m_lastCaptureTime;
+    m_captures++;
+}
+
+bool PCSX::Rewind::rewind(unsigned steps) {
+    if ((steps == 0) || (steps > m_snapshots.size())) return false;
+    while (--steps) dropBack();
+
+    const Snapshot &snapshot = m_snapshots.back();
+    const bool keyframe = snapshot.keyframe;
+    std::string state = inflate(snapshot);
+    if (!keyframe && m_keyframe.empty()) {
+        auto i = m_snapshots.rbegin();
+        while (!i->keyframe) i++;
+        m_keyframe = inflate(*i);
+    }
+    if (!keyframe && m_keyframe.empty()) state.clear();
+    dropBack();
+    // Loading flags all of the memory as dirty, so the next delta would be as large as a keyframe anyway.
+    m_sinceKeyframe = c_keyframeInterval;
+    m_frameCounter = 0;
+    if (state.empty()) return false;
+    return keyframe ? SaveStates::load(state) : SaveStates::load(m_keyframe, state);
+}
+
+void PCSX::Rewind::clear() {
+    m_snapshots.clear();
+    m_keyframe.clear();
+    m_memoryUsage = 0;
+    m_keyframes = 0;
+    m_sinceKeyframe = 0;
+    m_frameCounter = 0;
+}
+
+void PCSX::Rewind::trim() {
+    size_t budget = size_t(g_emulator->settings.get<Emulator::SettingRewindMemory>()) * 1024 * 1024;
+    // Deltas are useless without their keyframe, so the history is trimmed a whole group at a time,
+    // and the newest group is always kept, even if it alone goes over the budget.
+    while ((m_memoryUsage > budget) && (m_keyframes > 1)) {
+        do {
+            m_memoryUsage -= m_snapshots.front().data.size();
+            m_snapshots.pop_front();
+        } while (!m_snapshots.front().keyframe);
+        m_keyframes--;
+    }
+}
+
+void PCSX::Rewind::dropBack() {
+    if (m_snapshots.back().keyframe) {
+        m_keyframe.clear();
+        m_keyframes--;
+    }
+    m_memoryUsage -= m_snapshots.back().data.size();
+    m_snapshots.pop_back();
+}
+
+std::string PCSX::Rewind::inflate(const Snapshot &snapshot) {
+    std::string state;
+    state.resize(snapshot.size);
+    uLongf size = snapshot.size;
+    if (uncompress(reinterpret_cast<Bytef *>(state.data()), &size,
+                   reinterpret_cast<const Bytef *>(snapshot.data.data()), snapshot.data.size()) != Z_OK) {
+        state.clear();
+    }
+    return state;
+}
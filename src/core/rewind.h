@@ -0,0 +1,75 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <deque>
+#include <string>
+
+namespace PCSX {
+
+// Bounded history of save states, taken every few frames, so the emulation can be stepped backwards. Snapshots come
+// in groups: the first one of a group, the keyframe, is stored whole, and the others as incremental save states which
+// only carry the memory pages written to since the keyframe. Everything is deflated at zlib's fastest level, and the
+// oldest groups are dropped whenever the history goes over the memory budget.
+class Rewind {
+  public:
+    static constexpr unsigned c_keyframeInterval = 30;
+
+    // Called once per emulated frame; captures a snapshot every RewindInterval frames.
+    void vsync();
+    void capture();
+    // Restores the state captured "steps" snapshots ago, and forgets about everything newer than it.
+    bool rewind(unsigned steps = 1);
+    void clear();
+
+    size_t snapshotCount() const { return m_snapshots.size(); }
+    size_t memoryUsage() const { return m_memoryUsage; }
+    // Host time spent in capture(), in microseconds.
+    uint64_t lastCaptureTime() const { return m_lastCaptureTime; }
+    uint64_t averageCaptureTime() const { return m_captures ? m_totalCaptureTime / m_captures : 0; }
+
+  private:
+    struct Snapshot {
+        std::string data;
+        uint64_t size;
+        uint64_t frame;
+        bool keyframe;
+    };
+
+    void trim();
+    void dropBack();
+    std::string inflate(const Snapshot &snapshot);
+
+    std::deque<Snapshot> m_snapshots;
+    // Inflated copy of the newest keyframe in m_snapshots, or empty if it needs to be inflated again.
+    std::string m_keyframe;
+    std::string m_scratch;
+    size_t m_memoryUsage = 0;
+    unsigned m_keyframes = 0;
+    unsigned m_sinceKeyframe = 0;
+    int m_frameCounter = 0;
+    uint64_t m_lastCaptureTime = 0;
+    uint64_t m_totalCaptureTime = 0;
+    uint64_t m_captures = 0;
+};
+
+}  // namespace PCSX
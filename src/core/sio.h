@@ -227,7 +227,7 @@ class SIO {
     };
 
     friend MemoryCard;
-    friend SaveStates::SaveState SaveStates::constructSaveState();
+    friend SaveStates::SaveState SaveStates::constructSaveState(bool incremental);
 
     static constexpr size_t c_padBufferSize = 0x1010;
 
@@ -281,7 +281,7 @@ void PCSX::SIO1::writeCtrl16(uint16_t v) {
             m_sio1fifo.asA<Fifo>()->reset();
         }
 
-        PCSX::g_emulator->m_cpu->m_regs.interrupt &= ~(1 << PCSX::PSXINT_SIO1);
+        PCSX::g_emulator->m_cpu->cancelInterrupt(PCSX::PSXINT_SIO1);
     }
 
     if (!(m_regs.control & CR_RXEN)) {
@@ -93,7 +93,7 @@ class SIO1 {
         m_decodeState = READ_SIZE;
         messageSize = 0;
         initialMessage = true;
-        g_emulator->m_cpu->m_regs.interrupt &= ~(1 << PCSX::PSXINT_SIO1);
+        g_emulator->m_cpu->cancelInterrupt(PCSX::PSXINT_SIO1);
     }
 
     void stopSIO1Connection() {
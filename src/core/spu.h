@@ -55,9 +55,15 @@ class SPUInterface {
     virtual void debug() = 0;
     virtual bool configure() = 0;
     virtual void save(SaveStates::SPU &) = 0;
+    virtual void saveIncremental(SaveStates::SPU &) = 0;
     virtual void load(const SaveStates::SPU &) = 0;
+    virtual void clearDirtyPages() = 0;
     virtual uint32_t getCurrentFrames() = 0;
     virtual void waitForGoal(uint32_t goal) = 0;
+    // Sends the audio output to this file instead of the audio device, which then no longer paces anything. See
+    // MiniAudio::setSink for the details. An empty IO goes back to the audio device.
+    virtual void setOutputSink(IO<File> sink) = 0;
+    virtual void setOutputSinkGoal(uint32_t goal) = 0;
     virtual uint32_t getFrameCount() = 0;
     virtual void setLua(Lua L) = 0;
 
@@ -19,6 +19,15 @@
 
 #include "core/sstate.h"
 
+#include <uv.h>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <string>
+#include <system_error>
+#include <vector>
+
 #include "core/callstacks.h"
 #include "core/cdrom.h"
 #include "core/gpu.h"
@@ -29,20 +38,27 @@
 #include "core/r3000a.h"
 #include "core/sio.h"
 #include "spu/interface.h"
+#include "support/file.h"
+#include "support/zfile.h"
+
+static_assert(PCSX::Memory::c_dirtyPageShift == PCSX::SaveStates::c_pageShift);
+static_assert(PCSX::GPU::c_vramDirtyPageCount == (0x100000 >> PCSX::SaveStates::c_pageShift));
 
-PCSX::SaveStates::SaveState PCSX::SaveStates::constructSaveState() {
+PCSX::SaveStates::SaveState PCSX::SaveStates::constructSaveState(bool incremental) {
     // clang-format off
     return SaveState {
         SaveStateInfo {
             VersionString {},
             Version {},
+            Incremental {},
         },
         Thumbnail {},
         Memory {
-            RAM { g_emulator->m_mem->m_wram },
-            ROM { g_emulator->m_mem->m_bios },
-            EXP1 { g_emulator->m_mem->m_exp1 },
+            RAM { incremental ? nullptr : g_emulator->m_mem->m_wram },
+            ROM { incremental ? nullptr : g_emulator->m_mem->m_bios },
+            EXP1 { incremental ? nullptr : g_emulator->m_mem->m_exp1 },
             HardwareMemory { g_emulator->m_mem->m_hard },
+            RAMPages {},
         },
         Registers {
             GPR { g_emulator->m_cpu->m_regs.GPR.r },
@@ -173,20 +189,35 @@ PCSX::SaveStates::SaveState PCSX::SaveStates::constructSaveState() {
 
 namespace PCSX {
 struct SaveStateWrapper {
-    SaveStateWrapper(SaveStates::SaveState& state_) : state(state_) {}
+    SaveStateWrapper(SaveStates::SaveState& state_, bool incremental_ = false)
+        : state(state_), incremental(incremental_) {}
     SaveStates::SaveState& state;
+    const bool incremental;
 };
 }  // namespace PCSX
 
-std::string PCSX::SaveStates::save() {
-    SaveState state = constructSaveState();
-    SaveStateWrapper wrapper(state);
+namespace {
+
+std::string saveState(bool incremental) {
+    using namespace PCSX;
+    using namespace PCSX::SaveStates;
+    SaveState state = constructSaveState(incremental);
+    SaveStateWrapper wrapper(state, incremental);
 
     state.get<SaveStateInfoField>().get<VersionString>().value = "PCSX-Redux SaveState v4";
     state.get<SaveStateInfoField>().get<Version>().value = 4;
+    state.get<SaveStateInfoField>().get<Incremental>().value = incremental;
 
+    if (incremental) {
+        savePages(state.get<MemoryField>().get<RAMPages>(), g_emulator->m_mem->m_wram,
+                  g_emulator->m_mem->getDirtyPages(), PCSX::Memory::c_dirtyPageCount);
+    }
     g_emulator->m_gpu->serialize(&wrapper);
-    g_emulator->m_spu->save(state.get<SPUField>());
+    if (incremental) {
+        g_emulator->m_spu->saveIncremental(state.get<SPUField>());
+    } else {
+        g_emulator->m_spu->save(state.get<SPUField>());
+    }
 
     g_emulator->m_counters->serialize(&wrapper);
     g_emulator->m_mdec->serialize(&wrapper);
@@ -198,10 +229,149 @@ std::string PCSX::SaveStates::save() {
     g_emulator->m_callStacks->serialize(&wrapper);
 
     Protobuf::OutSlice slice;
+    slice.reserve(state.serializedSize());
     state.serialize(&slice);
     return slice.finalize();
 }
 
+// Checks the bitmap against the amount of pages it's supposed to describe, and the data against the bitmap.
+bool pagesValid(const PCSX::SaveStates::Pages& pages, unsigned count) {
+    using namespace PCSX::SaveStates;
+    const auto& map = pages.get<PagesMap>().value;
+    const auto& data = pages.get<PagesData>().value;
+    if (map.empty()) return data.empty();
+    if (map.size() != (count + 7) / 8) return false;
+    size_t present = 0;
+    for (unsigned i = 0; i < count; i++) {
+        if (map[i / 8] & (1 << (i % 8))) present++;
+    }
+    return data.size() == (present << c_pageShift);
+}
+
+struct FileWrite {
+    uv_work_t req;
+    std::filesystem::path filename;
+    std::filesystem::path temporary;
+    std::string data;
+    bool success = false;
+};
+
+// Writes to the same file are done one after the other, in the order they were asked for, so that an older state
+// can never be renamed over a newer one. The front of each queue is the write in flight. Only used from the main loop.
+std::map<std::filesystem::path, std::deque<FileWrite*>> s_fileWrites;
+
+// Runs in the thread pool. The state is compressed in memory, then goes to a temporary file, so that a load racing
+// with this, or a crash, never sees a half written one. The previous file is only replaced once the new one is
+// known to be complete on disk.
+void writeFile(uv_work_t* req) {
+    using namespace PCSX;
+    auto write = reinterpret_cast<FileWrite*>(req->data);
+    IO<BufferFile> compressed(new BufferFile(FileOps::READWRITE));
+    {
+        ZWriter zwriter(compressed, ZWriter::GZIP);
+        zwriter.writeString(write->data);
+        zwriter.close();
+    }
+    const auto slice = compressed->borrow();
+
+    bool written = false;
+    try {
+        IO<File> file(new PosixFile(write->temporary, FileOps::TRUNCATE));
+        written = !file->failed() && (file->write(slice.data(), slice.size()) == ssize_t(slice.size()));
+        file->close();
+    } catch (...) {
+        written = false;
+    }
+    std::error_code ec;
+    // Catches whatever only failed when the file got flushed on close
+    if (written) written = (std::filesystem::file_size(write->temporary, ec) == slice.size()) && !ec;
+    if (written) {
+        std::filesystem::rename(write->temporary, write->filename, ec);
+        written = !ec;
+    }
+    write->success = written;
+    if (!written) std::filesystem::remove(write->temporary, ec);
+}
+
+void fileWritten(uv_work_t* req, int status);
+
+void startFileWrite(FileWrite* write) {
+    uv_queue_work(PCSX::g_system->getLoop(), &write->req, writeFile, fileWritten);
+}
+
+void fileWritten(uv_work_t* req, int status) {
+    using namespace PCSX;
+    auto write = reinterpret_cast<FileWrite*>(req->data);
+    bool success = (status == 0) && write->success;
+    if (!success) g_system->log(LogClass::SYSTEM, "Failed to write save state %s\n", write->filename.string().c_str());
+
+    auto queue = s_fileWrites.find(write->filename);
+    queue->second.pop_front();
+    if (queue->second.empty()) {
+        s_fileWrites.erase(queue);
+    } else {
+        startFileWrite(queue->second.front());
+    }
+
+    g_system->m_eventBus->signal(Events::ExecutionFlow::SaveStateWritten{write->filename.string(), success});
+    delete write;
+}
+
+}  // namespace
+
+std::string PCSX::SaveStates::save() { return saveState(false); }
+
+std::string PCSX::SaveStates::saveIncremental() { return saveState(true); }
+
+void PCSX::SaveStates::saveToFile(std::filesystem::path filename) {
+    auto write = new FileWrite;
+    write->req.data = write;
+    write->temporary = filename;
+    write->temporary += ".tmp";
+    write->filename = std::move(filename);
+    write->data = save();
+    auto& queue = s_fileWrites[write->filename];
+    queue.push_back(write);
+    if (queue.size() == 1) startFileWrite(write);
+}
+
+void PCSX::SaveStates::clearDirtyPages() {
+    g_emulator->m_mem->clearDirtyPages();
+    g_emulator->m_gpu->clearVRAMDirtyPages();
+    g_emulator->m_spu->clearDirtyPages();
+}
+
+void PCSX::SaveStates::savePages(Pages& pages, const uint8_t* memory, const uint8_t* dirty, unsigned count) {
+    auto& map = pages.get<PagesMap>().value;
+    auto& data = pages.get<PagesData>().value;
+    map.assign((count + 7) / 8, 0);
+    size_t present = 0;
+    for (unsigned i = 0; i < count; i++) {
+        if (!dirty[i]) continue;
+        map[i / 8] |= 1 << (i % 8);
+        present++;
+    }
+    data.resize(present << c_pageShift);
+    size_t offset = 0;
+    for (unsigned i = 0; i < count; i++) {
+        if (!dirty[i]) continue;
+        memcpy(data.data() + offset, memory + (size_t(i) << c_pageShift), c_pageSize);
+        offset += c_pageSize;
+    }
+}
+
+bool PCSX::SaveStates::loadPages(const Pages& pages, uint8_t* memory, unsigned count) {
+    if (!pagesValid(pages, count)) return false;
+    const auto& map = pages.get<PagesMap>().value;
+    const auto& data = pages.get<PagesData>().value;
+    size_t offset = 0;
+    for (unsigned i = 0; i < count; i++) {
+        if (!(map[i / 8] & (1 << (i % 8)))) continue;
+        memcpy(memory + (size_t(i) << c_pageShift), data.data() + offset, c_pageSize);
+        offset += c_pageSize;
+    }
+    return true;
+}
 void PCSX::CallStacks::serialize(SaveStateWrapper* w) {
     using namespace SaveStates;
     auto& callstacks = w->state.get<SaveStates::CallStacksField>().get<CallStacksMessageField>().value;
@@ -231,7 +401,11 @@ void PCSX::GPU::serialize(SaveStateWrapper* w) {
     using namespace SaveStates;
     auto& gpu = w->state.get<GPUField>();
     gpu.get<GPUStatus>() = readStatus();
-    gpu.get<GPUVRam>().copyFrom(getVRAM().data<uint8_t>());
+    if (w->incremental) {
+        savePages(gpu.get<GPUVRamPages>(), getVRAM().data<uint8_t>(), m_vramDirtyPages, c_vramDirtyPageCount);
+    } else {
+        gpu.get<GPUVRam>().copyFrom(getVRAM().data<uint8_t>());
+    }
     gpu.get<GPUControl>().allocate();
     const auto control = gpu.get<GPUControl>().value;
 
@@ -278,24 +452,30 @@ void PCSX::Counters::serialize(SaveStateWrapper* w) {
     counters.get<PSXNextCounter>().value = m_psxNextCounter;
 }
 
-bool PCSX::SaveStates::load(std::string_view data) {
-    SaveState state = constructSaveState();
+namespace {
 
+bool parseState(PCSX::SaveStates::SaveState& state, std::string_view data) {
+    using namespace PCSX::SaveStates;
     Protobuf::InSlice slice(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    // The big memory areas are copied straight from the input into the emulator when committing the state.
+    slice.allowReferences();
     try {
         state.deserialize(&slice, 0);
     } catch (...) {
         return false;
     }
 
-    if (state.get<SaveStateInfoField>().get<Version>().value != 4) {
-        return false;
-    }
+    return state.get<SaveStateInfoField>().get<Version>().value == 4;
+}
 
+void applyState(PCSX::SaveStates::SaveState& state) {
+    using namespace PCSX;
+    using namespace PCSX::SaveStates;
     SaveStateWrapper wrapper(state);
     PCSX::g_emulator->m_cpu->Reset();
     state.commit();
-    g_emulator->m_cpu->m_regs.lowestTarget = g_emulator->m_cpu->m_regs.cycle;
+    g_emulator->m_mem->markAllDirty();
+    g_emulator->m_cpu->markICacheCodePages();
     g_emulator->m_cpu->m_regs.previousCycles = g_emulator->m_cpu->m_regs.cycle;
     // x86-64 recompiler might make save states with an unaligned PC, since it ignores the bottom 2 bits
     // So we just force-align it here, since it's never meant to be misaligned
@@ -306,6 +486,7 @@ bool PCSX::SaveStates::load(std::string_view data) {
 
     g_emulator->m_counters->deserialize(&wrapper);
     g_emulator->m_mdec->deserialize(&wrapper);
+    g_emulator->m_cpu->rescheduleEvents();
 
     auto& xa = state.get<SPUField>().get<SaveStates::XAField>();
 
@@ -336,7 +517,66 @@ bool PCSX::SaveStates::load(std::string_view data) {
     g_emulator->m_callStacks->deserialize(&wrapper);
 
     g_system->m_eventBus->signal(Events::ExecutionFlow::SaveStateLoaded{});
+}
+
+}  // namespace
+
+bool PCSX::SaveStates::load(std::string_view data) {
+    SaveState state = constructSaveState();
+    if (!parseState(state, data)) return false;
+    // Increments are missing most of the memory, and only make sense on top of their base.
+    if (state.get<SaveStateInfoField>().get<Incremental>().value) return false;
+
+    applyState(state);
+    return true;
+}
+
+bool PCSX::SaveStates::loadFromFile(IO<File> file) {
+    // Kept around from one load to the next, since the states are always about the same size.
+    static std::vector<uint8_t> s_buffer;
+    constexpr size_t c_chunkSize = 1 << 16;
+    if (file->failed()) return false;
+
+    size_t size = 0;
+    while (!file->eof()) {
+        if (s_buffer.size() - size < c_chunkSize) s_buffer.resize(std::max(s_buffer.size() * 2, size + c_chunkSize));
+        auto count = file->read(s_buffer.data() + size, s_buffer.size() - size);
+        if (count == 0) break;
+        if (count < 0) return false;
+        size += count;
+    }
+
+    return load(std::string_view(reinterpret_cast<const char*>(s_buffer.data()), size));
+}
+
+bool PCSX::SaveStates::load(std::string_view base, std::string_view increment) {
+    SaveState baseState = constructSaveState();
+    SaveState state = constructSaveState(true);
+    if (!parseState(baseState, base) || !parseState(state, increment)) return false;
+    if (baseState.get<SaveStateInfoField>().get<Incremental>().value) return false;
+    if (!state.get<SaveStateInfoField>().get<Incremental>().value) return false;
+
+    // The increment only has the pages of VRAM and SPU ram which changed, so these are patched over the base ones
+    // before being loaded as usual. Main RAM goes straight into memory, which can only happen once nothing can fail.
+    auto& vram = state.get<GPUField>().get<GPUVRam>();
+    auto& spuRam = state.get<SPUField>().get<SPURam>();
+    auto& baseVRAM = baseState.get<GPUField>().get<GPUVRam>();
+    auto& baseSPURam = baseState.get<SPUField>().get<SPURam>();
+    if (vram.value || spuRam.value || !baseVRAM.value || !baseSPURam.value) return false;
+    baseVRAM.own();
+    baseSPURam.own();
+    std::swap(vram.value, baseVRAM.value);
+    std::swap(spuRam.value, baseSPURam.value);
+    if (!loadPages(state.get<GPUField>().get<GPUVRamPages>(), vram.value, PCSX::GPU::c_vramDirtyPageCount)) {
+        return false;
+    }
+    if (!loadPages(state.get<SPUField>().get<SPURamPages>(), spuRam.value, 0x80000 >> c_pageShift)) return false;
+    const auto& ramPages = state.get<MemoryField>().get<RAMPages>();
+    if (!pagesValid(ramPages, PCSX::Memory::c_dirtyPageCount)) return false;
 
+    baseState.get<MemoryField>().commit();
+    loadPages(ramPages, g_emulator->m_mem->m_wram, PCSX::Memory::c_dirtyPageCount);
+    applyState(state);
     return true;
 }
 
@@ -19,9 +19,11 @@
 
 #pragma once
 
+#include <filesystem>
 #include <string_view>
 
 #include "spu/types.h"
+#include "support/file.h"
 #include "support/protobuf.h"
 #include "support/settings.h"
 
@@ -31,7 +33,8 @@ namespace SaveStates {
 
 typedef Protobuf::Field<Protobuf::String, TYPESTRING("version_string"), 1> VersionString;
 typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("version"), 2> Version;
-typedef Protobuf::Message<TYPESTRING("SaveStateInfo"), VersionString, Version> SaveStateInfo;
+typedef Protobuf::Field<Protobuf::Bool, TYPESTRING("incremental"), 3> Incremental;
+typedef Protobuf::Message<TYPESTRING("SaveStateInfo"), VersionString, Version, Incremental> SaveStateInfo;
 typedef Protobuf::MessageField<SaveStateInfo, TYPESTRING("save_state_info"), 1> SaveStateInfoField;
 
 typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("width"), 1> Width;
@@ -42,11 +45,18 @@ typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("blue"), 5> Blue;
 typedef Protobuf::Message<TYPESTRING("Thumbnail"), Width, Height, Red, Green, Blue> Thumbnail;
 typedef Protobuf::MessageField<Thumbnail, TYPESTRING("thumbnail"), 2> ThumbnailField;
 
+// Pages of a memory area, for incremental save states: a bitmap of which 4KB pages are there, one bit per page,
+// followed by their contents, in order.
+typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("map"), 1> PagesMap;
+typedef Protobuf::Field<Protobuf::Bytes, TYPESTRING("data"), 2> PagesData;
+typedef Protobuf::Message<TYPESTRING("Pages"), PagesMap, PagesData> Pages;
+
 typedef Protobuf::FieldPtr<Protobuf::FixedBytes<0x00800000>, TYPESTRING("ram"), 1> RAM;
 typedef Protobuf::FieldPtr<Protobuf::FixedBytes<0x00080000>, TYPESTRING("rom"), 2> ROM;
 typedef Protobuf::FieldPtr<Protobuf::FixedBytes<0x00800000>, TYPESTRING("exp1"), 3> EXP1;
 typedef Protobuf::FieldPtr<Protobuf::FixedBytes<0x00010000>, TYPESTRING("hardware"), 4> HardwareMemory;
-typedef Protobuf::Message<TYPESTRING("Memory"), RAM, ROM, EXP1, HardwareMemory> Memory;
+typedef Protobuf::MessageField<Pages, TYPESTRING("ram_pages"), 5> RAMPages;
+typedef Protobuf::Message<TYPESTRING("Memory"), RAM, ROM, EXP1, HardwareMemory, RAMPages> Memory;
 typedef Protobuf::MessageField<Memory, TYPESTRING("memory"), 3> MemoryField;
 
 typedef Protobuf::RepeatedFieldRef<Protobuf::UInt32, 34, TYPESTRING("gpr"), 1> GPR;
@@ -86,7 +96,8 @@ typedef Protobuf::MessageField<Registers, TYPESTRING("registers"), 4> RegistersF
 typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("status"), 1> GPUStatus;
 typedef Protobuf::Field<Protobuf::FixedBytes<0x400>, TYPESTRING("control"), 2> GPUControl;
 typedef Protobuf::Field<Protobuf::FixedBytes<0x00100000>, TYPESTRING("vram"), 3> GPUVRam;
-typedef Protobuf::Message<TYPESTRING("GPU"), GPUStatus, GPUControl, GPUVRam> GPU;
+typedef Protobuf::MessageField<Pages, TYPESTRING("vram_pages"), 4> GPUVRamPages;
+typedef Protobuf::Message<TYPESTRING("GPU"), GPUStatus, GPUControl, GPUVRam, GPUVRamPages> GPU;
 typedef Protobuf::MessageField<GPU, TYPESTRING("gpu"), 5> GPUField;
 
 typedef Protobuf::Field<Protobuf::FixedBytes<0x80000>, TYPESTRING("ram"), 1> SPURam;
@@ -130,9 +141,11 @@ typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("noiseClock"), 16> SPUNoise
 typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("noiseCount"), 17> SPUNoiseCount;
 typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("noiseVal"), 18> SPUNoiseVal;
 
+typedef Protobuf::MessageField<Pages, TYPESTRING("ram_pages"), 19> SPURamPages;
+
 typedef Protobuf::Message<TYPESTRING("SPU"), SPURam, SPUPorts, XAField, SPUIrq, SPUIrqPtr, Channels, SPUAddr, SPUCtrl,
                           SPUStat, CBStartIndex, CBCurrIndex, CBEndIndex, CBVoiceIndex, CBCDLeft, CBCDRight,
-                          SPUNoiseClock, SPUNoiseCount, SPUNoiseVal>
+                          SPUNoiseClock, SPUNoiseCount, SPUNoiseVal, SPURamPages>
     SPU;
 typedef Protobuf::MessageField<SPU, TYPESTRING("spu"), 6> SPUField;
 
@@ -314,15 +327,33 @@ typedef Protobuf::Message<TYPESTRING("SaveState"), SaveStateInfoField, Thumbnail
                           PCdrvFilesField, CallStacksField>
     SaveState;
 
-typedef Protobuf::ProtoFile<SaveStateInfo, Thumbnail, Memory, DelaySlotInfo, Registers, GPU, ADPCMDecode, XA,
+typedef Protobuf::ProtoFile<SaveStateInfo, Thumbnail, Pages, Memory, DelaySlotInfo, Registers, GPU, ADPCMDecode, XA,
                             ::PCSX::SPU::Chan::Data, ::PCSX::SPU::ADSRInfo, ::PCSX::SPU::ADSRInfoEx, Channel, SPU, SIO,
                             CDRom, Hardware, Rcnt, Counters, MDEC, PCdrvFile, Call, CallStack, CallStacks, SaveState>
     ProtoFile;
 
-SaveState constructSaveState();
+// Incremental save states carry the memory areas in pages of that size.
+constexpr unsigned c_pageShift = 12;
+constexpr size_t c_pageSize = 1 << c_pageShift;
+
+SaveState constructSaveState(bool incremental = false);
 
 std::string save();
+// Incremental save states leave out the BIOS and EXP1, and only carry the pages of RAM, VRAM and SPU RAM which were
+// written to since the last call to clearDirtyPages. They can only be loaded on top of the state saved at that point.
+std::string saveIncremental();
+// Only the serialization happens right away; the compression and the file writing are done from libuv's thread pool,
+// and the Events::ExecutionFlow::SaveStateWritten event is signaled once the file is there, or failed to be. Saves to
+// the same file are written in the order they were asked for, and each one gets its own event.
+void saveToFile(std::filesystem::path filename);
+void clearDirtyPages();
 bool load(std::string_view data);
+// Reads what's left of the file, usually a ZReader, into a buffer which is reused from one call to the next.
+bool loadFromFile(IO<File> file);
+bool load(std::string_view base, std::string_view increment);
+
+void savePages(Pages& pages, const uint8_t* memory, const uint8_t* dirty, unsigned count);
+bool loadPages(const Pages& pages, uint8_t* memory, unsigned count);
 }  // namespace SaveStates
 
 }  // namespace PCSX
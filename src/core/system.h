@@ -80,6 +80,10 @@ struct Reset {
     bool hard = false;
 };
 struct SaveStateLoaded {};
+struct SaveStateWritten {
+    std::string filename;
+    bool success = false;
+};
 }  // namespace ExecutionFlow
 namespace GUI {
 struct JumpToPC {
@@ -35,9 +35,11 @@
 #include "cdrom/iso9660-reader.h"
 #include "core/cdrom.h"
 #include "core/gpu.h"
+#include "core/guest-profiler.h"
 #include "core/psxemulator.h"
 #include "core/psxmem.h"
 #include "core/r3000a.h"
+#include "core/rewind.h"
 #include "core/system.h"
 #include "gui/gui.h"
 #include "lua/luawrapper.h"
@@ -89,6 +91,7 @@ class VramExecutor : public PCSX::WebExecutor {
                 return true;
             }
 
+            PCSX::g_emulator->m_gpu->markVRAMDirty(y, height);
             PCSX::g_emulator->m_gpu->partialUpdateVRAM(x, y, width, height, request.body.data<uint16_t>());
             client->write("HTTP/1.1 200 OK\r\n\r\n");
             return true;
@@ -144,6 +147,7 @@ class RamExecutor : public PCSX::WebExecutor {
             }
 
             memcpy(PCSX::g_emulator->m_mem->m_wram + offset, request.body.data<uint8_t>(), size);
+            PCSX::g_emulator->m_mem->markDirty(PCSX::g_emulator->m_mem->m_wram + offset, size);
             client->write("HTTP/1.1 200 OK\r\n\r\n");
             return true;
         }
@@ -235,6 +239,147 @@ class CacheExecutor : public PCSX::WebExecutor {
     virtual ~CacheExecutor() = default;
 };
 
+class ProfilerExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/cpu/profiler";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        auto& profiler = PCSX::g_emulator->m_guestProfiler;
+        auto vars = parseQuery(request.urlData.query);
+        if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
+            auto iformat = vars.find("format");
+            if (iformat == vars.end()) {
+                nlohmann::json j;
+                j["running"] = profiler->running();
+                j["period"] = profiler->period();
+                j["samples"] = profiler->sampleCount();
+                write200(client, j);
+                return true;
+            }
+            std::string format = iformat->second.value_or("");
+            std::string data;
+            std::string_view contentType;
+            if (format.compare("folded") == 0) {
+                data = profiler->folded();
+                contentType = "text/plain";
+            } else if (format.compare("pprof") == 0) {
+                data = profiler->pprof();
+                contentType = "application/octet-stream";
+            } else {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                return true;
+            }
+            client->write(fmt::format("HTTP/1.1 200 OK\r\nContent-Type: {}\r\nContent-Length: {}\r\n\r\n",
+                                      contentType, data.size()));
+            client->write(std::move(data));
+            return true;
+        } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
+            auto ifunction = vars.find("function");
+            if (ifunction == vars.end()) {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                return true;
+            }
+            std::string function = ifunction->second.value_or("");
+            if (function.compare("start") == 0) {
+                uint32_t period = 0;
+                auto iperiod = vars.find("period");
+                if ((iperiod != vars.end()) && iperiod->second.has_value()) {
+                    auto& str = iperiod->second.value();
+                    auto result = std::from_chars(str.data(), str.data() + str.size(), period);
+                    if (result.ec != std::errc()) {
+                        client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                        return true;
+                    }
+                }
+                auto icallstacks = vars.find("callstacks");
+                bool callStacks = (icallstacks != vars.end()) && (icallstacks->second.value_or("true") != "false");
+                profiler->start(period, callStacks);
+                client->write("HTTP/1.1 200 OK\r\n\r\n");
+                return true;
+            }
+            if (function.compare("stop") == 0) {
+                profiler->stop();
+                client->write("HTTP/1.1 200 OK\r\n\r\n");
+                return true;
+            }
+            if (function.compare("reset") == 0) {
+                profiler->reset();
+                client->write("HTTP/1.1 200 OK\r\n\r\n");
+                return true;
+            }
+            client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+            return true;
+        }
+        return false;
+    }
+
+  public:
+    ProfilerExecutor() = default;
+    virtual ~ProfilerExecutor() = default;
+};
+
+class RewindExecutor : public PCSX::WebExecutor {
+    virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
+        return urldata.path == "/api/v1/rewind";
+    }
+    virtual bool execute(PCSX::WebClient* client, PCSX::RequestData& request) final {
+        auto& rewind = PCSX::g_emulator->m_rewind;
+        if (request.method == PCSX::RequestData::Method::HTTP_HTTP_GET) {
+            nlohmann::json j;
+            j["interval"] = PCSX::g_emulator->settings.get<PCSX::Emulator::SettingRewindInterval>().value;
+            j["snapshots"] = rewind->snapshotCount();
+            j["memory"] = rewind->memoryUsage();
+            j["lastCaptureUs"] = rewind->lastCaptureTime();
+            j["averageCaptureUs"] = rewind->averageCaptureTime();
+            write200(client, j);
+            return true;
+        } else if (request.method == PCSX::RequestData::Method::HTTP_POST) {
+            auto vars = parseQuery(request.urlData.query);
+            auto ifunction = vars.find("function");
+            if (ifunction == vars.end()) {
+                client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                return true;
+            }
+            std::string function = ifunction->second.value_or("");
+            if (function.compare("capture") == 0) {
+                rewind->capture();
+                client->write("HTTP/1.1 200 OK\r\n\r\n");
+                return true;
+            }
+            if (function.compare("clear") == 0) {
+                rewind->clear();
+                client->write("HTTP/1.1 200 OK\r\n\r\n");
+                return true;
+            }
+            if (function.compare("rewind") == 0) {
+                unsigned steps = 1;
+                auto isteps = vars.find("steps");
+                if ((isteps != vars.end()) && isteps->second.has_value()) {
+                    auto& str = isteps->second.value();
+                    auto result = std::from_chars(str.data(), str.data() + str.size(), steps);
+                    if (result.ec != std::errc()) {
+                        client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+                        return true;
+                    }
+                }
+                if (rewind->rewind(steps)) {
+                    client->write("HTTP/1.1 200 OK\r\n\r\n");
+                } else {
+                    client->write("HTTP/1.1 409 Conflict\r\n\r\nNot enough rewind history.");
+                }
+                return true;
+            }
+            client->write("HTTP/1.1 400 Bad Request\r\n\r\n");
+            return true;
+        }
+        return false;
+    }
+
+  public:
+    RewindExecutor() = default;
+    virtual ~RewindExecutor() = default;
+};
+
 class FlowExecutor : public PCSX::WebExecutor {
     virtual bool match(PCSX::WebClient* client, const PCSX::UrlData& urldata) final {
         return urldata.path == "/api/v1/execution-flow";
@@ -800,7 +945,9 @@ PCSX::WebServer::WebServer() : m_listener(g_system->m_eventBus) {
     m_executors.push_back(new RamExecutor());
     m_executors.push_back(new AssemblyExecutor());
     m_executors.push_back(new CacheExecutor());
+    m_executors.push_back(new ProfilerExecutor());
     m_executors.push_back(new FlowExecutor());
+    m_executors.push_back(new RewindExecutor());
     m_executors.push_back(new LuaExecutor());
     m_executors.push_back(new CDExecutor());
     m_executors.push_back(new StateExecutor());
@@ -556,6 +556,9 @@ void PCSX::GUI::init(std::function<void()> applyArguments) {
         glfwSwapInterval(0);
         setRawMouseMotion();
     });
+    m_listener.listen<Events::ExecutionFlow::SaveStateWritten>([this](const auto& event) {
+        if (!event.success) addNotification(fmt::format(f_("Failed to write save state {}"), event.filename));
+    });
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
@@ -784,6 +787,12 @@ void PCSX::GUI::init(std::function<void()> applyArguments) {
     m_hwrEditor.title = l_("Hardware Registers");
     m_biosEditor.title = l_("BIOS");
     m_vramEditor.title = l_("VRAM");
+    for (auto& editor : m_mainMemEditors) {
+        editor.editor.WriteFn = [](uint8_t* data, size_t offset, uint8_t writtenByte) {
+            data[offset] = writtenByte;
+            g_emulator->m_mem->markDirty(data + offset, 1);
+        };
+    }
     m_vramEditor.editor.WriteFn = [](uint8_t* data, size_t offset, uint8_t writtenByte) {
         constexpr size_t vramWidth = 1024;
         constexpr size_t stride = vramWidth * sizeof(uint16_t);  // Number of bytes per line of VRAM
@@ -801,6 +810,7 @@ void PCSX::GUI::init(std::function<void()> applyArguments) {
             newPixel = writtenByte | (data[maskedOffset] << 8);
         }
 
+        g_emulator->m_gpu->markVRAMDirty(y, 1);
         g_emulator->m_gpu->partialUpdateVRAM(x, y, 1, 1, &newPixel);
     };
 
@@ -1499,6 +1509,8 @@ in Configuration->Emulation, restart PCSX-Redux, then try again.)"));
             if (g_system->running()) {
                 ImGui::Text(_("%.2f FPS (%.2f ms)"), ImGui::GetIO().Framerate, 1000.0f / ImGui::GetIO().Framerate);
                 ImGui::Separator();
+                ImGui::Text(_("%.2f emulated FPS"), g_emulator->getEmulatedFPS());
+                ImGui::Separator();
                 uint32_t frameCount = g_emulator->m_spu->getFrameCount();
                 ImGui::Text(_("%.2f ms audio buffer (%i frames)"), 1000.0f * frameCount / 44100.0f, frameCount);
             } else {
@@ -2077,6 +2089,7 @@ bool PCSX::GUI::configure() {
     bool selectEXP1Dialog = false;
     bool showDynarecDebugWarning = false;
     bool showDynarecWarning = false;
+    bool showThreadedInterpreterWarning = false;
     auto& settings = g_emulator->settings;
     auto& debugSettings = settings.get<Emulator::SettingDebugSettings>();
 
@@ -2096,6 +2109,23 @@ bool PCSX::GUI::configure() {
         scale /= 100.0f;
         changed |= ImGui::SliderFloat(_("Speed Scaler"), &scale, 0.1f, 25.0f);
         settings.get<Emulator::SettingScaler>() = scale * 100.0f;
+        changed |= ImGui::Checkbox(_("Turbo"), &settings.get<Emulator::SettingTurbo>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Stops pacing the emulation against the audio output. The emulation
+then runs as fast as possible, or at the speed below, and the audio
+is discarded, or written as raw 16 bits stereo samples at 44.1kHz
+to the dump file set by the -turbo-audio-dump command line flag,
+which keeps growing each time turbo is turned back on.)"));
+        changed |= ImGui::SliderInt(_("Turbo speed (%)"), &settings.get<Emulator::SettingTurboSpeed>().value, 0, 1000,
+                                    settings.get<Emulator::SettingTurboSpeed>() ? "%d%%" : _("Unlimited"));
+        changed |= ImGui::SliderInt(_("Rewind interval (frames)"),
+                                    &settings.get<Emulator::SettingRewindInterval>().value, 0, 300,
+                                    settings.get<Emulator::SettingRewindInterval>() ? "%d" : _("Disabled"));
+        changed |= ImGui::SliderInt(_("Rewind memory (MB)"), &settings.get<Emulator::SettingRewindMemory>().value, 16,
+                                    4096);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Snapshots the emulation every so many frames, so it
+can be stepped backwards from Lua or the web server.
+Snapshots are delta compressed, and the oldest ones
+are dropped once the memory budget is used up.)"));
         changed |= ImGui::Checkbox(_("Enable XA decoder"), &settings.get<Emulator::SettingXa>().value);
         changed |= ImGui::Checkbox(_("Always enable SPU IRQ"), &settings.get<Emulator::SettingSpuIrq>().value);
         changed |= ImGui::Checkbox(_("Decode MDEC videos in B&W"), &settings.get<Emulator::SettingBnWMdec>().value);
@@ -2113,6 +2143,15 @@ however it doesn't play nicely with the debugger.
 Changing this setting requires a reboot to take effect.
 The dynarec core isn't available for all CPUs, so
 this setting may not have any effect for you.)"));
+        if (ImGui::Checkbox(_("Threaded interpreter"), &settings.get<Emulator::SettingThreadedInterpreter>().value)) {
+            changed = true;
+            showThreadedInterpreterWarning = true;
+        }
+        ImGuiHelpers::ShowHelpMarker(_(R"(Uses the threaded dispatch loop in the interpreted
+CPU core, which is faster than the normal one. It
+steps aside whenever the debugger or the tracer is
+enabled. Has no effect while the dynarec is enabled.
+Changing this setting requires a reboot to take effect.)"));
         bool memChanged = ImGui::Checkbox(_("8MB"), &settings.get<Emulator::Setting8MB>().value);
         ImGuiHelpers::ShowHelpMarker(_(R"(Emulates an installed 8MB system,
 instead of the normal 2MB. Useful for working
@@ -2158,6 +2197,30 @@ when changing this setting.)"));
 which may include additional checks.
 Also will make the boot time substantially
 faster by not displaying the logo.)"));
+        changed |= ImGui::Checkbox(_("Skip idle loops"), &settings.get<Emulator::SettingIdleSkip>().value);
+        ImGuiHelpers::ShowHelpMarker(_(R"(Detects loops that only wait for an interrupt,
+such as waiting for VSync, and moves the emulated
+clock straight to the next event instead of running
+them. This can speed up menus and loading screens
+considerably, but it may upset a few games relying
+on very precise timings, which is why it's off by
+default.)"));
+        {
+            const auto& gameID = g_emulator->m_cdrom->getCDRomID();
+            auto& disabledGames = settings.get<Emulator::SettingIdleSkipDisabledGames>().value;
+            auto disabledGame = std::find(disabledGames.begin(), disabledGames.end(), gameID);
+            bool disabled = disabledGame != disabledGames.end();
+            ImGui::BeginDisabled(gameID.empty());
+            if (ImGui::Checkbox(_("Disable idle loop skipping for this game"), &disabled)) {
+                changed = true;
+                if (disabled) {
+                    disabledGames.push_back(gameID);
+                } else {
+                    disabledGames.erase(disabledGame);
+                }
+            }
+            ImGui::EndDisabled();
+        }
         auto bios = settings.get<Emulator::SettingBios>().string();
         ImGui::InputText(_("BIOS file"), const_cast<char*>(reinterpret_cast<const char*>(bios.c_str())), bios.length(),
                          ImGuiInputTextFlags_ReadOnly);
@@ -2340,6 +2403,10 @@ debugging features may not work.)");
     } else if (showDynarecWarning) {
         addNotification(R"(Toggling the Dynarec option requires a restart
 of the emulator to take effect.)");
+    }
+    if (showThreadedInterpreterWarning) {
+        addNotification(R"(Toggling the threaded interpreter option requires
+a restart of the emulator to take effect.)");
     }
     return changed;
 }
@@ -2717,40 +2784,18 @@ bool PCSX::GUI::saveSaveState(std::filesystem::path filename) {
     if (filename.is_relative()) {
         filename = g_system->getPersistentDir() / filename;
     }
-    // TODO: yeet this to libuv's threadpool.
-    ZWriter save(new UvFile(filename, FileOps::TRUNCATE), ZWriter::GZIP);
-    bool success = !save.failed();
-    if (success) save.writeString(SaveStates::save());
-    save.close();
-    return success;
+    SaveStates::saveToFile(filename);
+    return true;
 }
 
 bool PCSX::GUI::loadSaveState(std::filesystem::path filename) {
     if (filename.is_relative()) {
         filename = g_system->getPersistentDir() / filename;
     }
-    ZReader save(new PosixFile(filename));
-    if (save.failed()) return false;
-    std::ostringstream os;
-    constexpr unsigned buff_size = 1 << 16;
-    char* buff = new char[buff_size];
-    bool error = false;
-
-    while (!save.eof()) {
-        auto cnt = save.read(buff, buff_size);
-        if (cnt == 0) break;
-        if (cnt < 0) {
-            error = true;
-            break;
-        }
-        os.write(buff, cnt);
-    }
-
-    save.close();
-    delete[] buff;
-
-    if (!error) SaveStates::load(os.str());
-    return !error;
+    IO<File> save(new ZReader(new PosixFile(filename)));
+    bool success = SaveStates::loadFromFile(save);
+    save->close();
+    return success;
 }
 
 bool PCSX::GUI::deleteSaveState(std::filesystem::path filename) {
@@ -1052,10 +1052,10 @@ settings, otherwise debugging features may not work.)");
             std::string assembler = fmt::format(R"(
 local success, msg = pcall(function() PCSX.Assembler.New():parse([[
 {}
-]]):compileToMemory(PCSX.getMemPtr(), 0x{:08x}, 0x{:08x}) end)
+]]):compileToFile(PCSX.getMemoryAsFile(), 0x{:08x}) end)
 if not success then return msg else return nil end
 )",
-                                                m_assembleCode, m_assembleAddress, m_ramBase);
+                                                m_assembleCode, m_assembleAddress);
             L.load(assembler, "inline:assembler");
             if (L.isnil()) {
                 m_assembleStatus.clear();
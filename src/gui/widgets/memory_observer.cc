@@ -39,6 +39,8 @@ PCSX::Widgets::MemoryObserver::MemoryObserver(bool& show) : m_show(show), m_list
                 const auto dataSize = getStrideFromValueType(m_scanValueType);
                 memcpy(g_emulator->m_mem->m_wram + addressValuePair.address - 0x80000000, &addressValuePair.frozenValue,
                        dataSize);
+                g_emulator->m_mem->markDirty(g_emulator->m_mem->m_wram + addressValuePair.address - 0x80000000,
+                                             dataSize);
             }
         }
     });
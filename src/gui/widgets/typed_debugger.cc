@@ -813,6 +813,7 @@ Arrays and pointers are specified as for data types)"));
                         const auto instructionAddress = instruction.first;
                         const auto& instructions = instruction.second;
                         memcpy(memData + instructionAddress - memBase, instructions.data(), 4);
+                        g_emulator->m_mem->markDirty(memData + instructionAddress - memBase, 4);
                     }
                     m_disabledInstructions.clear();
                 }
@@ -860,6 +861,7 @@ Arrays and pointers are specified as for data types)"));
                         const auto functionAddress = function.first;
                         const auto& instructionsToRestore = function.second;
                         memcpy(memData + functionAddress - memBase, instructionsToRestore.data(), 8);
+                        g_emulator->m_mem->markDirty(memData + functionAddress - memBase, 8);
                     }
                     m_disabledFunctions.clear();
                 }
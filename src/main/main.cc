@@ -25,6 +25,7 @@
 
 #include "core/arguments.h"
 #include "core/cdrom.h"
+#include "core/cpu-trace-recorder.h"
 #include "core/gpu.h"
 #include "core/logger.h"
 #include "core/psxemulator.h"
@@ -306,12 +307,79 @@ int pcsxMain(int argc, char **argv) {
             debugSettings.get<PCSX::Emulator::DebugSettings::PCdrvBase>() = argPCdrvBase.value();
         }
 
+        if (args.get<bool>("pio")) {
+            emuSettings.get<PCSX::Emulator::SettingPIOConnected>() = true;
+        }
+        if (args.get<bool>("no-pio")) {
+            emuSettings.get<PCSX::Emulator::SettingPIOConnected>() = false;
+        }
+
         if (args.get<bool>("dynarec")) {
             emuSettings.get<PCSX::Emulator::SettingDynarec>() = true;
         }
         if (args.get<bool>("interpreter")) {
             emuSettings.get<PCSX::Emulator::SettingDynarec>() = false;
         }
+        if (args.get<bool>("dynarec-linking")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecLinking>() = true;
+        }
+        if (args.get<bool>("no-dynarec-linking")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecLinking>() = false;
+        }
+        if (args.get<bool>("dynarec-superblocks")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecSuperblocks>() = true;
+        }
+        if (args.get<bool>("no-dynarec-superblocks")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecSuperblocks>() = false;
+        }
+        auto argDynarecCachePath = args.get<std::string>("dynarec-cache-path");
+        if (args.get<bool>("dynarec-cache")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecCache>() = true;
+        }
+        if (args.get<bool>("no-dynarec-cache")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecCache>() = false;
+        }
+        if (argDynarecCachePath.has_value()) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecCachePath>() = argDynarecCachePath.value();
+        }
+        if (args.get<bool>("dynarec-perf")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecPerf>() = true;
+        }
+        if (args.get<bool>("no-dynarec-perf")) {
+            emuSettings.get<PCSX::Emulator::SettingDynarecPerf>() = false;
+        }
+        if (args.get<bool>("threaded-interpreter")) {
+            emuSettings.get<PCSX::Emulator::SettingThreadedInterpreter>() = true;
+        }
+        if (args.get<bool>("no-threaded-interpreter")) {
+            emuSettings.get<PCSX::Emulator::SettingThreadedInterpreter>() = false;
+        }
+        if (args.get<bool>("idle-skip")) {
+            emuSettings.get<PCSX::Emulator::SettingIdleSkip>() = true;
+        }
+        if (args.get<bool>("no-idle-skip")) {
+            emuSettings.get<PCSX::Emulator::SettingIdleSkip>() = false;
+        }
+        auto argTurboAudioDump = args.get<std::string>("turbo-audio-dump");
+        if (args.get<bool>("turbo")) {
+            emuSettings.get<PCSX::Emulator::SettingTurbo>() = true;
+        }
+        if (args.get<bool>("no-turbo")) {
+            emuSettings.get<PCSX::Emulator::SettingTurbo>() = false;
+        }
+        if (args.get<int>("turbo-speed")) {
+            emuSettings.get<PCSX::Emulator::SettingTurbo>() = true;
+            emuSettings.get<PCSX::Emulator::SettingTurboSpeed>() = args.get<int>("turbo-speed").value();
+        }
+        if (argTurboAudioDump.has_value()) {
+            emuSettings.get<PCSX::Emulator::SettingTurboAudioDump>() = argTurboAudioDump.value();
+        }
+        if (args.get<int>("rewind-interval")) {
+            emuSettings.get<PCSX::Emulator::SettingRewindInterval>() = args.get<int>("rewind-interval").value();
+        }
+        if (args.get<int>("rewind-memory")) {
+            emuSettings.get<PCSX::Emulator::SettingRewindMemory>() = args.get<int>("rewind-memory").value();
+        }
 
         if (args.get<bool>("openglgpu")) {
             emuSettings.get<PCSX::Emulator::SettingHardwareRenderer>() = true;
@@ -385,6 +453,10 @@ runner.init({
     if (args.get<bool>("run")) system->resume();
     s_ui->m_exeToLoad.set(MAKEU8(args.get<std::string>("loadexe", "").c_str()));
     if (s_ui->m_exeToLoad.empty()) s_ui->m_exeToLoad.set(MAKEU8(args.get<std::string>("exe", "").c_str()));
+    auto argCPUTrace = args.get<std::string>("cpu-trace");
+    if (argCPUTrace.has_value() && !emulator->m_cpuTrace->start(argCPUTrace.value())) {
+        system->printf(_("Unable to open CPU trace file %s\n"), argCPUTrace.value());
+    }
 
     // And finally, let's run things.
     int exitCode = 0;
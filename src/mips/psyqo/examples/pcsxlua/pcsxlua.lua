@@ -24,7 +24,7 @@
 -- See pcsxlua.cpp for the C++ side of the demo.
 local addresses = {}
 PCSX.execSlots[255] = function()
-    local mem = PCSX.getMemPtr()
+    local mem = PCSX.getReadOnlyMemPtr()
     local regs = PCSX.getRegisters().GPR.n
     local name = ffi.string(mem + bit.band(regs.a1, 0x7fffff))
     addresses[name] = regs.a0
@@ -0,0 +1,146 @@
+/*
+
+MIT License
+
+Copyright (c) 2021 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdint.h>
+
+#include "common/hardware/cop0.h"
+#include "common/kernel/pcdrv.h"
+#include "common/syscalls/syscalls.h"
+
+#undef unix
+#define CESTER_NO_SIGNAL
+#define CESTER_NO_TIME
+#define EXIT_SUCCESS 0
+#define EXIT_FAILURE 1
+#include "exotic/cester.h"
+
+// This test doesn't check any result by itself. It runs the GTE operations over random inputs and dumps all of
+// the GTE registers after each of them through pcdrv, so that the runs of the various CPU cores can be compared.
+
+#define WRITE_DATA(n) __asm__ volatile("mtc2 %0, $" #n "\nnop\nnop\n" : : "r"(randomValue()));
+#define WRITE_CONTROL(n) __asm__ volatile("ctc2 %0, $" #n "\nnop\nnop\n" : : "r"(randomValue()));
+#define READ_DATA(n) __asm__ volatile("mfc2 %0, $" #n "\nnop\n" : "=r"(regs[n]));
+#define READ_CONTROL(n) __asm__ volatile("cfc2 %0, $" #n "\nnop\n" : "=r"(regs[32 + n]));
+#define REGS_0_14(X) X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) X(12) X(13) X(14)
+#define REGS_16_27(X) X(16) X(17) X(18) X(19) X(20) X(21) X(22) X(23) X(24) X(25) X(26) X(27)
+#define REGS_28_31(X) X(28) X(29) X(30) X(31)
+#define GTE_OP(name, op) static void name() { __asm__ volatile("nop\nnop\ncop2 " #op "\nnop\nnop\n"); }
+
+// clang-format off
+
+CESTER_BODY(
+    static uint32_t s_seed = 0x2545f491;
+
+    static uint32_t gteRandom() {
+        s_seed ^= s_seed << 13;
+        s_seed ^= s_seed >> 17;
+        s_seed ^= s_seed << 5;
+        return s_seed;
+    }
+
+    // Scale values down randomly, so that both the saturated and the non-saturated paths get exercised.
+    static uint32_t randomHalf() { return ((int16_t)gteRandom() >> (gteRandom() & 15)) & 0xffff; }
+    static uint32_t randomValue() {
+        if (gteRandom() & 1) return (int32_t)gteRandom() >> (gteRandom() & 31);
+        return randomHalf() | (randomHalf() << 16);
+    }
+
+    // Data registers 15 and 28-31 have side effects or are read only, so they're left alone
+    static void randomize() {
+        REGS_0_14(WRITE_DATA)
+        REGS_16_27(WRITE_DATA)
+        REGS_0_14(WRITE_CONTROL)
+        WRITE_CONTROL(15)
+        REGS_16_27(WRITE_CONTROL)
+        REGS_28_31(WRITE_CONTROL)
+    }
+
+    static void dump(uint32_t regs[64]) {
+        REGS_0_14(READ_DATA)
+        READ_DATA(15)
+        REGS_16_27(READ_DATA)
+        REGS_28_31(READ_DATA)
+        REGS_0_14(READ_CONTROL)
+        READ_CONTROL(15)
+        REGS_16_27(READ_CONTROL)
+        REGS_28_31(READ_CONTROL)
+    }
+
+    GTE_OP(rtps, 0x0180001)
+    GTE_OP(rtpsNoShift, 0x0100001)
+    GTE_OP(rtpsLm, 0x0180401)
+    GTE_OP(rtpt, 0x0280030)
+    GTE_OP(rtptNoShift, 0x0200030)
+    GTE_OP(rtptLm, 0x0280430)
+    GTE_OP(nclip, 0x1400006)
+    GTE_OP(mvmva, 0x0480012)
+    GTE_OP(mvmvaLightLm, 0x04aa412)
+    GTE_OP(mvmvaColourNoShift, 0x0456012)
+    GTE_OP(mvmvaIR, 0x0498012)
+    GTE_OP(mvmvaGarbageMatrix, 0x04e0012)
+    GTE_OP(mvmvaFarColour, 0x0484012)
+    GTE_OP(ncds, 0x0e80413)
+    GTE_OP(ncdsNoShift, 0x0e00013)
+    GTE_OP(ncdt, 0x0f80416)
+    GTE_OP(ncdtNoShift, 0x0f00016)
+    GTE_OP(nccs, 0x108041b)
+    GTE_OP(ncct, 0x118043f)
+    GTE_OP(ncctNoShift, 0x110003f)
+    GTE_OP(dpcs, 0x0780010)
+    GTE_OP(dpcsNoShiftLm, 0x0700410)
+
+    static void (*const s_ops[])() = {
+        rtps, rtpsNoShift, rtpsLm, rtpt, rtptNoShift, rtptLm, nclip, mvmva, mvmvaLightLm, mvmvaColourNoShift,
+        mvmvaIR, mvmvaGarbageMatrix, mvmvaFarColour, ncds, ncdsNoShift, ncdt, ncdtNoShift, nccs, ncct,
+        ncctNoShift, dpcs, dpcsNoShiftLm,
+    };
+)
+
+CESTER_TEST(gte, random_inputs,
+    int r, fd;
+    uint32_t regs[64];
+
+    writeCOP0Status(readCOP0Status() | 0x40000000);
+
+    r = PCinit();
+    cester_assert_int_eq(0, r);
+
+    fd = PCcreat("gte-results.bin", 0);
+    cester_assert_cmp(fd, >=, 0);
+
+    for (unsigned round = 0; round < 32; round++) {
+        for (unsigned i = 0; i < sizeof(s_ops) / sizeof(s_ops[0]); i++) {
+            randomize();
+            s_ops[i]();
+            dump(regs);
+            r = PCwrite(fd, regs, sizeof(regs));
+            cester_assert_int_eq(sizeof(regs), r);
+        }
+    }
+
+    r = PCclose(fd);
+    cester_assert_int_eq(0, r);
+)
@@ -0,0 +1,100 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdint.h>
+
+#include "common/hardware/counters.h"
+#include "common/hardware/hwregs.h"
+#include "common/hardware/irq.h"
+#include "common/syscalls/syscalls.h"
+
+#undef unix
+#define CESTER_NO_SIGNAL
+#define CESTER_NO_TIME
+#define EXIT_SUCCESS 0
+#define EXIT_FAILURE 1
+#include "exotic/cester.h"
+
+// clang-format off
+
+/* Busy-wait loops like the ones games sit in while waiting for the next frame. Emulators are free to skip through
+   those, but the amount of emulated time spent in them has to stay the same. */
+
+CESTER_BODY(
+    static int s_interruptsWereEnabled;
+    static uint32_t s_oldIMASK;
+    static volatile uint32_t s_flag;
+
+    static void waitVBlank(void) {
+        while ((IREG & IRQ_VBLANK) == 0);
+        IREG = ~IRQ_VBLANK;
+    }
+
+    static uint16_t countLines(void) {
+        waitVBlank();
+        COUNTERS[1].mode = 0x0100;  // Clocked by hblank, and writing the mode resets the counter
+        waitVBlank();
+        return COUNTERS[1].value;
+    }
+)
+
+CESTER_BEFORE_ALL(idle_tests,
+    s_interruptsWereEnabled = enterCriticalSection();
+    s_oldIMASK = IMASK;
+    IMASK = IRQ_VBLANK;
+    IREG = 0;
+)
+
+CESTER_AFTER_ALL(idle_tests,
+    IMASK = s_oldIMASK;
+    if (s_interruptsWereEnabled) leaveCriticalSection();
+)
+
+CESTER_TEST(vblankPolling, idle_tests,
+    for (unsigned i = 0; i < 8; i++) {
+        uint16_t lines = countLines();
+        // NTSC frames have 263 lines, PAL ones 314.
+        cester_assert_cmp(lines, >=, 250);
+        cester_assert_cmp(lines, <=, 320);
+    }
+)
+
+CESTER_TEST(spinningCounter, idle_tests,
+    // The counter is carried over from one iteration to the next, so this loop isn't idle, and must run to the end.
+    uint32_t count = 0;
+    IREG = ~IRQ_VBLANK;
+    while ((IREG & IRQ_VBLANK) == 0) count++;
+    cester_assert_uint_ne(0, count);
+)
+
+CESTER_TEST(flagPolling, idle_tests,
+    // Nothing but an interrupt handler could set this flag, and interrupts are off, so the vblank has to end it.
+    s_flag = 0;
+    IREG = ~IRQ_VBLANK;
+    while (!s_flag && ((IREG & IRQ_VBLANK) == 0));
+    cester_assert_uint_eq(0, s_flag);
+    cester_assert_uint_eq(IRQ_VBLANK, IREG & IRQ_VBLANK);
+)
@@ -0,0 +1,148 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdint.h>
+
+#include "common/syscalls/syscalls.h"
+
+#undef unix
+#define CESTER_NO_SIGNAL
+#define CESTER_NO_TIME
+#define EXIT_SUCCESS 0
+#define EXIT_FAILURE 1
+#include "exotic/cester.h"
+
+// clang-format off
+
+/* Small loops shaped like the ones games spend their time in: copies, checksums, list walks, calls to helpers and
+   bytecode dispatch. The branches in them are heavily biased, so they're meant to exercise the dynarec traces. */
+
+CESTER_BODY(
+    struct Node {
+        struct Node * next;
+        int32_t value;
+    };
+
+    static uint32_t s_source[0x1000];
+    static uint32_t s_destination[0x1000];
+    static struct Node s_nodes[0x400];
+    static uint32_t s_code[4];
+
+    static __attribute__((noinline)) int32_t scale(int32_t value, int32_t factor) {
+        return (value * factor) >> 12;
+    }
+
+    static uint32_t (*setReturnValue(uint16_t value))(void) {
+        s_code[0] = 0x03e00008;          // jr    $ra
+        s_code[1] = 0x24020000 | value;  // addiu $v0, $0, value
+        syscall_flushCache();
+        return (uint32_t(*)(void))s_code;
+    }
+)
+
+CESTER_TEST(copyLoop, test_instance,
+    for (unsigned i = 0; i < 0x1000; i++) {
+        s_source[i] = i * 0x01010101;
+    }
+    for (unsigned pass = 0; pass < 64; pass++) {
+        volatile uint32_t * src = s_source;
+        volatile uint32_t * dst = s_destination;
+        for (unsigned i = 0; i < 0x1000; i += 4) {
+            dst[i + 0] = src[i + 0];
+            dst[i + 1] = src[i + 1];
+            dst[i + 2] = src[i + 2];
+            dst[i + 3] = src[i + 3];
+        }
+    }
+    cester_assert_uint_eq(s_destination[0xfff], 0xfff * 0x01010101);
+)
+
+CESTER_TEST(checksumLoop, test_instance,
+    const volatile uint8_t * bytes = (const uint8_t *)s_source;
+    uint32_t sum = 0;
+    for (unsigned pass = 0; pass < 16; pass++) {
+        for (unsigned i = 0; i < sizeof(s_source); i++) {
+            uint8_t b = bytes[i];
+            if (b == 0xff) {
+                sum ^= 0x80000000;
+            } else {
+                sum = (sum << 1 | sum >> 31) + b;
+            }
+        }
+    }
+    cester_assert_uint_ne(0, sum);
+)
+
+CESTER_TEST(listWalk, test_instance,
+    for (unsigned i = 0; i < 0x400; i++) {
+        s_nodes[i].next = i == 0x3ff ? NULL : &s_nodes[(i * 7 + 1) & 0x3ff];
+        s_nodes[i].value = i;
+    }
+    uint32_t total = 0;
+    for (unsigned pass = 0; pass < 256; pass++) {
+        unsigned steps = 0;
+        for (struct Node * node = &s_nodes[0]; node && steps < 0x400; node = node->next) {
+            total += node->value;
+            steps++;
+        }
+    }
+    cester_assert_uint_ne(0, total);
+)
+
+CESTER_TEST(helperCalls, test_instance,
+    uint32_t total = 0;
+    for (int32_t i = 0; i < 0x10000; i++) {
+        total += scale(i, 0x1800);
+    }
+    cester_assert_uint_eq(total, 3221159936);
+)
+
+CESTER_TEST(bytecodeDispatch, test_instance,
+    static const uint8_t program[] = { 1, 1, 2, 3, 1, 4, 2, 0 };
+    uint32_t accumulator = 0;
+    for (unsigned pass = 0; pass < 0x2000; pass++) {
+        for (const uint8_t * op = program; *op; op++) {
+            switch (*op) {
+                case 1: accumulator += 3; break;
+                case 2: accumulator -= 1; break;
+                case 3: accumulator ^= 0x55; break;
+                case 4: accumulator = accumulator << 1 | accumulator >> 31; break;
+            }
+        }
+    }
+    cester_assert_uint_ne(0, accumulator);
+)
+
+CESTER_TEST(rewriteHotCode, test_instance,
+    for (unsigned round = 0; round < 4; round++) {
+        uint32_t (*func)(void) = setReturnValue(round);
+        uint32_t sum = 0;
+        for (unsigned i = 0; i < 0x1000; i++) {
+            sum += func();
+        }
+        cester_assert_uint_eq(sum, round * 0x1000);
+    }
+)
@@ -0,0 +1,138 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdint.h>
+
+#include "common/syscalls/syscalls.h"
+
+#undef unix
+#define CESTER_NO_SIGNAL
+#define CESTER_NO_TIME
+#define EXIT_SUCCESS 0
+#define EXIT_FAILURE 1
+#include "exotic/cester.h"
+
+// clang-format off
+
+/* Write-heavy workloads, along with a few self-modifying code checks. The stores to the data buffer land on pages
+   which never held any code, so the CPU cores shouldn't have to invalidate anything for them. */
+
+CESTER_BODY(
+    static uint32_t s_data[0x10000];
+    static uint32_t s_code[4];
+
+    static uint32_t (*setReturnValue(uint16_t value))(void) {
+        s_code[0] = 0x03e00008;          // jr    $ra
+        s_code[1] = 0x24020000 | value;  // addiu $v0, $0, value
+        syscall_flushCache();
+        return (uint32_t(*)(void))s_code;
+    }
+
+    static uint32_t s_chain[36];
+    static uint32_t * volatile s_chainPointer = s_chain;
+
+    // 18 blocks jumping to the next one, which is more than a single trace can go through. Runs from the uncached
+    // mirror, so that rewriting it doesn't require flushing the instruction cache, which would hide stale traces.
+    static uint32_t (*buildChain(void))(void) {
+        uint32_t * code = s_chainPointer;
+        uint32_t base = (uint32_t)code | 0xa0000000;
+        for (unsigned i = 0; i < 17; i++) {
+            code[i * 2 + 0] = 0x08000000 | (((base + (i + 1) * 8) >> 2) & 0x03ffffff);  // j     next
+            code[i * 2 + 1] = 0;                                                         // nop
+        }
+        code[34] = 0x03e00008;  // jr    $ra
+        code[35] = 0x24020001;  // addiu $v0, $0, 1
+        return (uint32_t(*)(void))base;
+    }
+)
+
+CESTER_TEST(wordStores, test_instance,
+    volatile uint32_t * data = s_data;
+    for (unsigned pass = 0; pass < 64; pass++) {
+        for (unsigned i = 0; i < 0x10000; i++) {
+            data[i] = i + pass;
+        }
+    }
+    cester_assert_uint_eq(data[0], 63);
+    cester_assert_uint_eq(data[0xffff], 0xffff + 63);
+)
+
+CESTER_TEST(halfStores, test_instance,
+    volatile uint16_t * data = (uint16_t *)s_data;
+    for (unsigned pass = 0; pass < 32; pass++) {
+        for (unsigned i = 0; i < 0x20000; i++) {
+            data[i] = i ^ pass;
+        }
+    }
+    cester_assert_uint_eq(data[1], 1 ^ 31);
+    cester_assert_uint_eq(data[0x1ffff], 0xffff ^ 31);
+)
+
+CESTER_TEST(byteStores, test_instance,
+    volatile uint8_t * data = (uint8_t *)s_data;
+    for (unsigned pass = 0; pass < 16; pass++) {
+        for (unsigned i = 0; i < 0x40000; i++) {
+            data[i] = i + pass;
+        }
+    }
+    cester_assert_uint_eq(data[0], 15);
+    cester_assert_uint_eq(data[0x3ffff], 0x0e);
+)
+
+CESTER_TEST(rewriteCode, test_instance,
+    cester_assert_uint_eq(setReturnValue(1)(), 1);
+    cester_assert_uint_eq(setReturnValue(2)(), 2);
+    cester_assert_uint_eq(setReturnValue(3)(), 3);
+)
+
+CESTER_TEST(rewriteCodeBetweenStores, test_instance,
+    volatile uint32_t * data = s_data;
+    for (unsigned i = 0; i < 16; i++) {
+        for (unsigned j = 0; j < 0x1000; j++) {
+            data[j] = j;
+        }
+        cester_assert_uint_eq(setReturnValue(i)(), i);
+    }
+)
+
+CESTER_TEST(rewriteTraceSegment, test_instance,
+    uint32_t (*chain)(void) = buildChain();
+    uint32_t (*second)(void) = (uint32_t(*)(void))((uint32_t)chain + 8);
+    uint32_t sum = 0;
+    // Hot enough to get compiled as a trace from the first block, then as another one from the second block
+    for (unsigned i = 0; i < 2000; i++) sum += chain();
+    for (unsigned i = 0; i < 2000; i++) sum += second();
+    cester_assert_uint_eq(sum, 4000);
+
+    // Rewriting the last block drops the second trace. The first one still goes through the second block, so
+    // rewriting that one afterwards, through a pointer only known at runtime, has to drop it too.
+    uint32_t * code = s_chainPointer;
+    code[34] = 0x03e00008;  // jr    $ra
+    code[2] = 0x03e00008;   // jr    $ra
+    code[3] = 0x24020002;   // addiu $v0, $0, 2
+    cester_assert_uint_eq(chain(), 2);
+    cester_assert_uint_eq(second(), 2);
+)
@@ -62,6 +62,7 @@ void PCSX::SPU::impl::writeDMAMem(uint16_t* mainMem, int size) {
 
     for (int i = 0; i < size; i++) {
         spuMem[spuAddr >> 1] = *mainMem++;  // Copy 2 bytes
+        markDirty(spuAddr);
         spuAddr = (spuAddr + 2) & 0x7ffff;  // Increment SPU address and wrap around
     }
 
@@ -37,7 +37,11 @@
 #include "spu/interface.h"
 #include "spu/registers.h"
 
-void PCSX::SPU::impl::save(SaveStates::SPU &spu) {
+void PCSX::SPU::impl::save(SaveStates::SPU &spu) { save(spu, false); }
+
+void PCSX::SPU::impl::saveIncremental(SaveStates::SPU &spu) { save(spu, true); }
+
+void PCSX::SPU::impl::save(SaveStates::SPU &spu, bool incremental) {
     RemoveThread();
 
     // Capture buffer
@@ -48,7 +52,14 @@ void PCSX::SPU::impl::save(SaveStates::SPU &spu) {
     spu.get<SaveStates::CBStartIndex>().value = captureBuffer.startIndex;
     spu.get<SaveStates::CBVoiceIndex>().value = capBufVoiceIndex;
 
-    spu.get<SaveStates::SPURam>().copyFrom(reinterpret_cast<uint8_t *>(spuMem));
+    if (incremental) {
+        // The first page holds the capture buffers.
+        m_dirtyPages[0] = 1;
+        markReverbDirty();
+        SaveStates::savePages(spu.get<SaveStates::SPURamPages>(), spuMemC, m_dirtyPages, c_ramPageCount);
+    } else {
+        spu.get<SaveStates::SPURam>().copyFrom(reinterpret_cast<uint8_t *>(spuMem));
+    }
     spu.get<SaveStates::SPUPorts>().copyFrom(reinterpret_cast<uint8_t *>(regArea));
     auto &xa = spu.get<SaveStates::XAField>();
     if (xapGlobal) {
@@ -162,5 +173,7 @@ void PCSX::SPU::impl::load(const SaveStates::SPU &spu) {
         }
     }
 
+    memset(m_dirtyPages, 1, sizeof(m_dirtyPages));
+
     SetupThread();  // start sound processing again
 }
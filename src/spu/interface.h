@@ -20,6 +20,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <string.h>
 
 #include <thread>
 
@@ -56,7 +57,9 @@ class impl final : public SPUInterface {
     virtual void playADPCMchannel(xa_decode_t *) final;
 
     void save(SaveStates::SPU &) final;
+    void saveIncremental(SaveStates::SPU &) final;
     void load(const SaveStates::SPU &) final;
+    void clearDirtyPages() final { memset(m_dirtyPages, 0, sizeof(m_dirtyPages)); }
 
     virtual void setLua(Lua L) override;
 
@@ -85,6 +88,8 @@ class impl final : public SPUInterface {
     }
     uint32_t getCurrentFrames() override { return m_audioOut.getCurrentFrames(); }
     void waitForGoal(uint32_t goal) override { m_audioOut.waitForGoal(goal); }
+    void setOutputSink(IO<File> sink) override { m_audioOut.setSink(sink); }
+    void setOutputSinkGoal(uint32_t goal) override { m_audioOut.setSinkGoal(goal); }
 
   private:
     struct ADSRFlags {
@@ -201,6 +206,19 @@ class impl final : public SPUInterface {
     // Note that SPU ram is a uint16_t, so total size is 512KB.
     uint16_t spuMem[256 * 1024];
     uint8_t *spuMemC;
+
+    // SPU ram in 4KB pages, flagged by the transfers from the CPU side. The mixer thread keeps writing to the
+    // capture buffers and to the reverb work area on its own, so these are always saved in full instead.
+    static constexpr unsigned c_ramPageShift = 12;
+    static constexpr unsigned c_ramPageCount = sizeof(spuMem) >> c_ramPageShift;
+    uint8_t m_dirtyPages[c_ramPageCount] = {};
+    void markDirty(uint32_t address) { m_dirtyPages[(address & 0x7ffff) >> c_ramPageShift] = 1; }
+    void markReverbDirty() {
+        if (!rvb.StartAddr) return;
+        memset(m_dirtyPages + ((rvb.StartAddr * 2) >> c_ramPageShift), 1,
+               c_ramPageCount - ((rvb.StartAddr * 2) >> c_ramPageShift));
+    }
+    void save(SaveStates::SPU &, bool incremental);
     uint8_t *pSpuIrq = 0;
     uint8_t *pSpuBuffer;
     uint8_t *pMixIrq = 0;
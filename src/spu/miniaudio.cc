@@ -19,6 +19,8 @@
 
 #include "spu/miniaudio.h"
 
+#include <algorithm>
+#include <chrono>
 #include <limits>
 #include <stdexcept>
 
@@ -221,6 +223,8 @@ void PCSX::SPU::MiniAudio::callback(ma_device* device, float* output, ma_uint32
 
 void PCSX::SPU::MiniAudio::callbackNull(ma_device* device, float* output, ma_uint32 frameCount) {
     m_frameCount.store(frameCount);
+    // The sink is the one counting frames while it's active.
+    if (m_sinkActive.load()) return;
 
     auto total = m_frames.fetch_add(frameCount);
 
@@ -243,3 +247,67 @@ void PCSX::SPU::MiniAudio::callbackNull(ma_device* device, float* output, ma_uin
     m_cv.notify_one();
 #endif
 }
+
+void PCSX::SPU::MiniAudio::setSink(IO<File> sink) {
+    {
+        std::unique_lock<std::mutex> l(m_sinkMu);
+        m_sink = sink;
+        m_sinkGoal = m_frames.load();
+        m_sinkActive.store(!!sink);
+    }
+    m_sinkCV.notify_all();
+}
+
+void PCSX::SPU::MiniAudio::setSinkGoal(uint32_t goal) {
+    {
+        std::unique_lock<std::mutex> l(m_sinkMu);
+        if (m_sinkGoal == goal) return;
+        m_sinkGoal = goal;
+    }
+    m_sinkCV.notify_all();
+}
+
+bool PCSX::SPU::MiniAudio::feedSink(const Frame* data, size_t frames, unsigned streamId) {
+    using namespace std::chrono_literals;
+    switch (streamId) {
+        case 0:
+            break;
+        case 1:
+            // Mixed along with the voices when they come in. Dropping some of it beats stalling the emulation.
+            m_audioStream.enqueue(data, frames, 0ms);
+            return true;
+        default:
+            throw std::runtime_error("Invalid stream ID");
+    }
+    if (frames > VoiceStream::BUFFER_SIZE) {
+        throw std::runtime_error("Trying to enqueue too much data");
+    }
+
+    std::unique_lock<std::mutex> lock(m_sinkMu);
+    const bool ready = m_sinkCV.wait_for(lock, 200ms, [this, frames]() {
+        return !m_sinkActive.load() || (int32_t(m_sinkGoal - m_frames.load()) >= int32_t(frames));
+    });
+    // Returning false makes the mixer try again, which will go to the audio device if the sink went away meanwhile.
+    if (!ready || !m_sinkActive.load()) return false;
+
+    constexpr int32_t c_min = std::numeric_limits<int16_t>::min();
+    constexpr int32_t c_max = std::numeric_limits<int16_t>::max();
+    const bool mono = m_settings.get<Mono>();
+    const bool muted = m_settings.get<Mute>();
+    const size_t cdda = m_audioStream.dequeue(m_sinkAudio.data(), frames);
+    for (size_t f = 0; f < frames; f++) {
+        int32_t l = data[f].L;
+        int32_t r = data[f].R;
+        if (f < cdda) {
+            l += m_sinkAudio[f].L;
+            r += m_sinkAudio[f].R;
+        }
+        if (mono) l = r = (l + r) / 2;
+        if (muted) l = r = 0;
+        m_sinkMixed[f].L = std::clamp<int32_t>(l, c_min, c_max);
+        m_sinkMixed[f].R = std::clamp<int32_t>(r, c_min, c_max);
+    }
+    m_sink->write(m_sinkMixed.data(), frames * sizeof(Frame));
+    m_frames.fetch_add(frames);
+    return true;
+}
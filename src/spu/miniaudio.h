@@ -23,6 +23,8 @@
 
 #include <array>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -38,6 +40,7 @@
 #include "spu/settings.h"
 #include "support/circular.h"
 #include "support/eventbus.h"
+#include "support/file.h"
 
 #if defined(_MSC_VER) || defined(__linux__)
 #define HAS_ATOMIC_WAIT 1
@@ -64,6 +67,7 @@ class MiniAudio {
     const std::vector<std::string>& getBackends() { return m_backends; }
     const std::vector<std::string>& getDevices() { return m_devices; }
     bool feedStreamData(const Frame* data, size_t frames, unsigned streamId = 0) {
+        if (m_sinkActive.load()) return feedSink(data, frames, streamId);
         switch (streamId) {
             case 0:
                 return m_voicesStream.enqueue(data, frames);
@@ -106,11 +110,18 @@ class MiniAudio {
 #endif
     }
 
+    // While a sink is set, the audio device stops being the clock, and starves. The mixed output is written to the
+    // sink instead, as raw 16 bits stereo samples at 44.1kHz, and the mixer only gets to produce as many frames as
+    // the emulation says it went through with setSinkGoal. Setting an empty sink goes back to the audio device.
+    void setSink(IO<File> sink);
+    void setSinkGoal(uint32_t goal);
+
   private:
     static constexpr unsigned STREAMS = 2;
     SettingsType& m_settings;
     void callback(ma_device* device, float* output, ma_uint32 frameCount);
     void callbackNull(ma_device* device, float* output, ma_uint32 frameCount);
+    bool feedSink(const Frame* data, size_t frames, unsigned streamId);
     void init(bool safe = false);
     void uninit();
     void maybeRestart();
@@ -139,6 +150,14 @@ class MiniAudio {
 #endif
     uint32_t m_previousGoalpost = 0;
 
+    std::atomic<bool> m_sinkActive = false;
+    IO<File> m_sink;
+    uint32_t m_sinkGoal = 0;
+    std::mutex m_sinkMu;
+    std::condition_variable m_sinkCV;
+    Buffer m_sinkAudio;
+    Buffer m_sinkMixed;
+
     std::vector<std::string> m_backends;
     std::vector<std::string> m_devices;
 
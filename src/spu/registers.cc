@@ -218,6 +218,7 @@ void PCSX::SPU::impl::writeRegister(uint32_t reg, uint16_t val) {
 
         case H_SPUdata:
             spuMem[spuAddr >> 1] = val;
+            markDirty(spuAddr);
             spuAddr += 2;
             if (spuAddr > 0x7ffff) {
                 spuAddr = 0;
@@ -237,6 +238,8 @@ void PCSX::SPU::impl::writeRegister(uint32_t reg, uint16_t val) {
             break;
 
         case H_SPUReverbAddr:
+            // The mixer may have written all over the old work area, which isn't going to be saved in full anymore.
+            markReverbDirty();
             if (val == 0xFFFF || val <= 0x200) {
                 rvb.StartAddr = rvb.CurrAddr = 0;
             } else {
@@ -879,6 +879,7 @@ void PCSX::SPU::impl::playADPCMchannel(xa_decode_t *xap) {
 
 long PCSX::SPU::impl::init(void) {
     spuMemC = (uint8_t *)spuMem;  // just small setup
+    memset(m_dirtyPages, 1, sizeof(m_dirtyPages));
 
     wipeChannels();
     return 0;
@@ -991,6 +992,7 @@ bool PCSX::SPU::impl::open() {
     bEndThread = 0;
     bThreadEnded = 0;
     spuMemC = (uint8_t *)spuMem;
+    memset(m_dirtyPages, 1, sizeof(m_dirtyPages));
     pMixIrq = 0;
     wipeChannels();
     pSpuIrq = 0;
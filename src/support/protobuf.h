@@ -52,8 +52,14 @@ class InSlice {
     InSlice getSubSlice(uint64_t size) {
         boundsCheck(size);
         m_ptr += size;
-        return InSlice(m_data + m_ptr - size, size);
-    }
+        InSlice subSlice(m_data + m_ptr - size, size);
+        subSlice.m_references = m_references;
+        return subSlice;
+    }
+    // Lets the fixed size byte fields point straight into the input instead of copying out of it,
+    // which means the input has to outlive everything deserialized from it.
+    void allowReferences() { m_references = true; }
+    constexpr bool referencesAllowed() const { return m_references; }
     constexpr uint8_t getU8() {
         boundsCheck(1);
         return getU8Safe();
@@ -92,6 +98,10 @@ class InSlice {
         skipBytes(size);
         memcpy(data, m_data + m_ptr - size, size);
     }
+    const uint8_t *getView(uint64_t size) {
+        skipBytes(size);
+        return m_data + m_ptr - size;
+    }
     constexpr void skipBytes(uint64_t size) {
         boundsCheck(size);
         m_ptr += size;
@@ -112,6 +122,7 @@ class InSlice {
     const uint8_t *m_data;
     const uint64_t m_size;
     uint64_t m_ptr = 0;
+    bool m_references = false;
 
     constexpr uint8_t getU8Safe() { return m_data[m_ptr++]; }
 
@@ -122,35 +133,47 @@ class InSlice {
 
 class OutSlice {
   public:
-    void putU8(uint8_t value) { m_data += std::string(reinterpret_cast<const char *>(&value), 1); }
+    static constexpr uint64_t varIntSize(uint64_t value) {
+        uint64_t size = 1;
+        while (value >>= 7) size++;
+        return size;
+    }
+    // Callers which know the final encoded size up front, such as Message::serializedSize(),
+    // should reserve it so the whole message is written into a single allocation.
+    void reserve(uint64_t size) { m_data.reserve(size); }
+    void putU8(uint8_t value) { m_data.push_back(static_cast<char>(value)); }
     void putU16(uint16_t value) {
-        putU8(value & 0xff);
-        value >>= 8;
-        putU8(value & 0xff);
+        char bytes[2] = {static_cast<char>(value), static_cast<char>(value >> 8)};
+        m_data.append(bytes, 2);
     }
     void putU32(uint32_t value) {
-        putU16(value & 0xffff);
-        value >>= 16;
-        putU16(value & 0xffff);
+        char bytes[4];
+        for (unsigned i = 0; i < 4; i++) {
+            bytes[i] = static_cast<char>(value >> (i * 8));
+        }
+        m_data.append(bytes, 4);
     }
     void putU64(uint64_t value) {
-        putU32(value & 0xffffffff);
-        value >>= 32;
-        putU32(value & 0xffffffff);
-    }
-    void putBytes(const uint8_t *bytes, uint64_t size) {
-        m_data += std::string(reinterpret_cast<const char *>(bytes), size);
+        char bytes[8];
+        for (unsigned i = 0; i < 8; i++) {
+            bytes[i] = static_cast<char>(value >> (i * 8));
+        }
+        m_data.append(bytes, 8);
     }
+    void putBytes(const uint8_t *bytes, uint64_t size) { m_data.append(reinterpret_cast<const char *>(bytes), size); }
     void putBytes(const std::string &str) { m_data += str; }
     void putSlice(OutSlice *slice) { m_data += slice->m_data; }
     void putVarInt(uint64_t value) {
-        uint8_t b = 0;
+        char bytes[10];
+        unsigned size = 0;
         do {
-            b = value & 0x7f;
+            uint8_t b = value & 0x7f;
             value >>= 7;
-            putU8(b | (value ? 0x80 : 0x00));
+            bytes[size++] = static_cast<char>(b | (value ? 0x80 : 0x00));
         } while (value);
+        m_data.append(bytes, size);
     }
+    uint64_t size() const { return m_data.size(); }
     std::string finalize() { return std::move(m_data); }
 
   private:
@@ -173,6 +196,7 @@ struct FieldType {
 #if 0
 struct Int8 : public FieldType<int8_t, 0> {
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<int8_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "int32";
 };
@@ -181,6 +205,7 @@ struct Int8 : public FieldType<int8_t, 0> {
 struct Int16 : public FieldType<int16_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<int16_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "int32";
 };
@@ -188,6 +213,7 @@ struct Int16 : public FieldType<int16_t, 0> {
 struct Int32 : public FieldType<int32_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<int32_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "int32";
 };
@@ -195,6 +221,7 @@ struct Int32 : public FieldType<int32_t, 0> {
 struct Int64 : public FieldType<int64_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getVarInt(); }
     static constexpr char const typeName[] = "int64";
 };
@@ -202,6 +229,7 @@ struct Int64 : public FieldType<int64_t, 0> {
 struct UInt8 : public FieldType<uint8_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<uint8_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "uint32";
 };
@@ -209,6 +237,7 @@ struct UInt8 : public FieldType<uint8_t, 0> {
 struct UInt16 : public FieldType<uint16_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<uint16_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "uint32";
 };
@@ -216,6 +245,7 @@ struct UInt16 : public FieldType<uint16_t, 0> {
 struct UInt32 : public FieldType<uint32_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = static_cast<uint32_t>(slice->getVarInt()); }
     static constexpr char const typeName[] = "uint32";
 };
@@ -223,6 +253,7 @@ struct UInt32 : public FieldType<uint32_t, 0> {
 struct UInt64 : public FieldType<uint64_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getVarInt(); }
     static constexpr char const typeName[] = "uint64";
 };
@@ -230,6 +261,7 @@ struct UInt64 : public FieldType<uint64_t, 0> {
 struct SInt32 : public FieldType<int32_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt((value << 1) ^ (value >> 31)); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize((value << 1) ^ (value >> 31)); }
     constexpr void deserialize(InSlice *slice, unsigned) {
         value = static_cast<int32_t>(slice->getVarInt());
         value = (value >> 1) ^ -(value & 1);
@@ -240,6 +272,7 @@ struct SInt32 : public FieldType<int32_t, 0> {
 struct SInt64 : public FieldType<int64_t, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt((value << 1) ^ (value >> 63)); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize((value << 1) ^ (value >> 63)); }
     constexpr void deserialize(InSlice *slice, unsigned) {
         value = slice->getVarInt();
         value = (value >> 1) ^ -(value & 1);
@@ -250,6 +283,7 @@ struct SInt64 : public FieldType<int64_t, 0> {
 struct Bool : public FieldType<bool, 0> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putVarInt(value); }
+    constexpr uint64_t serializedSize() const { return OutSlice::varIntSize(value); }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getVarInt(); }
     static constexpr char const typeName[] = "bool";
 };
@@ -257,6 +291,7 @@ struct Bool : public FieldType<bool, 0> {
 struct Fixed64 : public FieldType<uint64_t, 1> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU64(value); }
+    static constexpr uint64_t serializedSize() { return 8; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU64(); }
     static constexpr char const typeName[] = "fixed64";
 };
@@ -264,6 +299,7 @@ struct Fixed64 : public FieldType<uint64_t, 1> {
 struct SFixed64 : public FieldType<int64_t, 1> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU64(value); }
+    static constexpr uint64_t serializedSize() { return 8; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU64(); }
     static constexpr char const typeName[] = "sfixed64";
 };
@@ -277,6 +313,7 @@ struct Double : public FieldType<double, 1> {
         } u = {value};
         slice->putU64(u.v);
     }
+    static constexpr uint64_t serializedSize() { return 8; }
     constexpr void deserialize(InSlice *slice, unsigned) {
         union {
             uint64_t v;
@@ -293,6 +330,7 @@ struct String : public FieldType<std::string, 2> {
         slice->putVarInt(value.size());
         slice->putBytes(value);
     }
+    uint64_t serializedSize() const { return OutSlice::varIntSize(value.size()) + value.size(); }
     void deserialize(InSlice *slice, unsigned) { value = slice->getBytes(slice->getVarInt()); }
     static constexpr char const typeName[] = "string";
 };
@@ -303,17 +341,16 @@ struct Bytes : public FieldType<std::string, 2> {
         slice->putVarInt(value.size());
         slice->putBytes(value);
     }
+    uint64_t serializedSize() const { return OutSlice::varIntSize(value.size()) + value.size(); }
     void deserialize(InSlice *slice, unsigned) { value = slice->getBytes(slice->getVarInt()); }
     static constexpr char const typeName[] = "bytes";
 };
 
 template <size_t amount>
 struct FixedBytes {
-    ~FixedBytes() { delete[] value; }
+    ~FixedBytes() { release(); }
     FixedBytes() {}
     FixedBytes(const FixedBytes &s) {
-        delete[] value;
-        value = nullptr;
         if (!s.value) return;
         allocate();
         memcpy(value, s.value, amount);
@@ -321,24 +358,43 @@ struct FixedBytes {
     FixedBytes(FixedBytes &&s) {
         if (!s.value) return;
         value = s.value;
+        m_borrowed = s.m_borrowed;
         s.value = nullptr;
+        s.m_borrowed = false;
     }
     static constexpr bool needsToSerializeHeader() { return false; }
     constexpr void serialize(OutSlice *slice) const {
         slice->putVarInt(amount);
         slice->putBytes(value, amount);
     }
+    static constexpr uint64_t serializedSize() { return OutSlice::varIntSize(amount) + amount; }
     constexpr void deserialize(InSlice *slice, unsigned) {
         uint64_t size = slice->getVarInt();
         if (size > amount) throw OutOfBoundError();
+        if ((size == amount) && slice->referencesAllowed()) {
+            release();
+            value = const_cast<uint8_t *>(slice->getView(size));
+            m_borrowed = true;
+            return;
+        }
         reset();
         slice->getBytes(value, size);
     }
     static constexpr char const typeName[] = "bytes";
+    // Read only while it points into the input of deserialize; see InSlice::allowReferences.
     uint8_t *value = nullptr;
     constexpr void allocate() {
+        if (m_borrowed) release();
         if (!value) value = new uint8_t[amount];
     }
+    // Turns a reference into the input into a copy, so it can be written to.
+    void own() {
+        if (!m_borrowed) return;
+        const uint8_t *src = value;
+        m_borrowed = false;
+        value = new uint8_t[amount];
+        memcpy(value, src, amount);
+    }
     void copyFrom(const uint8_t *src) {
         allocate();
         memcpy(value, src, amount);
@@ -358,11 +414,20 @@ struct FixedBytes {
     static constexpr unsigned wireType = 2;
     static constexpr bool matches(unsigned otherWireType) { return otherWireType == 2; }
     constexpr bool hasData() const { return value; }
+
+  private:
+    constexpr void release() {
+        if (!m_borrowed) delete[] value;
+        value = nullptr;
+        m_borrowed = false;
+    }
+    bool m_borrowed = false;
 };
 
 struct Fixed32 : public FieldType<uint32_t, 5> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU32(value); }
+    static constexpr uint64_t serializedSize() { return 4; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU32(); }
     static constexpr char const typeName[] = "fixed32";
 };
@@ -370,6 +435,7 @@ struct Fixed32 : public FieldType<uint32_t, 5> {
 struct SFixed32 : public FieldType<int32_t, 5> {
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const { slice->putU32(value); }
+    static constexpr uint64_t serializedSize() { return 4; }
     constexpr void deserialize(InSlice *slice, unsigned) { value = slice->getU32(); }
     static constexpr char const typeName[] = "sfixed32";
 };
@@ -383,6 +449,7 @@ struct Float : public FieldType<float, 5> {
         } u = {value};
         slice->putU32(u.v);
     }
+    static constexpr uint64_t serializedSize() { return 4; }
     constexpr void deserialize(InSlice *slice, unsigned) {
         union {
             uint64_t v;
@@ -434,6 +501,10 @@ struct FieldRef<FieldType, irqus::typestring<C...>, fieldNumberValue> {
         const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
         field->serialize(slice);
     }
+    constexpr uint64_t serializedSize() const {
+        const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
+        return field->serializedSize();
+    }
     constexpr void deserialize(InSlice *slice, unsigned wireType) {
         FieldType *field = reinterpret_cast<FieldType *>(&copy);
         field->deserialize(slice, wireType);
@@ -472,11 +543,16 @@ struct FieldPtr<FieldType, irqus::typestring<C...>, fieldNumberValue> {
         const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
         field->serialize(slice);
     }
+    constexpr uint64_t serializedSize() const {
+        const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
+        return field->serializedSize();
+    }
     constexpr void deserialize(InSlice *slice, unsigned wireType) { copy.deserialize(slice, wireType); }
     constexpr void reset() {}
+    // Leaves the destination alone when the field wasn't in the input.
     constexpr void commit() {
-        FieldType *field = reinterpret_cast<FieldType *>(&ref);
-        field->copyFrom(copy.value);
+        if (!copy.hasData() || !ref) return;
+        copy.copyTo(ref);
     }
     constexpr bool hasData() const {
         const FieldType *field = reinterpret_cast<const FieldType *>(&ref);
@@ -514,23 +590,30 @@ struct RepeatedField<FieldType, amount, irqus::typestring<C...>, fieldNumberValu
     void serialize(OutSlice *slice) const {
         if (FieldType::wireType == 2) {
             for (const auto &v : value) {
-                OutSlice subSlice;
-                v.serialize(&subSlice);
-                std::string subSliceData = subSlice.finalize();
                 slice->putVarInt((fieldNumber << 3) | FieldType::wireType);
-                slice->putVarInt(subSliceData.size());
-                slice->putBytes(subSliceData);
+                slice->putVarInt(v.serializedSize());
+                v.serialize(slice);
             }
         } else {
-            OutSlice subSlice;
+            slice->putVarInt(packedSize());
             for (const auto &v : value) {
-                v.serialize(&subSlice);
+                v.serialize(slice);
             }
-            std::string subSliceData = subSlice.finalize();
-            slice->putVarInt(subSliceData.size());
-            slice->putBytes(subSliceData);
         }
     }
+    uint64_t serializedSize() const {
+        if (FieldType::wireType == 2) {
+            constexpr uint64_t headerSize = OutSlice::varIntSize((fieldNumber << 3) | FieldType::wireType);
+            uint64_t size = 0;
+            for (const auto &v : value) {
+                uint64_t elementSize = v.serializedSize();
+                size += headerSize + OutSlice::varIntSize(elementSize) + elementSize;
+            }
+            return size;
+        }
+        uint64_t size = packedSize();
+        return OutSlice::varIntSize(size) + size;
+    }
     void deserialize(InSlice *slice, unsigned wireType) {
         if (FieldType::wireType != wireType) {
             InSlice subSlice = slice->getSubSlice(slice->getVarInt());
@@ -545,6 +628,13 @@ struct RepeatedField<FieldType, amount, irqus::typestring<C...>, fieldNumberValu
     constexpr void commit() {}
 
   private:
+    uint64_t packedSize() const {
+        uint64_t size = 0;
+        for (const auto &v : value) {
+            size += v.serializedSize();
+        }
+        return size;
+    }
     void deserializeOne(InSlice *slice, unsigned wireType) {
         if (count >= amount) throw OutOfBoundError();
         if (FieldType::wireType == 2) {
@@ -583,25 +673,33 @@ struct RepeatedFieldRef<FieldType, amount, irqus::typestring<C...>, fieldNumberV
     void serialize(OutSlice *slice) const {
         if (FieldType::wireType == 2) {
             for (size_t i = 0; i < amount; i++) {
-                OutSlice subSlice;
                 FieldType *field = reinterpret_cast<FieldType *>(ref + i);
-                field->serialize(&subSlice);
-                std::string subSliceData = subSlice.finalize();
                 slice->putVarInt((fieldNumber << 3) | FieldType::wireType);
-                slice->putVarInt(subSliceData.size());
-                slice->putBytes(subSliceData);
+                slice->putVarInt(field->serializedSize());
+                field->serialize(slice);
             }
         } else {
-            OutSlice subSlice;
+            slice->putVarInt(packedSize());
             for (size_t i = 0; i < amount; i++) {
                 FieldType *field = reinterpret_cast<FieldType *>(ref + i);
-                field->serialize(&subSlice);
+                field->serialize(slice);
             }
-            std::string subSliceData = subSlice.finalize();
-            slice->putVarInt(subSliceData.size());
-            slice->putBytes(subSliceData);
         }
     }
+    uint64_t serializedSize() const {
+        if (FieldType::wireType == 2) {
+            constexpr uint64_t headerSize = OutSlice::varIntSize((fieldNumber << 3) | FieldType::wireType);
+            uint64_t size = 0;
+            for (size_t i = 0; i < amount; i++) {
+                FieldType *field = reinterpret_cast<FieldType *>(ref + i);
+                uint64_t elementSize = field->serializedSize();
+                size += headerSize + OutSlice::varIntSize(elementSize) + elementSize;
+            }
+            return size;
+        }
+        uint64_t size = packedSize();
+        return OutSlice::varIntSize(size) + size;
+    }
     void deserialize(InSlice *slice, unsigned wireType) {
         if (FieldType::wireType != wireType) {
             InSlice subSlice = slice->getSubSlice(slice->getVarInt());
@@ -616,6 +714,14 @@ struct RepeatedFieldRef<FieldType, amount, irqus::typestring<C...>, fieldNumberV
     constexpr void commit() { memcpy(ref, copy, amount * sizeof(innerType)); }
 
   private:
+    uint64_t packedSize() const {
+        uint64_t size = 0;
+        for (size_t i = 0; i < amount; i++) {
+            FieldType *field = reinterpret_cast<FieldType *>(ref + i);
+            size += field->serializedSize();
+        }
+        return size;
+    }
     void deserializeOne(InSlice *slice, unsigned wireType) {
         if (count >= amount) throw OutOfBoundError();
         FieldType *field = reinterpret_cast<FieldType *>(copy + count++);
@@ -651,22 +757,29 @@ struct RepeatedVariableField<FieldType, irqus::typestring<C...>, fieldNumberValu
     void serialize(OutSlice *slice) const {
         if (FieldType::wireType == 2) {
             for (const auto &v : value) {
-                OutSlice subSlice;
-                v.serialize(&subSlice);
-                std::string subSliceData = subSlice.finalize();
                 slice->putVarInt((fieldNumber << 3) | FieldType::wireType);
-                slice->putVarInt(subSliceData.size());
-                slice->putBytes(subSliceData);
+                slice->putVarInt(v.serializedSize());
+                v.serialize(slice);
             }
         } else {
-            OutSlice subSlice;
+            slice->putVarInt(packedSize());
+            for (const auto &v : value) {
+                v.serialize(slice);
+            }
+        }
+    }
+    uint64_t serializedSize() const {
+        if (FieldType::wireType == 2) {
+            constexpr uint64_t headerSize = OutSlice::varIntSize((fieldNumber << 3) | FieldType::wireType);
+            uint64_t size = 0;
             for (const auto &v : value) {
-                v.serialize(&subSlice);
+                uint64_t elementSize = v.serializedSize();
+                size += headerSize + OutSlice::varIntSize(elementSize) + elementSize;
             }
-            std::string subSliceData = subSlice.finalize();
-            slice->putVarInt(subSliceData.size());
-            slice->putBytes(subSliceData);
+            return size;
         }
+        uint64_t size = packedSize();
+        return OutSlice::varIntSize(size) + size;
     }
     void deserialize(InSlice *slice, unsigned wireType) {
         if (FieldType::wireType != wireType) {
@@ -682,6 +795,13 @@ struct RepeatedVariableField<FieldType, irqus::typestring<C...>, fieldNumberValu
     constexpr void commit() {}
 
   private:
+    uint64_t packedSize() const {
+        uint64_t size = 0;
+        for (const auto &v : value) {
+            size += v.serializedSize();
+        }
+        return size;
+    }
     void deserializeOne(InSlice *slice, unsigned wireType) {
         value.resize(++count);
         if (FieldType::wireType == 2) {
@@ -714,11 +834,12 @@ struct MessageField<MessageType, irqus::typestring<C...>, fieldNumberValue> : pu
     }
     static constexpr bool needsToSerializeHeader() { return false; }
     void serialize(OutSlice *slice) const {
-        OutSlice subSlice;
-        MessageType::serialize(&subSlice);
-        std::string subSliceData = subSlice.finalize();
-        slice->putVarInt(subSliceData.size());
-        slice->putBytes(subSliceData);
+        slice->putVarInt(MessageType::serializedSize());
+        MessageType::serialize(slice);
+    }
+    uint64_t serializedSize() const {
+        uint64_t size = MessageType::serializedSize();
+        return OutSlice::varIntSize(size) + size;
     }
     void deserialize(InSlice *slice, unsigned wireType) {
         InSlice subSlice = slice->getSubSlice(slice->getVarInt());
@@ -760,6 +881,8 @@ class Message<irqus::typestring<C...>, fields...> : private std::tuple<fields...
     }
     static constexpr bool needsToSerializeHeader() { return false; }
     constexpr void serialize(OutSlice *slice) const { serialize<0, fields...>(slice); }
+    // Exact number of bytes serialize() will emit, without the length prefix of an embedding field.
+    constexpr uint64_t serializedSize() const { return serializedSize<0, fields...>(); }
     constexpr void deserialize(InSlice *slice, unsigned wireType) {
         while (slice->bytesLeft()) {
             uint64_t fieldNumber = slice->getVarInt();
@@ -822,6 +945,22 @@ class Message<irqus::typestring<C...>, fields...> : private std::tuple<fields...
         serialize<index + 1, nestedFields...>(slice);
     }
     template <size_t index>
+    constexpr uint64_t serializedSize() const {
+        return 0;
+    }
+    template <size_t index, typename FieldType, typename... nestedFields>
+    constexpr uint64_t serializedSize() const {
+        const FieldType &field = std::get<index>(*this);
+        uint64_t size = 0;
+        if (field.hasData()) {
+            if (!FieldType::needsToSerializeHeader()) {
+                size += OutSlice::varIntSize((FieldType::fieldNumber << 3) | FieldType::wireType);
+            }
+            size += field.serializedSize();
+        }
+        return size + serializedSize<index + 1, nestedFields...>();
+    }
+    template <size_t index>
     constexpr void deserialize(uint64_t fieldNumber, unsigned wireType, InSlice *slice) {
         // Unknown field, skip it.
         switch (wireType) {
@@ -890,6 +1029,7 @@ class EmptyMessage<irqus::typestring<C...>> {
     constexpr void reset() {}
     static constexpr bool needsToSerializeHeader() { return false; }
     constexpr void serialize(OutSlice *slice) const {}
+    static constexpr uint64_t serializedSize() { return 0; }
     constexpr void deserialize(InSlice *slice, unsigned wireType) {}
     constexpr bool hasData() const { return false; }
     constexpr void commit() {}
@@ -0,0 +1,138 @@
+/*
+
+MIT License
+
+Copyright (c) 2025 PCSX-Redux authors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <optional>
+
+#include "support/file.h"
+
+namespace PCSX {
+
+// Binary CPU traces, as recorded by the emulator's interpreter, and read back by tools/cpu-trace.
+//
+// A trace is a gzip stream. It starts with c_magic and c_version, followed by one record per executed instruction:
+//   uint8_t flags
+//   uint32_t pc, uint64_t cycle        if flags & NewPC, otherwise pc is the previous record's pc + 4
+//   uint32_t code
+//   uint8_t count, then count times
+//       uint8_t index, uint32_t value  if flags & Registers, with lo as index 32 and hi as index 33
+//   uint32_t address, uint8_t size     if flags & MemoryRead
+//   uint32_t address, uint8_t size,
+//       uint32_t value                 if flags & MemoryWrite
+// Everything is little endian. Register writes are the registers which changed while the instruction ran, which means
+// a load shows up in the record of the instruction following it, the same way the load delay works on the hardware.
+namespace CPUTrace {
+
+static constexpr char c_magic[8] = {'P', 'S', 'X', 'T', 'R', 'A', 'C', 'E'};
+static constexpr uint32_t c_version = 1;
+
+enum Flags : uint8_t {
+    NewPC = 1,
+    Registers = 2,
+    MemoryRead = 4,
+    MemoryWrite = 8,
+};
+
+struct Access {
+    uint32_t address = 0;
+    uint32_t value = 0;
+    uint8_t size = 0;
+};
+
+struct Record {
+    uint32_t pc = 0;
+    // Only stored along with a new pc, so this is the cycle of the latest jump, branch, or exception.
+    uint64_t cycle = 0;
+    uint32_t code = 0;
+    unsigned registerCount = 0;
+    struct {
+        uint8_t index;
+        uint32_t value;
+    } registers[34];
+    std::optional<Access> read;
+    std::optional<Access> write;
+};
+
+class Reader {
+  public:
+    // The file needs to be the decompressed stream, such as a ZReader.
+    Reader(IO<File> file) : m_file(file) {}
+    bool readHeader() {
+        char magic[sizeof(c_magic)];
+        if (m_file->read(magic, sizeof(magic)) != sizeof(magic)) return false;
+        for (unsigned i = 0; i < sizeof(c_magic); i++) {
+            if (magic[i] != c_magic[i]) return false;
+        }
+        return m_file->read<uint32_t>() == c_version;
+    }
+    // Returns false at the end of the trace. The record keeps the previous pc and cycle between calls.
+    bool next(Record& record) {
+        uint8_t flags;
+        if (m_file->read(&flags, 1) != 1) return false;
+        if (flags & NewPC) {
+            record.pc = m_file->read<uint32_t>();
+            record.cycle = m_file->read<uint64_t>();
+        } else {
+            record.pc += 4;
+        }
+        record.code = m_file->read<uint32_t>();
+        record.registerCount = 0;
+        if (flags & Registers) {
+            record.registerCount = m_file->read<uint8_t>();
+            if (record.registerCount > 34) return false;
+            for (unsigned i = 0; i < record.registerCount; i++) {
+                record.registers[i].index = m_file->read<uint8_t>();
+                record.registers[i].value = m_file->read<uint32_t>();
+            }
+        }
+        record.read.reset();
+        record.write.reset();
+        if (flags & MemoryRead) {
+            Access access;
+            access.address = m_file->read<uint32_t>();
+            access.size = m_file->read<uint8_t>();
+            record.read = access;
+        }
+        if (flags & MemoryWrite) {
+            Access access;
+            access.address = m_file->read<uint32_t>();
+            access.size = m_file->read<uint8_t>();
+            access.value = m_file->read<uint32_t>();
+            record.write = access;
+        }
+        return true;
+    }
+
+  private:
+    IO<File> m_file;
+};
+
+}  // namespace CPUTrace
+
+}  // namespace PCSX
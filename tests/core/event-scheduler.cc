@@ -0,0 +1,108 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "core/event-scheduler.h"
+
+#include <stdint.h>
+
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(EventScheduler, Empty) {
+    PCSX::EventScheduler<15> events;
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(events.nextTarget(), std::numeric_limits<uint64_t>::max());
+    EXPECT_FALSE(events.pending(3));
+    events.cancel(3);
+    EXPECT_TRUE(events.empty());
+}
+
+TEST(EventScheduler, Ordering) {
+    PCSX::EventScheduler<15> events;
+    const uint64_t targets[15] = {70, 20, 150, 10, 90, 40, 130, 60, 30, 110, 80, 140, 50, 120, 100};
+    for (unsigned i = 0; i < 15; i++) events.schedule(i, targets[i]);
+    EXPECT_EQ(events.nextTarget(), 10);
+
+    std::vector<unsigned> order;
+    while (!events.empty()) order.push_back(events.pop());
+    const std::vector<unsigned> expected = {3, 1, 8, 5, 12, 7, 0, 10, 4, 14, 9, 13, 6, 11, 2};
+    EXPECT_EQ(order, expected);
+}
+
+TEST(EventScheduler, Reschedule) {
+    PCSX::EventScheduler<15> events;
+    events.schedule(0, 100);
+    events.schedule(1, 200);
+    events.schedule(2, 300);
+
+    events.schedule(2, 50);
+    EXPECT_EQ(events.nextTarget(), 50);
+    events.schedule(2, 250);
+    EXPECT_EQ(events.nextTarget(), 100);
+    events.schedule(0, 400);
+    EXPECT_EQ(events.nextTarget(), 200);
+
+    EXPECT_EQ(events.pop(), 1);
+    EXPECT_EQ(events.pop(), 2);
+    EXPECT_EQ(events.pop(), 0);
+    EXPECT_TRUE(events.empty());
+}
+
+TEST(EventScheduler, Cancel) {
+    PCSX::EventScheduler<15> events;
+    for (unsigned i = 0; i < 8; i++) events.schedule(i, 1000 - i * 100);
+
+    events.cancel(7);
+    EXPECT_FALSE(events.pending(7));
+    EXPECT_EQ(events.nextTarget(), 400);
+    events.cancel(3);
+    events.cancel(0);
+    events.cancel(3);
+
+    std::vector<unsigned> order;
+    while (!events.empty()) order.push_back(events.pop());
+    const std::vector<unsigned> expected = {6, 5, 4, 2, 1};
+    EXPECT_EQ(order, expected);
+
+    events.schedule(3, 5);
+    EXPECT_TRUE(events.pending(3));
+    EXPECT_EQ(events.nextTarget(), 5);
+    events.clear();
+    EXPECT_TRUE(events.empty());
+    EXPECT_FALSE(events.pending(3));
+}
+
+TEST(EventScheduler, NextEventCycle) {
+    PCSX::EventScheduler<15> events;
+    EXPECT_EQ(events.nextEventCycle(500), 500);
+
+    // Interrupts are due once the cycle counter is past their target, root counters as soon as it gets there.
+    events.schedule(4, 300);
+    EXPECT_EQ(events.nextEventCycle(500), 301);
+    EXPECT_EQ(events.nextEventCycle(200), 200);
+    EXPECT_EQ(events.nextEventCycle(300), 300);
+    EXPECT_EQ(events.nextEventCycle(301), 301);
+
+    events.schedule(4, 600);
+    EXPECT_EQ(events.nextEventCycle(500), 500);
+    events.cancel(4);
+    EXPECT_EQ(events.nextEventCycle(500), 500);
+}
@@ -0,0 +1,175 @@
+--   Copyright (C) 2025 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+local lu = require 'luaunit'
+local guest = require 'tests.lua.guest'
+
+-- Same order as PCSX::Memory::PageKind
+local Direct, Watch = 0, 5
+
+local readPages = PCSX.getReadPages()
+local writePages = PCSX.getWritePages()
+
+-- The 2MB of RAM show up 4 times in the first 8MB.
+local function mirrors(address)
+    local ret = {}
+    for i = 0, 3 do ret[#ret + 1] = address + i * 0x200000 end
+    return ret
+end
+
+local function page(address) return math.floor(address / 0x10000) end
+
+-- Adds a breakpoint which doesn't pause, and counts how many times it went off.
+local function counted(address, bptype, width)
+    local counter = { hits = 0 }
+    counter.bp = PCSX.addBreakpoint(address, bptype, width, 'test', function()
+        counter.hits = counter.hits + 1
+        return true
+    end)
+    return counter
+end
+
+TestBreakpoints = {}
+
+function TestBreakpoints:test_writeInAllMirrors()
+    local counter = counted(0x80180000, 'Write', 4)
+    for i, address in ipairs(mirrors(0x80180000)) do
+        guest.call(guest.store32, address, i)
+        lu.assertEquals(counter.hits, i, string.format('write to %08x', address))
+        lu.assertEquals(writePages[page(address)], Watch)
+    end
+    lu.assertEquals(guest.call(guest.load32, 0x80180000), 4)
+    lu.assertEquals(counter.hits, 4)
+    counter.bp:remove()
+
+    -- The first access to find nothing left in the page gives it back to the fast path.
+    for _, address in ipairs(mirrors(0x80180000)) do
+        guest.call(guest.store32, address, 0)
+        lu.assertEquals(writePages[page(address)], Direct, string.format('write page of %08x', address))
+    end
+    lu.assertEquals(counter.hits, 4)
+end
+
+function TestBreakpoints:test_readInAllMirrors()
+    local counter = counted(0x80180010, 'Read', 4)
+    for i, address in ipairs(mirrors(0x80180010)) do
+        guest.call(guest.load32, address)
+        lu.assertEquals(counter.hits, i, string.format('read from %08x', address))
+        lu.assertEquals(readPages[page(address)], Watch)
+    end
+    guest.call(guest.store32, 0x80180010, 0)
+    lu.assertEquals(counter.hits, 4)
+    counter.bp:remove()
+
+    for _, address in ipairs(mirrors(0x80180010)) do
+        guest.call(guest.load32, address)
+        lu.assertEquals(readPages[page(address)], Direct, string.format('read page of %08x', address))
+    end
+    lu.assertEquals(counter.hits, 4)
+end
+
+function TestBreakpoints:test_pageStaysWatched()
+    local first = counted(0x80180020, 'Write', 4)
+    local second = counted(0x80180120, 'Write', 4)
+    first.bp:remove()
+    guest.call(guest.store32, 0x80180020, 0)
+    lu.assertEquals(writePages[0x8018], Watch)
+    guest.call(guest.store32, 0x80180120, 0)
+    lu.assertEquals(second.hits, 1)
+    second.bp:remove()
+    guest.call(guest.store32, 0x80180120, 0)
+    lu.assertEquals(writePages[0x8018], Direct)
+    lu.assertEquals(first.hits, 0)
+    lu.assertEquals(second.hits, 1)
+end
+
+function TestBreakpoints:test_execInCompiledBlock()
+    local fn = guest.assemble({
+        0x24020007, -- addiu $v0, $0, 7
+        0x24420001, -- addiu $v0, $v0, 1
+        0x03e00008, -- jr    $ra
+        0x00000000, -- nop
+    })
+    lu.assertEquals(guest.call(fn), 8)
+    local counter = counted(fn + 4, 'Exec', 4)
+    lu.assertEquals(guest.call(fn), 8)
+    lu.assertEquals(counter.hits, 1)
+    counter.bp:remove()
+    lu.assertEquals(guest.call(fn), 8)
+    lu.assertEquals(counter.hits, 1)
+end
+
+-- Runs the loop enough for the dynarec to turn it into a trace going through the jump target, then breaks there.
+function TestBreakpoints:test_execInHotLoop()
+    local fn = guest.assemble({
+        0x24020000, --       addiu $v0, $0, 0
+        0x2484ffff, -- loop: addiu $a0, $a0, -1
+        0x00000000, --       j     seg
+        0x00000000, --       nop
+        0x24420001, -- seg:  addiu $v0, $v0, 1
+        0x1480fffb, --       bnez  $a0, loop
+        0x00000000, --       nop
+        0x03e00008, --       jr    $ra
+        0x00000000, --       nop
+    })
+    local segment = fn + 16
+    -- The jump needs the address the function ended up at.
+    PCSX.getMemoryAsFile():writeU32At(bit.bor(0x08000000, bit.band(bit.rshift(segment, 2), 0x3ffffff)), fn + 8)
+    lu.assertEquals(guest.call(fn, 2000), 2000)
+
+    local counter = counted(segment, 'Exec', 4)
+    lu.assertEquals(guest.call(fn, 10), 10)
+    lu.assertEquals(counter.hits, 10)
+    counter.bp:remove()
+    lu.assertEquals(guest.call(fn, 10), 10)
+    lu.assertEquals(counter.hits, 10)
+end
+
+-- Removing a breakpoint rebuilds the filters from the ones left, which must keep going off.
+function TestBreakpoints:test_filterAfterRemoval()
+    local first = counted(0x80190000, 'Read', 4)
+    local second = counted(0x80190100, 'Read', 4)
+    first.bp:remove()
+    guest.call(guest.load32, 0x80190000)
+    guest.call(guest.load32, 0x80390100)
+    lu.assertEquals(first.hits, 0)
+    lu.assertEquals(second.hits, 1)
+    second.bp:remove()
+end
+
+function TestBreakpoints:test_filterSharedWord()
+    local low = counted(0x80190200, 'Read', 1)
+    local high = counted(0x80190202, 'Read', 1)
+    guest.call(guest.load8, 0x80190200)
+    guest.call(guest.load8, 0x80190202)
+    lu.assertEquals(low.hits, 1)
+    lu.assertEquals(high.hits, 1)
+
+    low.bp:remove()
+    guest.call(guest.load8, 0x80190200)
+    guest.call(guest.load8, 0x80590202)
+    lu.assertEquals(low.hits, 1)
+    lu.assertEquals(high.hits, 2)
+
+    -- Adding one back, in a word which kept its filter bit for the other breakpoint.
+    local again = counted(0x80190200, 'Read', 1)
+    guest.call(guest.load8, 0x80790200)
+    lu.assertEquals(again.hits, 1)
+    lu.assertEquals(high.hits, 2)
+    again.bp:remove()
+    high.bp:remove()
+end
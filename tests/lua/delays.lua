@@ -0,0 +1,77 @@
+--   Copyright (C) 2025 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+local lu = require 'luaunit'
+local guest = require 'tests.lua.guest'
+
+local c_data = 0x80190400
+
+TestDelays = {}
+
+function TestDelays:setUp()
+    PCSX.getMemoryAsFile():writeU32At(0x1234, c_data)
+end
+
+function TestDelays:test_loadDelaySlot()
+    local fn = guest.assemble({
+        0x34080001, -- ori   $t0, $0, 1
+        0x8c880000, -- lw    $t0, 0($a0)
+        0x01001025, -- or    $v0, $t0, $0
+        0x03e00008, -- jr    $ra
+        0x00000000, -- nop
+    })
+    lu.assertEquals(guest.call(fn, c_data), 1)
+end
+
+function TestDelays:test_loadAfterDelaySlot()
+    local fn = guest.assemble({
+        0x34080001, -- ori   $t0, $0, 1
+        0x8c880000, -- lw    $t0, 0($a0)
+        0x00000000, -- nop
+        0x01001025, -- or    $v0, $t0, $0
+        0x03e00008, -- jr    $ra
+        0x00000000, -- nop
+    })
+    lu.assertEquals(guest.call(fn, c_data), 0x1234)
+end
+
+function TestDelays:test_branchDelaySlot()
+    local fn = guest.assemble({
+        0x34020001, --       ori   $v0, $0, 1
+        0x10000002, --       b     done
+        0x24420001, --       addiu $v0, $v0, 1
+        0x2442000a, --       addiu $v0, $v0, 10
+        0x03e00008, -- done: jr    $ra
+        0x00000000, --       nop
+    })
+    lu.assertEquals(guest.call(fn), 2)
+end
+
+-- The coprocessor moves go through the same load delay. The dynarec doesn't delay them, so this only checks that the
+-- value is there past the delay slot, and that the ALU instructions after it see it.
+function TestDelays:test_coprocessorMove()
+    local fn = guest.assemble({
+        0x40086000, -- mfc0  $t0, $12
+        0x00000000, -- nop
+        0x01001025, -- or    $v0, $t0, $0
+        0x00421021, -- addu  $v0, $v0, $v0
+        0x03e00008, -- jr    $ra
+        0x00000000, -- nop
+    })
+    local status = PCSX.getRegisters().CP0.r[12]
+    lu.assertEquals(guest.call(fn), (status * 2) % 0x100000000)
+end
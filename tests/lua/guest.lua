@@ -0,0 +1,117 @@
+--   Copyright (C) 2025 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+-- Runs small pieces of MIPS code on the emulated CPU, for tests which need the memory accesses to go through the
+-- interpreter or the dynarec. A driver loop sitting in RAM asks for work through an exec slot, then spins until the
+-- scratchpad holds the address of a function to call, along with its arguments. The test waits in the meantime, so
+-- whatever it does happens in between two calls, like a debugger would. Everything goes to the uncached mirror of
+-- RAM, so that the instruction cache never gets in the way.
+
+local ffi = require 'ffi'
+
+local c_slot = 250
+local c_driver = 0xa0100000
+local c_firstFunction = 0xa0101000
+
+-- Scratchpad words: function to call, go flag, $a0, $a1, then the $v0 the function returned
+local scratch = ffi.cast('uint32_t*', PCSX.getScratchPtr())
+local memory = PCSX.getMemoryAsFile()
+
+local driver = {
+    0x3c081f80, -- loop: lui   $t0, 0x1f80
+    0x340900fa, --       ori   $t1, $0, c_slot
+    0xad000004, --       sw    $0, 4($t0)
+    0xa1092081, --       sb    $t1, 0x2081($t0)
+    0x8d0a0004, -- wait: lw    $t2, 4($t0)
+    0x00000000, --       nop
+    0x1140fffd, --       beqz  $t2, wait
+    0x00000000, --       nop
+    0x8d0a0000, --       lw    $t2, 0($t0)
+    0x8d040008, --       lw    $a0, 8($t0)
+    0x8d05000c, --       lw    $a1, 12($t0)
+    0x0140f809, --       jalr  $t2
+    0x00000000, --       nop
+    0x3c081f80, --       lui   $t0, 0x1f80
+    0xad020010, --       sw    $v0, 16($t0)
+    0x1000fff0, --       b     loop
+    0x00000000, --       nop
+}
+
+local function write(address, code)
+    for i, word in ipairs(code) do
+        memory:writeU32At(word, address + (i - 1) * 4)
+    end
+end
+
+local waiting = nil
+local started = false
+local cursor = c_firstFunction
+
+PCSX.execSlots[c_slot] = function()
+    local co = waiting
+    waiting = nil
+    if co then PCSX.nextTick(function() coroutine.resume(co) end) end
+end
+
+local function waitForDriver()
+    waiting = coroutine.running()
+    coroutine.yield()
+end
+
+local function start()
+    write(c_driver, driver)
+    PCSX.getRegisters().pc = c_driver
+    started = true
+    PCSX.resumeEmulator()
+    waitForDriver()
+end
+
+local M = {}
+
+-- Copies the code somewhere it can be called from, and returns its address.
+function M.assemble(code)
+    local address = cursor
+    write(address, code)
+    cursor = cursor + #code * 4
+    return address
+end
+
+-- Calls the function at "address" with $a0 and $a1 set, and returns its $v0.
+function M.call(address, a0, a1)
+    if not started then start() end
+    scratch[0] = address
+    scratch[2] = a0 or 0
+    scratch[3] = a1 or 0
+    scratch[1] = 1
+    waitForDriver()
+    return scratch[4]
+end
+
+-- Resets the emulated machine, then gets the driver going again. RAM survives the reset.
+function M.reset()
+    PCSX.softResetEmulator()
+    PCSX.getRegisters().pc = c_driver
+    waitForDriver()
+end
+
+-- Accessors working on the address in $a0, with $a1 as the value to store.
+M.load8 = M.assemble({ 0x90820000, 0x00000000, 0x03e00008, 0x00000000 })  -- lbu $v0, 0($a0)
+M.load32 = M.assemble({ 0x8c820000, 0x00000000, 0x03e00008, 0x00000000 }) -- lw  $v0, 0($a0)
+M.store8 = M.assemble({ 0xa0850000, 0x03e00008, 0x00000000 })             -- sb  $a1, 0($a0)
+M.store32 = M.assemble({ 0xac850000, 0x03e00008, 0x00000000 })            -- sw  $a1, 0($a0)
+
+return M
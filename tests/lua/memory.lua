@@ -0,0 +1,86 @@
+--   Copyright (C) 2025 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+-- Expects to run with -pio.
+
+local lu = require 'luaunit'
+local guest = require 'tests.lua.guest'
+
+-- Same order as PCSX::Memory::PageKind
+local Direct, Msan, Hardware, PIO = 0, 1, 2, 3
+
+local readPages = PCSX.getReadPages()
+local writePages = PCSX.getWritePages()
+
+local function assertKind(page, kind)
+    lu.assertEquals(readPages[page], kind, string.format('read page %04x', page))
+    lu.assertEquals(writePages[page], kind, string.format('write page %04x', page))
+end
+
+TestMemory = {}
+
+function TestMemory:test_hardware()
+    for _, page in ipairs({ 0x1f80, 0x9f80, 0xbf80 }) do assertKind(page, Hardware) end
+    -- I_MASK, through an address only known at runtime
+    guest.call(guest.store32, 0xbf801074, 0x5)
+    lu.assertEquals(guest.call(guest.load32, 0x1f801074), 0x5)
+    guest.call(guest.store32, 0x9f801074, 0)
+    lu.assertEquals(guest.call(guest.load32, 0xbf801074), 0)
+end
+
+function TestMemory:test_pio()
+    -- The first pages are mapped to the cart's ROM for reads, the rest of the region is handled by the cart.
+    lu.assertEquals(readPages[0x1f00], Direct)
+    lu.assertEquals(writePages[0x1f00], PIO)
+    for _, segment in ipairs({ 0x0000, 0x8000, 0xa000 }) do assertKind(segment + 0x1f10, PIO) end
+    lu.assertEquals(guest.call(guest.load8, 0x1f000000), guest.call(guest.load8, 0xbf000000))
+end
+
+function TestMemory:test_msan()
+    guest.call(guest.store8, 0x1f802089, 0) -- pcsx_initMsan
+    for _, page in ipairs({ 0x2000, 0x3f10, 0x7fff }) do assertKind(page, Msan) end
+    assertKind(0x1f10, PIO)
+
+    local pointer = guest.call(guest.assemble({
+        0x3c081f80, -- lui   $t0, 0x1f80
+        0x8d02208c, -- lw    $v0, 0x208c($t0)
+        0x03e00008, -- jr    $ra
+        0x00000000, -- nop
+    }), 16) -- pcsx_msanAlloc
+    lu.assertTrue(pointer >= 0x20000000 and pointer < 0x80000000)
+    guest.call(guest.store32, pointer, 0x12345678)
+    lu.assertEquals(guest.call(guest.load32, pointer), 0x12345678)
+    guest.call(guest.store32, 0x1f80208c, pointer) -- pcsx_msanFree
+
+    -- Resetting frees MSAN, which has to hand its pages back to whatever they were before.
+    guest.reset()
+    assertKind(0x2000, Direct)
+    assertKind(0x7fff, Direct)
+    assertKind(0x3f10, PIO)
+    assertKind(0x1f10, PIO)
+end
+
+-- Code the CPU already ran, rewritten without going through it.
+function TestMemory:test_rewriteCode()
+    local fn = guest.assemble({
+        0x03e00008, -- jr    $ra
+        0x24020001, -- addiu $v0, $0, 1
+    })
+    lu.assertEquals(guest.call(fn), 1)
+    PCSX.getMemoryAsFile():writeU32At(0x24020002, fn + 4) -- addiu $v0, $0, 2
+    lu.assertEquals(guest.call(fn), 2)
+end
@@ -0,0 +1,150 @@
+--   Copyright (C) 2025 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+local lu = require 'luaunit'
+local guest = require 'tests.lua.guest'
+
+local c_period = 1000
+
+-- Spins $a0 times, a few cycles a turn.
+local loop = guest.assemble({
+    0x2484ffff, -- loop: addiu $a0, $a0, -1
+    0x1480fffe, --       bnez  $a0, loop
+    0x00000000, --       nop
+    0x03e00008, --       jr    $ra
+    0x00000000, --       nop
+})
+local loopEnd = loop + 20
+
+local function profile(turns)
+    PCSX.Profiler.reset()
+    PCSX.Profiler.start(c_period)
+    guest.call(loop, turns)
+    PCSX.Profiler.stop()
+    return PCSX.Profiler.getSampleCount()
+end
+
+-- Just enough of protobuf's wire format to read the pprof output back.
+local function varint(bytes, pos)
+    local value, scale = 0, 1
+    repeat
+        local byte = bytes:byte(pos)
+        pos = pos + 1
+        value = value + (byte % 0x80) * scale
+        scale = scale * 0x80
+    until byte < 0x80
+    return value, pos
+end
+
+-- Packed repeated fields are a plain run of varints.
+local function varints(bytes)
+    local ret, pos = {}, 1
+    while pos <= #bytes do
+        ret[#ret + 1], pos = varint(bytes, pos)
+    end
+    return ret
+end
+
+-- Returns the values of a field of a message, in order: numbers for varints, strings for anything length delimited.
+local function fields(message, field)
+    local ret, pos = {}, 1
+    while pos <= #message do
+        local tag, value, size
+        tag, pos = varint(message, pos)
+        if tag % 8 == 0 then
+            value, pos = varint(message, pos)
+        elseif tag % 8 == 2 then
+            size, pos = varint(message, pos)
+            value = message:sub(pos, pos + size - 1)
+            pos = pos + size
+        else
+            error('unexpected wire type ' .. tag % 8)
+        end
+        if math.floor(tag / 8) == field then ret[#ret + 1] = value end
+    end
+    return ret
+end
+
+TestProfiler = {}
+
+function TestProfiler:test_folded()
+    local count = profile(1000000)
+    lu.assertTrue(count > 0)
+
+    -- Without symbols or call stacks, every line is a lone address followed by its sample count.
+    local total, inLoop = 0, 0
+    for line in tostring(PCSX.Profiler.getProfile('folded')):gmatch('[^\n]+') do
+        local frame, samples = line:match('^(%x%x%x%x%x%x%x%x) (%d+)$')
+        lu.assertNotNil(frame, line)
+        local address = tonumber(frame, 16)
+        total = total + tonumber(samples)
+        if address >= loop and address < loopEnd then inLoop = inLoop + tonumber(samples) end
+    end
+    lu.assertEquals(total, count)
+    lu.assertTrue(inLoop * 2 > count)
+end
+
+function TestProfiler:test_pprof()
+    local count = profile(1000000)
+    local message = tostring(PCSX.Profiler.getProfile('pprof'))
+    local strings = fields(message, 6)
+    lu.assertEquals(strings[1], '')
+    local function str(index) return strings[index + 1] end
+
+    local sampleTypes = fields(message, 1)
+    lu.assertEquals(#sampleTypes, 2)
+    lu.assertEquals(str(fields(sampleTypes[1], 1)[1]), 'samples')
+    lu.assertEquals(str(fields(sampleTypes[2], 1)[1]), 'cycles')
+    lu.assertEquals(fields(message, 12)[1], c_period)
+
+    local locations = {}
+    for _, location in ipairs(fields(message, 4)) do
+        locations[fields(location, 1)[1]] = fields(location, 3)[1]
+    end
+
+    -- Every sample points at locations which exist, and carries its count and the cycles it stands for.
+    local total, inLoop = 0, 0
+    for _, sample in ipairs(fields(message, 2)) do
+        local ids = varints(fields(sample, 1)[1])
+        local values = varints(fields(sample, 2)[1])
+        lu.assertEquals(#ids, 1)
+        local address = locations[ids[1]]
+        lu.assertNotNil(address)
+        lu.assertEquals(values[2], values[1] * c_period)
+        total = total + values[1]
+        if address >= loop and address < loopEnd then inLoop = inLoop + values[1] end
+    end
+    lu.assertEquals(total, count)
+    lu.assertTrue(inLoop * 2 > count)
+end
+
+-- Loading a state far ahead in time doesn't make the first sample after it stand for all of the cycles in between.
+function TestProfiler:test_stateLoad()
+    PCSX.Profiler.reset()
+    local before = PCSX.createSaveState()
+    local start = tonumber(PCSX.getCPUCycles())
+    guest.call(loop, 5000000)
+    local after = PCSX.createSaveState()
+    local jump = tonumber(PCSX.getCPUCycles()) - start
+
+    PCSX.loadSaveState(before)
+    PCSX.Profiler.start(c_period)
+    PCSX.loadSaveState(after)
+    guest.call(loop, 1)
+    PCSX.Profiler.stop()
+    lu.assertTrue(PCSX.Profiler.getSampleCount() * c_period < jump / 2)
+end
@@ -0,0 +1,177 @@
+--   Copyright (C) 2025 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+-- Expects to run with -rewind-memory 1.
+
+local lu = require 'luaunit'
+local ffi = require 'ffi'
+
+local first = 0x80100000
+-- In another page than the first one, so that deltas have to carry both.
+local second = 0x80180000
+local keyframeInterval = 30
+
+-- A megabyte of noise won't deflate much, so any snapshot carrying it gets large.
+local noiseSize = 0x100000
+local function noise()
+    local ret = ffi.new('uint32_t[?]', noiseSize / 4)
+    local x = 0x12345678
+    for i = 0, noiseSize / 4 - 1 do
+        x = bit.bxor(x, bit.lshift(x, 13))
+        x = bit.bxor(x, bit.rshift(x, 17))
+        x = bit.bxor(x, bit.lshift(x, 5))
+        ret[i] = x
+    end
+    return ret
+end
+
+TestRewind = {}
+
+function TestRewind:setUp()
+    PCSX.Rewind.clear()
+    self.mem = PCSX.getMemoryAsFile()
+    self.mem:writeU32At(0, first)
+    self.mem:writeU32At(0, second)
+end
+
+function TestRewind:tearDown() PCSX.Rewind.clear() end
+
+function TestRewind:test_capture()
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 0)
+    lu.assertEquals(PCSX.Rewind.getMemoryUsage(), 0)
+    PCSX.Rewind.capture()
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 1)
+    lu.assertTrue(PCSX.Rewind.getMemoryUsage() > 0)
+    PCSX.Rewind.capture()
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 2)
+    PCSX.Rewind.clear()
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 0)
+    lu.assertEquals(PCSX.Rewind.getMemoryUsage(), 0)
+end
+
+function TestRewind:test_keyframeAndDeltas()
+    self.mem:writeU32At(1, first)
+    PCSX.Rewind.capture()
+    self.mem:writeU32At(2, first)
+    PCSX.Rewind.capture()
+    self.mem:writeU32At(3, first)
+    self.mem:writeU32At(7, second)
+    PCSX.Rewind.capture()
+    self.mem:writeU32At(4, first)
+    self.mem:writeU32At(8, second)
+
+    -- The deltas only make sense applied on top of their keyframe.
+    lu.assertTrue(PCSX.Rewind.rewind())
+    lu.assertEquals(self.mem:readU32At(first), 3)
+    lu.assertEquals(self.mem:readU32At(second), 7)
+    lu.assertTrue(PCSX.Rewind.rewind())
+    lu.assertEquals(self.mem:readU32At(first), 2)
+    lu.assertEquals(self.mem:readU32At(second), 0)
+    lu.assertTrue(PCSX.Rewind.rewind())
+    lu.assertEquals(self.mem:readU32At(first), 1)
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 0)
+    lu.assertFalse(PCSX.Rewind.rewind())
+end
+
+function TestRewind:test_rewindSteps()
+    for i = 1, 5 do
+        self.mem:writeU32At(i, first)
+        PCSX.Rewind.capture()
+    end
+    lu.assertFalse(PCSX.Rewind.rewind(0))
+    lu.assertFalse(PCSX.Rewind.rewind(6))
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 5)
+    lu.assertTrue(PCSX.Rewind.rewind(3))
+    lu.assertEquals(self.mem:readU32At(first), 3)
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 2)
+end
+
+function TestRewind:test_dropsNewer()
+    for i = 1, 5 do
+        self.mem:writeU32At(i, first)
+        PCSX.Rewind.capture()
+    end
+    lu.assertTrue(PCSX.Rewind.rewind(2))
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 3)
+
+    -- Whatever got captured after the state rewound to is gone for good, new snapshots go in its place.
+    self.mem:writeU32At(9, first)
+    PCSX.Rewind.capture()
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 4)
+    lu.assertTrue(PCSX.Rewind.rewind())
+    lu.assertEquals(self.mem:readU32At(first), 9)
+    lu.assertTrue(PCSX.Rewind.rewind())
+    lu.assertEquals(self.mem:readU32At(first), 3)
+end
+
+function TestRewind:test_trimWholeGroups()
+    -- Every keyframe goes over the budget on its own.
+    local data = noise()
+    self.mem:writeAt(data, noiseSize, first)
+
+    -- The newest group is kept, even if it doesn't fit. Groups are a keyframe followed by keyframeInterval deltas.
+    for i = 0, keyframeInterval do
+        self.mem:writeU32At(i, second)
+        PCSX.Rewind.capture()
+    end
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), keyframeInterval + 1)
+    local groupUsage = PCSX.Rewind.getMemoryUsage()
+    lu.assertTrue(groupUsage > 1024 * 1024)
+
+    -- Starting a second group drops the first one whole, deltas included.
+    self.mem:writeU32At(100, second)
+    PCSX.Rewind.capture()
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 1)
+    lu.assertTrue(PCSX.Rewind.getMemoryUsage() < groupUsage)
+    self.mem:writeU32At(101, second)
+    PCSX.Rewind.capture()
+    lu.assertEquals(PCSX.Rewind.getSnapshotCount(), 2)
+    lu.assertTrue(PCSX.Rewind.rewind(2))
+    lu.assertEquals(self.mem:readU32At(second), 100)
+    lu.assertEquals(self.mem:readU32At(first), data[0])
+
+    ffi.fill(data, noiseSize)
+    self.mem:writeAt(data, noiseSize, first)
+end
+
+-- Handing out a raw pointer to RAM makes every delta carry all of it, until the next state load. Reading through a
+-- read-only one doesn't.
+function TestRewind:test_rawPointer()
+    self.mem:writeAt(noise(), noiseSize, first)
+    PCSX.Rewind.capture()
+    local usage = PCSX.Rewind.getMemoryUsage()
+    lu.assertEquals(PCSX.getReadOnlyMemPtr()[first - 0x80000000], self.mem:readU8At(first))
+    self.mem:writeU32At(1, second)
+    PCSX.Rewind.capture()
+    lu.assertTrue(PCSX.Rewind.getMemoryUsage() - usage < 0x10000)
+
+    usage = PCSX.Rewind.getMemoryUsage()
+    PCSX.getMemPtr()
+    self.mem:writeU32At(2, second)
+    PCSX.Rewind.capture()
+    lu.assertTrue(PCSX.Rewind.getMemoryUsage() - usage > noiseSize / 2)
+
+    -- Loading a state makes the next snapshot a keyframe, and the ones after it small again.
+    lu.assertTrue(PCSX.Rewind.rewind())
+    PCSX.Rewind.capture()
+    usage = PCSX.Rewind.getMemoryUsage()
+    self.mem:writeU32At(3, second)
+    PCSX.Rewind.capture()
+    lu.assertTrue(PCSX.Rewind.getMemoryUsage() - usage < 0x10000)
+
+    self.mem:writeAt(ffi.new('uint8_t[?]', noiseSize), noiseSize, first)
+end
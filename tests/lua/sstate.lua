@@ -0,0 +1,60 @@
+--   Copyright (C) 2025 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+local lu = require 'luaunit'
+
+local c_filename = 'sstate-test.sstate'
+local c_marker = 0x80180000
+
+TestSaveStates = {}
+
+function TestSaveStates:test_writeThenLoad()
+    local memory = PCSX.getMemoryAsFile()
+    local written = {}
+    local waiting = nil
+    local listener = PCSX.Events.createEventListener('ExecutionFlow::SaveStateWritten', function(event)
+        written[#written + 1] = { filename = event.filename, success = event.success }
+        local co = waiting
+        waiting = nil
+        if co then PCSX.nextTick(function() coroutine.resume(co) end) end
+    end)
+
+    -- Two saves in a row to the same slot; the second one has to be what ends up in the file.
+    memory:writeU32At(1, c_marker)
+    PCSX.writeSaveState(c_filename)
+    memory:writeU32At(2, c_marker)
+    PCSX.writeSaveState(c_filename)
+    while #written < 2 do
+        waiting = coroutine.running()
+        coroutine.yield()
+    end
+    listener:remove()
+
+    for _, event in ipairs(written) do
+        lu.assertEquals(event.filename, c_filename)
+        lu.assertTrue(event.success)
+    end
+    lu.assertNil(io.open(c_filename .. '.tmp', 'rb'))
+
+    memory:writeU32At(0, c_marker)
+    local file = Support.File.open(c_filename, 'READ')
+    lu.assertFalse(file:failed())
+    PCSX.loadSaveState(Support.File.zReader(file))
+    file:close()
+    os.remove(c_filename)
+    lu.assertEquals(memory:readU32At(c_marker), 2)
+end
@@ -0,0 +1,85 @@
+--   Copyright (C) 2025 PCSX-Redux authors
+--
+--   This program is free software; you can redistribute it and/or modify
+--   it under the terms of the GNU General Public License as published by
+--   the Free Software Foundation; either version 2 of the License, or
+--   (at your option) any later version.
+--
+--   This program is distributed in the hope that it will be useful,
+--   but WITHOUT ANY WARRANTY; without even the implied warranty of
+--   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+--   GNU General Public License for more details.
+--
+--   You should have received a copy of the GNU General Public License
+--   along with this program; if not, write to the
+--   Free Software Foundation, Inc.,
+--   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+local lu = require 'luaunit'
+local guest = require 'tests.lua.guest'
+
+local c_dump = 'turbo-test.raw'
+local c_turns = 2000000
+-- The SPU hands its output over in chunks of 810 frames, and turbo only starts and stops on a scanline, so the
+-- dump may be a bit off at both ends of each session.
+local c_slack = 2048
+
+-- Spins $a0 times, a few cycles a turn.
+local loop = guest.assemble({
+    0x2484ffff, -- loop: addiu $a0, $a0, -1
+    0x1480fffe, --       bnez  $a0, loop
+    0x00000000, --       nop
+    0x03e00008, --       jr    $ra
+    0x00000000, --       nop
+})
+
+-- Runs the loop in turbo mode, and returns how many cycles, and how many wall clock seconds, it took.
+local function turbo(turns)
+    PCSX.settings.emulator.Turbo = true
+    local cycles = tonumber(PCSX.getCPUCycles())
+    local clock = luv.hrtime()
+    guest.call(loop, turns)
+    local seconds = (luv.hrtime() - clock) / 1e9
+    cycles = tonumber(PCSX.getCPUCycles()) - cycles
+    PCSX.settings.emulator.Turbo = false
+    -- Enough to get to the next scanline, which is when leaving turbo lets go of the dump.
+    guest.call(loop, 1000)
+    return cycles, seconds
+end
+
+local function dumpedFrames()
+    local file = Support.File.open(c_dump, 'READ')
+    local size = file:size()
+    file:close()
+    return size / 4
+end
+
+TestTurbo = {}
+
+function TestTurbo:setUp()
+    os.remove(c_dump)
+    self.scaler = PCSX.settings.emulator.Scaler
+    -- Down to 1% of real time, the audio pacing would hold the emulation back for all to see.
+    PCSX.settings.emulator.Scaler = 1
+    PCSX.settings.emulator.TurboSpeed = 0
+    PCSX.settings.emulator.TurboAudioDump = c_dump
+end
+
+function TestTurbo:tearDown()
+    PCSX.settings.emulator.Turbo = false
+    PCSX.settings.emulator.TurboAudioDump = ''
+    PCSX.settings.emulator.Scaler = self.scaler
+    os.remove(c_dump)
+end
+
+function TestTurbo:test_audioDump()
+    local expected = 0
+    for session = 1, 2 do
+        local cycles, seconds = turbo(c_turns)
+        local emulated = cycles / PCSX.CONSTS.CPU.CLOCKSPEED
+        lu.assertTrue(seconds < emulated * 10, string.format('%fs to run %fs in session %d', seconds, emulated, session))
+        -- Going back into turbo adds to the dump instead of starting it over.
+        expected = expected + emulated * 44100
+        lu.assertAlmostEquals(dumpedFrames(), expected, c_slack * session)
+    end
+end
@@ -0,0 +1,159 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "main/main.h"
+
+// These aren't really tests, but rather a way to get numbers out of the CPU cores on a known workload.
+// The statistics are printed when the emulator quits, and the wall time is printed at the end.
+
+static const char statsPrinter[] = R"(
+BenchStart = luv.hrtime()
+BenchListener = PCSX.Events.createEventListener('Quitting', function()
+    local seconds = (luv.hrtime() - BenchStart) / 1e9
+    local cycles = tonumber(PCSX.getCPUCycles())
+    local frames = PCSX.getEmulatedFrames()
+    print(string.format('Emulated cycles: %d', cycles))
+    print(string.format('Emulated frames: %d (%.2f per second)', frames, frames / seconds))
+    for name, value in pairs(PCSX.getCPUStatistics()) do
+        print(string.format('%s: %d (%.3f per 1000 cycles)', name, value, value * 1000 / cycles))
+        if name == 'instructions' then
+            print(string.format('Instructions per second: %.0f', value / seconds))
+        end
+    end
+end)
+)";
+
+template <typename... Args>
+static int runBench(const char* name, Args... args) {
+    MainInvoker invoker("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-exec",
+                        statsPrinter, args...);
+    auto start = std::chrono::steady_clock::now();
+    int ret = invoker.invoke();
+    auto end = std::chrono::steady_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    fprintf(stderr, "Benchmark %s took %lldms\n", name, static_cast<long long>(ms));
+    return ret;
+}
+
+TEST(Bench, DynarecLinking) {
+    int ret = runBench("DynarecLinking", "-dynarec", "-dynarec-linking", "-loadexe", "src/mips/tests/cpu/cpu.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, DynarecNoLinking) {
+    int ret =
+        runBench("DynarecNoLinking", "-dynarec", "-no-dynarec-linking", "-loadexe", "src/mips/tests/cpu/cpu.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, DynarecSuperblocks) {
+    int ret = runBench("DynarecSuperblocks", "-dynarec", "-dynarec-superblocks", "-loadexe",
+                       "src/mips/tests/cpu/cpu.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, DynarecNoSuperblocks) {
+    int ret = runBench("DynarecNoSuperblocks", "-dynarec", "-no-dynarec-superblocks", "-loadexe",
+                       "src/mips/tests/cpu/cpu.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, DynarecLoopsSuperblocks) {
+    int ret = runBench("DynarecLoopsSuperblocks", "-dynarec", "-dynarec-superblocks", "-loadexe",
+                       "src/mips/tests/loops/loops.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, DynarecLoopsNoSuperblocks) {
+    int ret = runBench("DynarecLoopsNoSuperblocks", "-dynarec", "-no-dynarec-superblocks", "-loadexe",
+                       "src/mips/tests/loops/loops.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+// The first run fills the translation cache, the second one should mostly get hits out of it
+TEST(Bench, DynarecTranslationCache) {
+    const std::string path = (std::filesystem::temp_directory_path() / "pcsx-bench-dynarec.cache").string();
+    std::filesystem::remove(path);
+    int ret = runBench("DynarecTranslationCacheCold", "-dynarec", "-dynarec-cache", "-dynarec-cache-path", path.c_str(),
+                       "-loadexe", "src/mips/tests/cpu/cpu.ps-exe");
+    EXPECT_EQ(ret, 0);
+    ret = runBench("DynarecTranslationCacheWarm", "-dynarec", "-dynarec-cache", "-dynarec-cache-path", path.c_str(),
+                   "-loadexe", "src/mips/tests/cpu/cpu.ps-exe");
+    EXPECT_EQ(ret, 0);
+    std::filesystem::remove(path);
+}
+
+TEST(Bench, InterpreterStores) {
+    int ret = runBench("InterpreterStores", "-interpreter", "-loadexe", "src/mips/tests/smc/smc.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, DynarecStores) {
+    int ret = runBench("DynarecStores", "-dynarec", "-loadexe", "src/mips/tests/smc/smc.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, InterpreterIdleSkip) {
+    int ret = runBench("InterpreterIdleSkip", "-interpreter", "-idle-skip", "-loadexe",
+                       "src/mips/tests/idle/idle.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, InterpreterNoIdleSkip) {
+    int ret = runBench("InterpreterNoIdleSkip", "-interpreter", "-no-idle-skip", "-loadexe",
+                       "src/mips/tests/idle/idle.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, DynarecIdleSkip) {
+    int ret = runBench("DynarecIdleSkip", "-dynarec", "-idle-skip", "-loadexe", "src/mips/tests/idle/idle.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, DynarecNoIdleSkip) {
+    int ret = runBench("DynarecNoIdleSkip", "-dynarec", "-no-idle-skip", "-loadexe", "src/mips/tests/idle/idle.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, InterpreterPlainDispatch) {
+    int ret = runBench("InterpreterPlainDispatch", "-interpreter", "-no-threaded-interpreter", "-loadexe",
+                       "src/mips/tests/cpu/cpu.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, InterpreterThreadedDispatch) {
+    int ret = runBench("InterpreterThreadedDispatch", "-interpreter", "-threaded-interpreter", "-loadexe",
+                       "src/mips/tests/cpu/cpu.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, DynarecAudioPacing) {
+    int ret = runBench("DynarecAudioPacing", "-dynarec", "-no-turbo", "-loadexe", "src/mips/tests/idle/idle.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
+
+TEST(Bench, DynarecTurbo) {
+    int ret = runBench("DynarecTurbo", "-dynarec", "-turbo", "-loadexe", "src/mips/tests/idle/idle.ps-exe");
+    EXPECT_EQ(ret, 0);
+}
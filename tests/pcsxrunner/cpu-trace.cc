@@ -0,0 +1,119 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <filesystem>
+#include <memory>
+
+#include "core/cpu-trace-recorder.h"
+#include "core/r3000a.h"
+#include "gtest/gtest.h"
+#include "support/zfile.h"
+#include "supportpsx/cpu-trace.h"
+
+namespace {
+
+// Feeds one instruction to the recorder, the way the interpreter's trace path does: the registers are updated by the
+// "handler" in between begin and end.
+template <typename Handler>
+void run(PCSX::CPUTraceRecorder& recorder, PCSX::psxRegisters& regs, uint32_t pc, uint32_t code, Handler handler) {
+    recorder.begin(regs, pc, code);
+    handler();
+    recorder.end(regs);
+}
+
+}  // namespace
+
+TEST(CPUTrace, RoundTrip) {
+    const auto path = std::filesystem::temp_directory_path() / "pcsx-cpu-trace-test.trace";
+    auto regs = std::make_unique<PCSX::psxRegisters>();
+    auto& gpr = regs->GPR.n;
+    regs->cycle = 100;
+
+    PCSX::CPUTraceRecorder recorder;
+    ASSERT_TRUE(recorder.start(path));
+    run(recorder, *regs, 0x80010000, 0x24020040, [&] { gpr.v0 = 0x40; });  // addiu $v0, $0, 0x40
+    run(recorder, *regs, 0x80010004, 0x8c480010, [] {});                    // lw    $t0, 0x10($v0)
+    run(recorder, *regs, 0x80010008, 0xa0420003, [&] { gpr.t0 = 0x1234; });  // sb    $v0, 3($v0)
+    run(recorder, *regs, 0x8001000c, 0x10000004, [] {});                    // b     0x80010020
+    run(recorder, *regs, 0x80010010, 0x00000000, [&] { regs->cycle = 110; });  // nop
+    run(recorder, *regs, 0x80010020, 0x00480821, [&] { gpr.at = 0x1274; });  // addu  $at, $v0, $t0
+    EXPECT_EQ(recorder.recordCount(), 6);
+    recorder.stop();
+
+    PCSX::IO<PCSX::File> file(new PCSX::ZReader(new PCSX::PosixFile(path)));
+    PCSX::CPUTrace::Reader reader(file);
+    ASSERT_TRUE(reader.readHeader());
+    PCSX::CPUTrace::Record record;
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.pc, 0x80010000);
+    EXPECT_EQ(record.cycle, 100);
+    EXPECT_EQ(record.code, 0x24020040);
+    ASSERT_EQ(record.registerCount, 1);
+    EXPECT_EQ(record.registers[0].index, 2);
+    EXPECT_EQ(record.registers[0].value, 0x40);
+    EXPECT_FALSE(record.read.has_value());
+    EXPECT_FALSE(record.write.has_value());
+
+    // The load's value only shows up in the next record, like on the hardware.
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.pc, 0x80010004);
+    EXPECT_EQ(record.cycle, 100);
+    EXPECT_EQ(record.code, 0x8c480010);
+    EXPECT_EQ(record.registerCount, 0);
+    ASSERT_TRUE(record.read.has_value());
+    EXPECT_EQ(record.read->address, 0x50);
+    EXPECT_EQ(record.read->size, 4);
+    EXPECT_FALSE(record.write.has_value());
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.pc, 0x80010008);
+    EXPECT_EQ(record.code, 0xa0420003);
+    ASSERT_EQ(record.registerCount, 1);
+    EXPECT_EQ(record.registers[0].index, 8);
+    EXPECT_EQ(record.registers[0].value, 0x1234);
+    EXPECT_FALSE(record.read.has_value());
+    ASSERT_TRUE(record.write.has_value());
+    EXPECT_EQ(record.write->address, 0x43);
+    EXPECT_EQ(record.write->size, 1);
+    EXPECT_EQ(record.write->value, 0x40);
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.pc, 0x8001000c);
+    EXPECT_EQ(record.code, 0x10000004);
+    EXPECT_EQ(record.registerCount, 0);
+
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.pc, 0x80010010);
+    EXPECT_EQ(record.code, 0);
+    EXPECT_EQ(record.cycle, 100);
+
+    // The branch target carries its own pc, along with the cycle it got there at.
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.pc, 0x80010020);
+    EXPECT_EQ(record.cycle, 110);
+    EXPECT_EQ(record.code, 0x00480821);
+    ASSERT_EQ(record.registerCount, 1);
+    EXPECT_EQ(record.registers[0].index, 1);
+    EXPECT_EQ(record.registers[0].value, 0x1274);
+
+    EXPECT_FALSE(reader.next(record));
+    file->close();
+    std::filesystem::remove(path);
+}
@@ -27,6 +27,13 @@ TEST(CPU, Interpreter) {
     EXPECT_EQ(ret, 0);
 }
 
+TEST(CPU, ThreadedInterpreter) {
+    MainInvoker invoker("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-interpreter",
+                        "-threaded-interpreter", "-luacov", "-loadexe", "src/mips/tests/cpu/cpu.ps-exe");
+    int ret = invoker.invoke();
+    EXPECT_EQ(ret, 0);
+}
+
 TEST(CPU, Dynarec) {
     MainInvoker invoker("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-dynarec",
                         "-luacov", "-loadexe", "src/mips/tests/cpu/cpu.ps-exe");
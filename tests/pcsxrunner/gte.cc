@@ -0,0 +1,50 @@
+/***************************************************************************
+ *   Copyright (C) 2021 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "main/main.h"
+
+static std::string runGTETest(const char* cpu) {
+    MainInvoker invoker("-no-ui", "-run", "-pcdrv", "-pcdrvbase", ".", "-bios", "src/mips/openbios/openbios.bin",
+                        "-testmode", cpu, "-loadexe", "src/mips/tests/gte/gte.ps-exe");
+    int ret = invoker.invoke();
+    EXPECT_EQ(ret, 0);
+    std::ifstream file("gte-results.bin", std::ios::binary);
+    std::string results((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove("gte-results.bin");
+    return results;
+}
+
+// The dynarec has native implementations of the most common GTE operations, which have to match the
+// interpreter's bit for bit, including FLAG, over the random inputs of the gte test program.
+TEST(GTE, DynarecMatchesInterpreter) {
+    std::string interpreter = runGTETest("-interpreter");
+    std::string dynarec = runGTETest("-dynarec");
+    ASSERT_FALSE(interpreter.empty());
+    ASSERT_EQ(interpreter.size(), dynarec.size());
+    for (size_t i = 0; i < interpreter.size(); i += 4 * 64) {
+        EXPECT_EQ(interpreter.substr(i, 4 * 64), dynarec.substr(i, 4 * 64)) << "Mismatch in GTE test #" << i / (4 * 64);
+    }
+}
@@ -55,6 +55,14 @@ static int runLuaIntTest(const char* name) {
     return runLuaInt("-exec", req.c_str());
 }
 
+// The threaded interpreter only runs when the debugger is off, so suites which need it can't use this.
+static int runLuaThreadedTest(const char* name) {
+    std::string req = "require '";
+    req += name;
+    req += "'";
+    return runLuaInt("-threaded-interpreter", "-exec", req.c_str());
+}
+
 static int runLuaDynTest(const char* name) {
     std::string req = "require '";
     req += name;
@@ -64,7 +72,34 @@ static int runLuaDynTest(const char* name) {
 
 TEST(LuaBasic, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.basic"), 0); }
 TEST(LuaBasic, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.basic"), 0); }
+TEST(LuaBasic, ThreadedInterpreter) { EXPECT_EQ(runLuaThreadedTest("tests.lua.basic"), 0); }
 TEST(LuaFile, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.file"), 0); }
 TEST(LuaFile, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.file"), 0); }
 TEST(LuaAdpcm, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.adpcm"), 0); }
 TEST(LuaAdpcm, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.adpcm"), 0); }
+TEST(LuaRewind, Interpreter) {
+    EXPECT_EQ(runLuaInt("-rewind-memory", "1", "-exec", "require 'tests.lua.rewind'"), 0);
+}
+TEST(LuaMemory, Interpreter) { EXPECT_EQ(runLuaInt("-pio", "-exec", "require 'tests.lua.memory'"), 0); }
+TEST(LuaMemory, Dynarec) { EXPECT_EQ(runLuaDyn("-pio", "-exec", "require 'tests.lua.memory'"), 0); }
+TEST(LuaMemory, ThreadedInterpreter) {
+    EXPECT_EQ(runLuaInt("-threaded-interpreter", "-pio", "-exec", "require 'tests.lua.memory'"), 0);
+}
+TEST(LuaBreakpoints, Interpreter) {
+    EXPECT_EQ(runLuaInt("-debugger", "-exec", "require 'tests.lua.breakpoints'"), 0);
+}
+TEST(LuaBreakpoints, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.breakpoints"), 0); }
+TEST(LuaBreakpoints, DynarecSuperblocks) {
+    EXPECT_EQ(runLuaDyn("-dynarec-superblocks", "-exec", "require 'tests.lua.breakpoints'"), 0);
+}
+TEST(LuaDelays, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.delays"), 0); }
+TEST(LuaDelays, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.delays"), 0); }
+TEST(LuaDelays, ThreadedInterpreter) { EXPECT_EQ(runLuaThreadedTest("tests.lua.delays"), 0); }
+TEST(LuaSaveStates, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.sstate"), 0); }
+TEST(LuaSaveStates, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.sstate"), 0); }
+TEST(LuaSaveStates, ThreadedInterpreter) { EXPECT_EQ(runLuaThreadedTest("tests.lua.sstate"), 0); }
+TEST(LuaProfiler, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.profiler"), 0); }
+TEST(LuaProfiler, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.profiler"), 0); }
+TEST(LuaProfiler, ThreadedInterpreter) { EXPECT_EQ(runLuaThreadedTest("tests.lua.profiler"), 0); }
+TEST(LuaTurbo, Interpreter) { EXPECT_EQ(runLuaIntTest("tests.lua.turbo"), 0); }
+TEST(LuaTurbo, Dynarec) { EXPECT_EQ(runLuaDynTest("tests.lua.turbo"), 0); }
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#if defined(__linux__) && (defined(__x86_64) || defined(_M_AMD64))
+
+#include <elf.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include "main/main.h"
+
+namespace {
+
+template <typename T>
+T readAt(const std::vector<uint8_t>& dump, size_t offset) {
+    T value;
+    memcpy(&value, dump.data() + offset, sizeof(T));
+    return value;
+}
+
+}  // namespace
+
+// Runs a program with the dynarec describing its code to perf, then reads back the jitdump file, as "perf inject"
+// would: the header first, then records up to the first block of code.
+TEST(Perf, JitDump) {
+    MainInvoker invoker("-no-ui", "-run", "-bios", "src/mips/openbios/openbios.bin", "-testmode", "-dynarec",
+                        "-dynarec-perf", "-luacov", "-loadexe", "src/mips/tests/basic/basic.ps-exe");
+    EXPECT_EQ(invoker.invoke(), 0);
+
+    const auto pid = getpid();
+    const auto filename = fmt::format("/tmp/jit-{}.dump", pid);
+    std::ifstream file(filename, std::ios::binary);
+    ASSERT_TRUE(file.good());
+    const std::vector<uint8_t> dump{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    file.close();
+    unlink(filename.c_str());
+    unlink(fmt::format("/tmp/perf-{}.map", pid).c_str());
+
+    constexpr size_t c_headerSize = 40;
+    ASSERT_GE(dump.size(), c_headerSize);
+    EXPECT_EQ(readAt<uint32_t>(dump, 0), 0x4a695444);  // "JiTD"
+    EXPECT_EQ(readAt<uint32_t>(dump, 4), 1);
+    EXPECT_EQ(readAt<uint32_t>(dump, 8), c_headerSize);
+    EXPECT_EQ(readAt<uint32_t>(dump, 12), EM_X86_64);
+    EXPECT_EQ(readAt<uint32_t>(dump, 20), uint32_t(pid));
+
+    constexpr uint32_t c_codeLoad = 0;
+    constexpr size_t c_recordSize = 16;
+    constexpr size_t c_codeLoadSize = c_recordSize + 40;
+    size_t offset = c_headerSize;
+    while ((offset + c_recordSize <= dump.size()) && (readAt<uint32_t>(dump, offset) != c_codeLoad)) {
+        const auto size = readAt<uint32_t>(dump, offset + 4);
+        ASSERT_GE(size, c_recordSize);
+        offset += size;
+    }
+    ASSERT_LE(offset + c_codeLoadSize, dump.size());
+
+    const auto totalSize = readAt<uint32_t>(dump, offset + 4);
+    const auto codeAddress = readAt<uint64_t>(dump, offset + 32);
+    const auto codeSize = readAt<uint64_t>(dump, offset + 40);
+    EXPECT_EQ(readAt<uint32_t>(dump, offset + 16), uint32_t(pid));
+    EXPECT_EQ(readAt<uint64_t>(dump, offset + 24), codeAddress);
+    EXPECT_NE(codeAddress, 0);
+    EXPECT_NE(codeSize, 0);
+    ASSERT_LE(offset + totalSize, dump.size());
+
+    const char* name = reinterpret_cast<const char*>(dump.data() + offset + c_codeLoadSize);
+    const auto nameSize = strnlen(name, totalSize - c_codeLoadSize);
+    const std::string symbol(name, nameSize);
+    EXPECT_TRUE(symbol.starts_with("recompile_") || symbol.starts_with("trace_")) << symbol;
+    EXPECT_EQ(totalSize, c_codeLoadSize + nameSize + 1 + codeSize);
+}
+
+#endif
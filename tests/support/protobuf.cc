@@ -0,0 +1,277 @@
+/***************************************************************************
+ *   Copyright (C) 2022 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include "support/protobuf.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "support/typestring-wrapper.h"
+
+using namespace PCSX;
+
+namespace {
+
+// A cut down version of the save state schema from core/sstate.h.
+typedef Protobuf::Field<Protobuf::String, TYPESTRING("version_string"), 1> VersionString;
+typedef Protobuf::Field<Protobuf::UInt32, TYPESTRING("version"), 2> Version;
+typedef Protobuf::Message<TYPESTRING("SaveStateInfo"), VersionString, Version> SaveStateInfo;
+typedef Protobuf::MessageField<SaveStateInfo, TYPESTRING("save_state_info"), 1> SaveStateInfoField;
+
+typedef Protobuf::FieldPtr<Protobuf::FixedBytes<0x00200000>, TYPESTRING("ram"), 1> RAM;
+typedef Protobuf::FieldPtr<Protobuf::FixedBytes<0x00010000>, TYPESTRING("hardware"), 2> HardwareMemory;
+typedef Protobuf::Message<TYPESTRING("Memory"), RAM, HardwareMemory> Memory;
+typedef Protobuf::MessageField<Memory, TYPESTRING("memory"), 2> MemoryField;
+
+typedef Protobuf::RepeatedFieldRef<Protobuf::UInt32, 34, TYPESTRING("gpr"), 1> GPR;
+typedef Protobuf::FieldRef<Protobuf::UInt32, TYPESTRING("pc"), 2> PC;
+typedef Protobuf::FieldRef<Protobuf::SInt32, TYPESTRING("delta"), 3> Delta;
+typedef Protobuf::Message<TYPESTRING("Registers"), GPR, PC, Delta> Registers;
+typedef Protobuf::MessageField<Registers, TYPESTRING("registers"), 3> RegistersField;
+
+typedef Protobuf::Message<TYPESTRING("SaveState"), SaveStateInfoField, MemoryField, RegistersField> SaveState;
+
+struct Machine {
+    Machine() {
+        for (unsigned i = 0; i < sizeof(ram); i++) ram[i] = i * 7;
+        for (unsigned i = 0; i < sizeof(hardware); i++) hardware[i] = i ^ 0x5a;
+        for (unsigned i = 0; i < 34; i++) gpr[i] = i * 0x01010101;
+    }
+    SaveState construct() {
+        // clang-format off
+        return SaveState {
+            SaveStateInfo {
+                VersionString { "PCSX-Redux SaveState v4" },
+                Version { 4 },
+            },
+            Memory {
+                RAM { ram },
+                HardwareMemory { hardware },
+            },
+            Registers {
+                GPR { gpr },
+                PC { pc },
+                Delta { delta },
+            },
+        };
+        // clang-format on
+    }
+    uint8_t ram[0x00200000];
+    uint8_t hardware[0x00010000];
+    uint32_t gpr[34];
+    uint32_t pc = 0xbfc00000;
+    int32_t delta = -42;
+};
+
+// The encoder as it was before OutSlice learnt about preallocation: one temporary
+// string per byte, and every nested message encoded into its own slice then copied.
+class LegacySlice {
+  public:
+    void putU8(uint8_t value) { m_data += std::string(reinterpret_cast<const char *>(&value), 1); }
+    void putBytes(const uint8_t *bytes, uint64_t size) {
+        m_data += std::string(reinterpret_cast<const char *>(bytes), size);
+    }
+    void putBytes(const std::string &str) { m_data += str; }
+    void putVarInt(uint64_t value) {
+        uint8_t b = 0;
+        do {
+            b = value & 0x7f;
+            value >>= 7;
+            putU8(b | (value ? 0x80 : 0x00));
+        } while (value);
+    }
+    void putMessage(unsigned field, LegacySlice &message) {
+        std::string data = message.finalize();
+        putVarInt((field << 3) | 2);
+        putVarInt(data.size());
+        putBytes(data);
+    }
+    std::string finalize() { return std::move(m_data); }
+
+  private:
+    std::string m_data;
+};
+
+std::string legacySave(const Machine &machine) {
+    LegacySlice info;
+    info.putVarInt((1 << 3) | 2);
+    info.putVarInt(23);
+    info.putBytes("PCSX-Redux SaveState v4");
+    info.putVarInt((2 << 3) | 0);
+    info.putVarInt(4);
+
+    LegacySlice memory;
+    memory.putVarInt((1 << 3) | 2);
+    memory.putVarInt(sizeof(machine.ram));
+    memory.putBytes(machine.ram, sizeof(machine.ram));
+    memory.putVarInt((2 << 3) | 2);
+    memory.putVarInt(sizeof(machine.hardware));
+    memory.putBytes(machine.hardware, sizeof(machine.hardware));
+
+    LegacySlice gpr;
+    for (unsigned i = 0; i < 34; i++) gpr.putVarInt(machine.gpr[i]);
+    std::string gprData = gpr.finalize();
+    LegacySlice registers;
+    registers.putVarInt((1 << 3) | 2);
+    registers.putVarInt(gprData.size());
+    registers.putBytes(gprData);
+    registers.putVarInt((2 << 3) | 0);
+    registers.putVarInt(machine.pc);
+    registers.putVarInt((3 << 3) | 0);
+    registers.putVarInt((machine.delta << 1) ^ (machine.delta >> 31));
+
+    LegacySlice state;
+    state.putMessage(1, info);
+    state.putMessage(2, memory);
+    state.putMessage(3, registers);
+    return state.finalize();
+}
+
+std::string save(Machine &machine) {
+    SaveState state = machine.construct();
+    Protobuf::OutSlice slice;
+    slice.reserve(state.serializedSize());
+    state.serialize(&slice);
+    return slice.finalize();
+}
+
+}  // namespace
+
+TEST(Protobuf, VarIntSize) {
+    EXPECT_EQ(Protobuf::OutSlice::varIntSize(0), 1);
+    EXPECT_EQ(Protobuf::OutSlice::varIntSize(127), 1);
+    EXPECT_EQ(Protobuf::OutSlice::varIntSize(128), 2);
+    EXPECT_EQ(Protobuf::OutSlice::varIntSize(0x00200000), 4);
+    EXPECT_EQ(Protobuf::OutSlice::varIntSize(UINT64_MAX), 10);
+}
+
+TEST(Protobuf, SerializedSizeIsExact) {
+    auto machine = std::make_unique<Machine>();
+    SaveState state = machine->construct();
+    Protobuf::OutSlice slice;
+    state.serialize(&slice);
+    EXPECT_EQ(state.serializedSize(), slice.size());
+}
+
+TEST(Protobuf, MatchesLegacyEncoding) {
+    auto machine = std::make_unique<Machine>();
+    std::string encoded = save(*machine);
+    EXPECT_EQ(encoded, legacySave(*machine));
+
+    auto restored = std::make_unique<Machine>();
+    memset(restored->ram, 0, sizeof(restored->ram));
+    restored->pc = 0;
+    restored->delta = 0;
+    SaveState state = restored->construct();
+    Protobuf::InSlice slice(reinterpret_cast<const uint8_t *>(encoded.data()), encoded.size());
+    state.deserialize(&slice, 0);
+    state.commit();
+    EXPECT_EQ(memcmp(restored->ram, machine->ram, sizeof(machine->ram)), 0);
+    EXPECT_EQ(restored->pc, machine->pc);
+    EXPECT_EQ(restored->delta, machine->delta);
+}
+
+TEST(Protobuf, AbsentPointerFieldIsLeftAlone) {
+    auto machine = std::make_unique<Machine>();
+    // clang-format off
+    SaveState partial {
+        SaveStateInfo {
+            VersionString { "PCSX-Redux SaveState v4" },
+            Version { 4 },
+        },
+        Memory {
+            RAM { nullptr },
+            HardwareMemory { machine->hardware },
+        },
+        Registers {
+            GPR { machine->gpr },
+            PC { machine->pc },
+            Delta { machine->delta },
+        },
+    };
+    // clang-format on
+    Protobuf::OutSlice out;
+    partial.serialize(&out);
+    std::string encoded = out.finalize();
+
+    auto restored = std::make_unique<Machine>();
+    memset(restored->ram, 0xaa, sizeof(restored->ram));
+    memset(restored->hardware, 0, sizeof(restored->hardware));
+    SaveState state = restored->construct();
+    Protobuf::InSlice slice(reinterpret_cast<const uint8_t *>(encoded.data()), encoded.size());
+    state.deserialize(&slice, 0);
+    state.commit();
+    EXPECT_EQ(restored->ram[0], 0xaa);
+    EXPECT_EQ(restored->ram[sizeof(restored->ram) - 1], 0xaa);
+    EXPECT_EQ(memcmp(restored->hardware, machine->hardware, sizeof(machine->hardware)), 0);
+}
+
+TEST(Protobuf, ReferencesIntoInput) {
+    typedef Protobuf::Field<Protobuf::FixedBytes<0x1000>, TYPESTRING("vram"), 1> VRAM;
+    typedef Protobuf::Message<TYPESTRING("GPU"), VRAM> GPU;
+    GPU gpu;
+    gpu.get<VRAM>().allocate();
+    for (unsigned i = 0; i < 0x1000; i++) gpu.get<VRAM>().value[i] = i * 3;
+    Protobuf::OutSlice out;
+    gpu.serialize(&out);
+    std::string encoded = out.finalize();
+    auto begin = reinterpret_cast<const uint8_t *>(encoded.data());
+
+    GPU copied;
+    Protobuf::InSlice slice(begin, encoded.size());
+    copied.deserialize(&slice, 0);
+    EXPECT_FALSE(copied.get<VRAM>().value >= begin && copied.get<VRAM>().value < begin + encoded.size());
+
+    GPU referenced;
+    Protobuf::InSlice referencing(begin, encoded.size());
+    referencing.allowReferences();
+    referenced.deserialize(&referencing, 0);
+    auto &vram = referenced.get<VRAM>();
+    EXPECT_TRUE(vram.value >= begin && vram.value < begin + encoded.size());
+    EXPECT_EQ(memcmp(vram.value, gpu.get<VRAM>().value, 0x1000), 0);
+
+    vram.own();
+    EXPECT_FALSE(vram.value >= begin && vram.value < begin + encoded.size());
+    EXPECT_EQ(memcmp(vram.value, gpu.get<VRAM>().value, 0x1000), 0);
+}
+
+TEST(Protobuf, SaveBenchmark) {
+    constexpr unsigned iterations = 20;
+    auto machine = std::make_unique<Machine>();
+    size_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) sink += legacySave(*machine).size();
+    auto legacy = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) sink += save(*machine).size();
+    auto current = std::chrono::steady_clock::now() - start;
+
+    using us = std::chrono::microseconds;
+    printf("save state serialization: legacy %lldus, preallocated %lldus per save\n",
+           static_cast<long long>(std::chrono::duration_cast<us>(legacy).count() / iterations),
+           static_cast<long long>(std::chrono::duration_cast<us>(current).count() / iterations));
+    EXPECT_NE(sink, 0);
+}
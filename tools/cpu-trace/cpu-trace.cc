@@ -0,0 +1,208 @@
+/***************************************************************************
+ *   Copyright (C) 2025 PCSX-Redux authors                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.           *
+ ***************************************************************************/
+
+#include <stdint.h>
+
+#include <string>
+
+#include "core/disr3000a.h"
+#include "flags.h"
+#include "fmt/format.h"
+#include "support/file.h"
+#include "support/zfile.h"
+#include "supportpsx/cpu-trace.h"
+
+namespace {
+
+// The traces don't carry the machine state, so this only prints the instruction itself, the same way the
+// disassembly view does when it isn't showing values.
+class TraceDisasm : public PCSX::Disasm {
+  public:
+    std::string get(uint32_t code, uint32_t pc) {
+        m_str.clear();
+        process(code, 0, pc);
+        return m_str;
+    }
+
+  private:
+    void comma() {
+        if (m_gotArg) m_str += ", ";
+        m_gotArg = true;
+    }
+    void reg(const char *name) {
+        comma();
+        m_str += fmt::format("${}", name);
+    }
+    virtual void Invalid() final { m_str = "*** Bad OP ***"; }
+    virtual void OpCode(std::string_view name) final {
+        m_str = fmt::format("{:<7}", name);
+        m_gotArg = false;
+    }
+    virtual void GPR(uint8_t r) final { reg(s_disRNameGPR[r]); }
+    virtual void CP0(uint8_t r) final { reg(s_disRNameCP0[r]); }
+    virtual void CP2D(uint8_t r) final { reg(s_disRNameCP2D[r]); }
+    virtual void CP2C(uint8_t r) final { reg(s_disRNameCP2C[r]); }
+    virtual void HI() final { reg("hi"); }
+    virtual void LO() final { reg("lo"); }
+    virtual void Imm16(int16_t value) final {
+        comma();
+        m_str += value < 0 ? fmt::format("-0x{:04x}", -value) : fmt::format("0x{:04x}", value);
+    }
+    virtual void Imm16u(uint16_t value) final {
+        comma();
+        m_str += fmt::format("0x{:04x}", value);
+    }
+    virtual void Imm32(uint32_t value) final {
+        comma();
+        m_str += fmt::format("0x{:08x}", value);
+    }
+    virtual void Target(uint32_t value) final {
+        comma();
+        m_str += fmt::format("0x{:08x}", value);
+    }
+    virtual void Sa(uint8_t value) final {
+        comma();
+        m_str += fmt::format("0x{:02x}", value);
+    }
+    virtual void OfB(int16_t offset, uint8_t r, int size) final {
+        comma();
+        m_str += offset < 0 ? fmt::format("-0x{:04x}({})", -offset, s_disRNameGPR[r])
+                            : fmt::format("0x{:04x}({})", offset, s_disRNameGPR[r]);
+    }
+    virtual void BranchDest(uint32_t value) final {
+        comma();
+        m_str += fmt::format("0x{:08x}", value);
+    }
+    virtual void Offset(uint32_t addr, int size) final {
+        comma();
+        m_str += fmt::format("0x{:08x}", addr);
+    }
+
+    std::string m_str;
+    bool m_gotArg = false;
+};
+
+const char *registerName(uint8_t index) {
+    switch (index) {
+        case 32:
+            return "lo";
+        case 33:
+            return "hi";
+        default:
+            return PCSX::Disasm::s_disRNameGPR[index];
+    }
+}
+
+bool touches(const std::optional<PCSX::CPUTrace::Access> &access, uint32_t address) {
+    if (!access.has_value()) return false;
+    return (address >= access->address) && (address < access->address + access->size);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    CommandLine::args args(argc, argv);
+
+    fmt::print(R"(
+cpu-trace by PCSX-Redux authors
+https://github.com/grumpycoders/pcsx-redux/tree/main/tools/cpu-trace/
+)");
+
+    auto output = args.get<std::string>("o");
+    auto inputs = args.positional();
+    const bool asksForHelp = args.get<bool>("h").value_or(false);
+    const bool oneInput = inputs.size() == 1;
+    const uint64_t skip = std::stoull(args.get<std::string>("skip").value_or("0"), nullptr, 0);
+    const uint64_t count = std::stoull(args.get<std::string>("count").value_or("0"), nullptr, 0);
+    const uint32_t pcStart = std::stoul(args.get<std::string>("pc-start").value_or("0"), nullptr, 0);
+    const uint32_t pcEnd = std::stoul(args.get<std::string>("pc-end").value_or("0xffffffff"), nullptr, 0);
+    const auto address = args.get<std::string>("address");
+    const bool showRegisters = !args.get<bool>("no-regs").value_or(false);
+    if (asksForHelp || !oneInput) {
+        fmt::print(R"(
+Usage: {} input.trace [-o output.txt] [-skip n] [-count n] [-pc-start addr] [-pc-end addr] [-address addr]
+  input.trace       mandatory: a trace recorded using -cpu-trace or PCSX.CPUTrace.start.
+  -o output.txt     optional: write the decoded trace to this file instead of the console.
+  -skip n           optional: ignore the first n instructions of the trace.
+  -count n          optional: stop after printing n instructions.
+  -pc-start addr    optional: only print instructions located at or after this address.
+  -pc-end addr      optional: only print instructions located before this address.
+  -address addr     optional: only print instructions reading or writing this address.
+  -no-regs          optional: don't print the registers modified by each instruction.
+  -h                displays this help information and exit.
+)",
+                   argv[0]);
+        return -1;
+    }
+
+    auto &input = inputs[0];
+    PCSX::IO<PCSX::File> file(new PCSX::PosixFile(input));
+    if (file->failed()) {
+        fmt::print("Error opening input file {}\n", input);
+        return -1;
+    }
+    PCSX::IO<PCSX::File> decompressed(new PCSX::ZReader(file));
+    PCSX::CPUTrace::Reader reader(decompressed);
+    if (!reader.readHeader()) {
+        fmt::print("File {} isn't a valid CPU trace\n", input);
+        return -1;
+    }
+
+    FILE *out = stdout;
+    if (output.has_value()) {
+        out = fopen(output.value().c_str(), "w");
+        if (!out) {
+            fmt::print("Error opening output file {}\n", output.value());
+            return -1;
+        }
+    }
+
+    const bool filterAddress = address.has_value();
+    const uint32_t watched = filterAddress ? std::stoul(address.value(), nullptr, 0) : 0;
+
+    TraceDisasm disasm;
+    PCSX::CPUTrace::Record record;
+    uint64_t index = 0;
+    uint64_t printed = 0;
+    for (; reader.next(record); index++) {
+        if (index < skip) continue;
+        if ((record.pc < pcStart) || (record.pc >= pcEnd)) continue;
+        if (filterAddress && !touches(record.read, watched) && !touches(record.write, watched)) continue;
+        std::string line = fmt::format("{:>10} {:>12} {:08x} {:08x}: {}", index, record.cycle, record.pc, record.code,
+                                       disasm.get(record.code, record.pc));
+        if (showRegisters) {
+            for (unsigned i = 0; i < record.registerCount; i++) {
+                auto &r = record.registers[i];
+                line += fmt::format(" ${}={:08x}", registerName(r.index), r.value);
+            }
+        }
+        if (record.read.has_value()) {
+            line += fmt::format(" [{:08x}]:{}", record.read->address, record.read->size);
+        }
+        if (record.write.has_value()) {
+            line += fmt::format(" [{:08x}]:{}<-{:x}", record.write->address, record.write->size,
+                                record.write->value);
+        }
+        fmt::print(out, "{}\n", line);
+        if (count && (++printed == count)) break;
+    }
+
+    if (out != stdout) fclose(out);
+    return 0;
+}